@@ -0,0 +1,431 @@
+//
+// UDMF Converter EE
+// Copyright (C) 2019 Ioan Chera
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/
+//
+// Additional terms and conditions compatible with the GPLv3 apply. See the
+// file COPYING-EE for details.
+//
+// Purpose: Conversion benchmarks on generated maps
+// Authors: Ioan Chera
+//
+// Built by the Benchmark target of the Xcode project, from the converter
+// sources except main.cpp. Elsewhere, for example:
+//    c++ -std=c++17 -O2 Benchmark/*.cpp Confuse/*.cpp hal/*.cpp $(ls *.cpp | grep -v main.cpp) -lz -pthread
+//
+// Usage:
+//    benchmark [-levels N] [-sectors N] [-linedefs N] [-things N] [-portals N]
+//              [-extradata N] [-translucent N] [-seed N]
+//              [-generate out.wad]
+//              [-iterations N] [-json out.json] [-baseline old.json] [-tolerance pct]
+//              [-verbose]
+//
+// With -generate it only writes the synthetic wad. Otherwise it times each
+// conversion stage on the first generated level, and the full conversion on
+// all of them, all in memory. The full conversion runs the converter's own
+// ConvertLevel with its default settings. Each benchmark gets a warm-up run,
+// then the min, median and max of the timed runs are reported. Compare medians between
+// runs of the same settings: with -baseline, it exits with failure if any of
+// them got slower by more than the tolerance (default 10%).
+//
+
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <unordered_map>
+#include "../hal/i_platform.h"
+#if EE_CURRENT_PLATFORM == EE_PLATFORM_WINDOWS
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+#include "../Arguments.hpp"
+#include "../BlockmapBuilder.hpp"
+#include "../DoomLevel.hpp"
+#include "../ExtraData.hpp"
+#include "../Helpers.hpp"
+#include "../LevelConverter.hpp"
+#include "../NodeBuilder.hpp"
+#include "../RejectBuilder.hpp"
+#include "../ThingMapping.hpp"
+#include "../UDMFItems.hpp"
+#include "../Wad.hpp"
+#include "../XLEMapInfoParser.hpp"
+#include "../ZNodes.hpp"
+#include "MapGenerator.hpp"
+
+//
+// Timings of one benchmark, in milliseconds
+//
+struct BenchmarkResult
+{
+   std::string name;
+   uint64_t items;   // processed per run
+   double min, median, max;
+};
+
+// Results go here, so the work can't be optimized away
+static volatile uint64_t gSink;
+
+//
+// Runs the body once to warm up, then the given number of times timed. The
+// body returns how many items it processed.
+//
+static BenchmarkResult Bench_run(const char *name, int iterations,
+                                 const std::function<uint64_t()> &body)
+{
+   BenchmarkResult result;
+   result.name = name;
+   result.items = body();
+   gSink += result.items;
+
+   std::vector<double> times;
+   times.reserve(iterations);
+   for(int i = 0; i < iterations; ++i)
+   {
+      auto start = std::chrono::steady_clock::now();
+      gSink += body();
+      std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::steady_clock::now() - start;
+      times.push_back(elapsed.count());
+   }
+   std::sort(times.begin(), times.end());
+   result.min = times.front();
+   result.max = times.back();
+   size_t middle = times.size() / 2;
+   result.median = times.size() % 2 ? times[middle] :
+   (times[middle - 1] + times[middle]) / 2;
+   return result;
+}
+
+//
+// Gets the level's ExtraData lump name from EMAPINFO, or empty if none
+//
+static std::string Bench_extraDataName(const XLEMapInfoParser &emapinfo,
+                                       const char *levelName)
+{
+   const LevelInfo *info = emapinfo.Get(levelName);
+   if(!info)
+      return std::string();
+   auto it = info->find("extradata");
+   return it != info->end() ? it->second : std::string();
+}
+
+//
+// Converts all levels of the wad with the converter's defaults, the way it
+// does, without writing anything. Returns the byte count of the output.
+//
+static uint64_t Bench_convertAll(const Wad &wad, const ThingMapping &thingnames)
+{
+   uint64_t bytes = 0;
+   std::vector<LumpInfo> levelLumps = DoomLevel::FindLevelLumps(wad);
+   XLEMapInfoParser emapinfo;
+   emapinfo.ParseAll(wad);
+   for(const LumpInfo &info : levelLumps)
+   {
+      emapinfo.SetLocalLevel(info.lump->Name());
+      emapinfo.ParseLump(*info.lump);
+   }
+   ExtraDataCache extraDataCache(wad, thingnames);
+   ConvertOptions options;
+   for(const LumpInfo &info : levelLumps)
+   {
+      ConvertedLevel converted = ConvertLevel(wad, info, thingnames, extraDataCache,
+                                              Bench_extraDataName(emapinfo,
+                                                                  info.lump->Name()),
+                                              true, options, nullptr);
+      for(const Lump &lump : converted.lumps)
+         bytes += lump.Size();
+   }
+   return bytes;
+}
+
+//
+// Writes the results as JSON, one benchmark per line
+//
+static void Bench_printJSON(FILE *f, const std::string &config, int iterations,
+                            const std::vector<BenchmarkResult> &results)
+{
+   fprintf(f, "{\n  \"config\": \"%s\",\n  \"iterations\": %d,\n  \"benchmarks\": [",
+           Escape(config).c_str(), iterations);
+   for(size_t i = 0; i < results.size(); ++i)
+   {
+      const BenchmarkResult &result = results[i];
+      fprintf(f, "%s\n    {\"name\": \"%s\", \"items\": %llu, \"min_ms\": %.4f, "
+              "\"median_ms\": %.4f, \"max_ms\": %.4f}", i ? "," : "",
+              Escape(result.name).c_str(), (unsigned long long)result.items,
+              result.min, result.median, result.max);
+   }
+   fputs("\n  ]\n}\n", f);
+}
+
+//
+// Reads the config and medians from a file written by Bench_printJSON
+//
+static bool Bench_loadBaseline(const char *path, std::string &config,
+                               std::unordered_map<std::string, double> &medians)
+{
+   std::ifstream stream(path);
+   if(!stream)
+      return false;
+   static const char configKey[] = "\"config\": \"";
+   static const char nameKey[] = "\"name\": \"";
+   static const char medianKey[] = "\"median_ms\": ";
+   std::string line;
+   while(std::getline(stream, line))
+   {
+      size_t pos = line.find(configKey);
+      if(pos != std::string::npos)
+      {
+         pos += sizeof(configKey) - 1;
+         config = line.substr(pos, line.find('"', pos) - pos);
+         continue;
+      }
+      pos = line.find(nameKey);
+      size_t medianPos = line.find(medianKey);
+      if(pos == std::string::npos || medianPos == std::string::npos)
+         continue;
+      pos += sizeof(nameKey) - 1;
+      medians[line.substr(pos, line.find('"', pos) - pos)] =
+      atof(line.c_str() + medianPos + sizeof(medianKey) - 1);
+   }
+   return true;
+}
+
+//
+// Gets an integer argument, if present
+//
+static void Bench_intArg(const Arguments &args, const char *key, int &value)
+{
+   const char *text = args.GetSingle(key);
+   if(text)
+      value = atoi(text);
+}
+
+//
+// Entry point
+//
+int main(int argc, const char *argv[])
+{
+   Arguments args(argc, argv);
+
+   MapGeneratorOptions options;
+   Bench_intArg(args, "levels", options.levels);
+   Bench_intArg(args, "sectors", options.sectors);
+   Bench_intArg(args, "linedefs", options.linedefs);
+   Bench_intArg(args, "things", options.things);
+   Bench_intArg(args, "portals", options.portals);
+   Bench_intArg(args, "extradata", options.extraDataRecords);
+   Bench_intArg(args, "translucent", options.translucentLines);
+   const char *seedArg = args.GetSingle("seed");
+   if(seedArg)
+      options.seed = static_cast<uint32_t>(strtoul(seedArg, nullptr, 0));
+
+   std::vector<Lump> lumps;
+   GeneratedMapCounts counts = GenerateMaps(options, lumps);
+   Wad wad;
+   for(Lump &lump : lumps)
+      wad.AddLump(std::move(lump));
+   lumps.clear();
+
+   printf("Generated %d level(s), each with %d things, %d linedefs, %d sidedefs, "
+          "%d vertices, %d sectors, %d segs, %d subsectors, %d nodes\n",
+          std::min(std::max(options.levels, 1), 99), counts.things, counts.linedefs,
+          counts.sidedefs, counts.vertices, counts.sectors, counts.segs,
+          counts.subsectors, counts.nodes);
+
+   const char *generatePath = args.GetSingle("generate");
+   if(generatePath)
+   {
+      Result result = wad.WriteFile(generatePath);
+      if(result != Result::OK)
+      {
+         fprintf(stderr, "Failed writing file '%s'. %s\n", generatePath,
+                 ResultMessage(result));
+         return EXIT_FAILURE;
+      }
+      return 0;
+   }
+
+   int iterations = 10;
+   Bench_intArg(args, "iterations", iterations);
+   if(iterations < 1)
+      iterations = 1;
+
+   // The converter reports its progress on stdout and stderr. Keep the report
+   // on a copy of stdout and silence the rest, unless asked not to.
+   FILE *report = stdout;
+   if(!args.Get("verbose"))
+   {
+      fflush(stdout);
+#if EE_CURRENT_PLATFORM == EE_PLATFORM_WINDOWS
+      report = _fdopen(_dup(_fileno(stdout)), "w");
+      static const char nullPath[] = "NUL";
+#else
+      report = fdopen(dup(fileno(stdout)), "w");
+      static const char nullPath[] = "/dev/null";
+#endif
+      if(!report || !freopen(nullPath, "w", stdout) || !freopen(nullPath, "w", stderr))
+      {
+         fprintf(report ? report : stdout, "Failed silencing the converter output\n");
+         return EXIT_FAILURE;
+      }
+   }
+
+   ThingMapping thingnames;
+   std::vector<LumpInfo> levelLumps = DoomLevel::FindLevelLumps(wad);
+   if(levelLumps.empty())
+   {
+      fprintf(report, "No levels generated\n");
+      return EXIT_FAILURE;
+   }
+   const LumpInfo &first = levelLumps.front();
+   XLEMapInfoParser emapinfo;
+   emapinfo.ParseAll(wad);
+   std::string extraDataName = Bench_extraDataName(emapinfo, first.lump->Name());
+
+   // Prepared inputs for the single stage benchmarks
+   DoomLevel level;
+   level.LoadWad(wad, first.index);
+   MessageLog log;   // the converter's messages aren't of interest here
+   ExtraData extraData(thingnames);
+   if(!extraDataName.empty())
+      extraData.LoadLump(wad, extraDataName.c_str(), log);
+   UDMFLevel udmfLevel(level, extraData, log);
+
+   std::vector<BenchmarkResult> results;
+   results.push_back(Bench_run("decode_records", iterations, [&wad, &first]() {
+      DoomLevel loaded;
+      loaded.LoadWad(wad, first.index);
+      return static_cast<uint64_t>(loaded.GetLinedefs().size() +
+                                   loaded.GetSidedefs().size() +
+                                   loaded.GetSegs().size());
+   }));
+   results.push_back(Bench_run("separate_seg_vertices", iterations, [&level]() {
+      return static_cast<uint64_t>(DoomLevel::CountEditorVertices(level.GetVertices(),
+                                                                  level.GetLinedefs()));
+   }));
+   results.push_back(Bench_run("udmf_build", iterations, [&level, &extraData]() {
+      MessageLog messages;
+      UDMFLevel built(level, extraData, messages);
+      return static_cast<uint64_t>(level.GetLinedefs().size());
+   }));
+   results.push_back(Bench_run("textmap_write", iterations, [&udmfLevel]() {
+      TextmapWriter textmap;
+      textmap << udmfLevel;
+      return static_cast<uint64_t>(textmap.Release().size());
+   }));
+   results.push_back(Bench_run("write_znodes", iterations, [&level]() {
+      std::ostringstream oss;
+      WriteZNodes(level, oss);
+      return static_cast<uint64_t>(oss.str().size());
+   }));
+   results.push_back(Bench_run("write_znodes_zgl3", iterations, [&level]() {
+      std::ostringstream oss;
+      WriteZNodes(level, oss, 6);
+      return static_cast<uint64_t>(oss.str().size());
+   }));
+   results.push_back(Bench_run("build_gl_nodes", iterations, [&level]() {
+      GLNodes nodes;
+      BuildGLNodes(level, nullptr, nodes);
+      return static_cast<uint64_t>(nodes.segs.size());
+   }));
+   results.push_back(Bench_run("build_blockmap", iterations, [&level]() {
+      std::vector<int16_t> blockmap;
+      BlockmapInfo info;
+      BuildBlockmap(level, nullptr, true, blockmap, info);
+      return static_cast<uint64_t>(info.size);
+   }));
+   results.push_back(Bench_run("build_reject", iterations, [&level]() {
+      std::vector<uint8_t> reject;
+      RejectInfo info;
+      BuildReject(level, nullptr, reject, info);
+      return static_cast<uint64_t>(info.sectors);
+   }));
+   if(!extraDataName.empty())
+   {
+      results.push_back(Bench_run("extradata_parse", iterations,
+                                  [&wad, &thingnames, &extraDataName]() {
+         ExtraData parsed(thingnames);
+         MessageLog messages;
+         parsed.LoadLump(wad, extraDataName.c_str(), messages);
+         return static_cast<uint64_t>(parsed.NumRecords());
+      }));
+   }
+   results.push_back(Bench_run("full_conversion", iterations, [&wad, &thingnames]() {
+      return Bench_convertAll(wad, thingnames);
+   }));
+
+   std::string config = options.Describe();
+   fprintf(report, "%s, %d iterations\n", config.c_str(), iterations);
+   fprintf(report, "%-24s %12s %12s %12s %12s\n", "benchmark", "items", "min ms",
+           "median ms", "max ms");
+   for(const BenchmarkResult &result : results)
+   {
+      fprintf(report, "%-24s %12llu %12.3f %12.3f %12.3f\n", result.name.c_str(),
+              (unsigned long long)result.items, result.min, result.median, result.max);
+   }
+
+   const char *jsonPath = args.GetSingle("json");
+   if(jsonPath)
+   {
+      FILE *f = fopen(jsonPath, "wt");
+      if(!f)
+      {
+         fprintf(report, "Failed writing file '%s'\n", jsonPath);
+         return EXIT_FAILURE;
+      }
+      Bench_printJSON(f, config, iterations, results);
+      fclose(f);
+   }
+
+   const char *baselinePath = args.GetSingle("baseline");
+   if(!baselinePath)
+      return 0;
+   std::string baselineConfig;
+   std::unordered_map<std::string, double> baseline;
+   if(!Bench_loadBaseline(baselinePath, baselineConfig, baseline))
+   {
+      fprintf(report, "Failed reading file '%s'\n", baselinePath);
+      return EXIT_FAILURE;
+   }
+   if(baselineConfig != config)
+   {
+      fprintf(report, "Warning: baseline was made with different settings (%s)\n",
+              baselineConfig.c_str());
+   }
+   const char *toleranceArg = args.GetSingle("tolerance");
+   double tolerance = toleranceArg ? atof(toleranceArg) : 10;
+   bool regressed = false;
+   fprintf(report, "\n%-24s %12s %12s %9s\n", "benchmark", "baseline ms", "median ms",
+           "change");
+   for(const BenchmarkResult &result : results)
+   {
+      auto it = baseline.find(result.name);
+      if(it == baseline.end() || it->second <= 0)
+         continue;
+      double change = (result.median / it->second - 1) * 100;
+      bool slower = change > tolerance;
+      regressed |= slower;
+      fprintf(report, "%-24s %12.3f %12.3f %+8.1f%%%s\n", result.name.c_str(),
+              it->second, result.median, change, slower ? "  REGRESSION" : "");
+   }
+   return regressed ? EXIT_FAILURE : 0;
+}
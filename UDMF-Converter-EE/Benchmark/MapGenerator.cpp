@@ -0,0 +1,663 @@
+//
+// UDMF Converter EE
+// Copyright (C) 2019 Ioan Chera
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/
+//
+// Additional terms and conditions compatible with the GPLv3 apply. See the
+// file COPYING-EE for details.
+//
+// Purpose: Synthetic Doom-format map generator, for benchmarks
+// Authors: Ioan Chera
+//
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <sstream>
+#include "../IOHelpers.hpp"
+#include "../Lump.hpp"
+#include "../MapItems.h"
+#include "MapGenerator.hpp"
+
+enum
+{
+   MaxCount = 32767,    // indices are read as signed shorts
+   CellSize = 128,
+   MaxSplits = 64,      // linedefs per grid edge, at most
+   PortalTagBase = 1000,
+
+   // Line specials used
+   SpecialPortalPlaneCeiling = 283,
+   SpecialTranslucent = 260,
+   SpecialExtraDataLinedef = 270,
+};
+
+//
+// Small deterministic generator, so maps are the same on every platform
+//
+class MapRandom
+{
+public:
+   explicit MapRandom(uint32_t seed) : mState(seed ? seed : 1)
+   {
+   }
+   uint32_t Next()
+   {
+      mState ^= mState << 13;
+      mState ^= mState >> 17;
+      mState ^= mState << 5;
+      return mState;
+   }
+   int Below(int limit)
+   {
+      return static_cast<int>(Next() % static_cast<uint32_t>(limit));
+   }
+private:
+   uint32_t mState;
+};
+
+std::string MapGeneratorOptions::Describe() const
+{
+   std::ostringstream oss;
+   oss << "levels=" << levels << " sectors=" << sectors << " linedefs=" << linedefs
+   << " things=" << things << " portals=" << portals << " extradata=" << extraDataRecords
+   << " translucent=" << translucentLines << " seed=" << seed;
+   return oss.str();
+}
+
+//
+// Builds one level: a width x height grid of square sectors, with each grid
+// edge made of "splits" collinear linedefs. The nodes follow the grid, so they
+// are valid without running a node builder.
+//
+class MapBuilder
+{
+public:
+   MapBuilder(const MapGeneratorOptions &options, int width, int height, int splits);
+
+   void Build(uint32_t seed);
+   void AddLumps(const char *name, std::vector<Lump> &lumps) const;
+   std::string ExtraDataText() const;
+   GeneratedMapCounts Counts() const;
+
+private:
+   // A grid edge, oriented along +x or +y
+   struct Edge
+   {
+      int firstLine;
+      int startCorner, endCorner;
+      int firstSplitVertex;
+      bool reversed;    // linedefs point along -x or -y
+   };
+
+   int Cell(int x, int y) const
+   {
+      return x >= 0 && x < mWidth && y >= 0 && y < mHeight ? y * mWidth + x : -1;
+   }
+   int Corner(int x, int y) const
+   {
+      return y * (mWidth + 1) + x;
+   }
+   int HorizontalEdge(int x, int y) const
+   {
+      return y * mWidth + x;
+   }
+   int VerticalEdge(int x, int y) const
+   {
+      return (mHeight + 1) * mWidth + y * (mWidth + 1) + x;
+   }
+   int EdgeVertex(const Edge &edge, int i) const
+   {
+      if(!i)
+         return edge.startCorner;
+      if(i == mSplits)
+         return edge.endCorner;
+      return edge.firstSplitVertex + i - 1;
+   }
+
+   void AddEdge(int startCorner, int endCorner, int frontCell, int backCell,
+                bool reversed);
+   void AddSegs(const Edge &edge, bool forward);
+   int BuildNodes(int x0, int y0, int x1, int y1);
+   void AssignSpecials(MapRandom &random);
+   void AddThings();
+   std::string BuildBlockmap() const;
+
+   const MapGeneratorOptions &mOptions;
+   const int mWidth, mHeight, mSplits;
+   int mOriginX, mOriginY;
+
+   struct Line
+   {
+      int v1, v2, flags, special, tag, side[2];
+   };
+   struct Side
+   {
+      const char *upper, *lower, *mid;
+      int sector;
+   };
+   struct SectorInfo
+   {
+      int ceilingheight, lightlevel, tag;
+   };
+   struct NodeInfo
+   {
+      int partx, party, dx, dy;
+      int rightbox[4], leftbox[4];
+      int rightchild, leftchild;
+   };
+   struct SegInfo
+   {
+      int v1, v2, angle, linedef, dir;
+   };
+
+   std::vector<Vertex> mVertices;
+   std::vector<Edge> mEdges;
+   std::vector<Line> mLines;
+   std::vector<Side> mSides;
+   std::vector<SectorInfo> mSectors;
+   std::vector<Thing> mThings;
+   std::vector<SegInfo> mSegs;
+   std::vector<Subsector> mSubsectors;
+   std::vector<NodeInfo> mNodes;
+   int mExtraDataRecords = 0;
+};
+
+MapBuilder::MapBuilder(const MapGeneratorOptions &options, int width, int height,
+                       int splits) :
+mOptions(options), mWidth(width), mHeight(height), mSplits(splits)
+{
+   mOriginX = -width * CellSize / 2;
+   mOriginY = -height * CellSize / 2;
+}
+
+//
+// Adds the linedefs of one grid edge. Front cell is on the right of the
+// linedefs, which point from start to end unless reversed.
+//
+void MapBuilder::AddEdge(int startCorner, int endCorner, int frontCell, int backCell,
+                         bool reversed)
+{
+   Edge edge;
+   edge.firstLine = static_cast<int>(mLines.size());
+   edge.startCorner = startCorner;
+   edge.endCorner = endCorner;
+   edge.firstSplitVertex = static_cast<int>(mVertices.size());
+   edge.reversed = reversed;
+
+   const Vertex start = mVertices[startCorner];
+   const Vertex end = mVertices[endCorner];
+   for(int i = 1; i < mSplits; ++i)
+   {
+      Vertex vertex;
+      vertex.x = start.x + (end.x - start.x) * i / mSplits;
+      vertex.y = start.y + (end.y - start.y) * i / mSplits;
+      mVertices.push_back(vertex);
+   }
+
+   for(int i = 0; i < mSplits; ++i)
+   {
+      Line line = {};
+      int a = EdgeVertex(edge, i), b = EdgeVertex(edge, i + 1);
+      line.v1 = reversed ? b : a;
+      line.v2 = reversed ? a : b;
+      line.side[0] = static_cast<int>(mSides.size());
+      if(backCell >= 0)
+      {
+         line.flags = LF_TWOSIDED;
+         line.side[1] = line.side[0] + 1;
+         mSides.push_back({ "-", "-", "-", frontCell });
+         mSides.push_back({ "-", "-", "-", backCell });
+      }
+      else
+      {
+         line.flags = LF_BLOCKING;
+         line.side[1] = -1;
+         mSides.push_back({ "-", "-", "STARTAN3", frontCell });
+      }
+      mLines.push_back(line);
+   }
+   mEdges.push_back(edge);
+}
+
+//
+// Adds the segs of a cell side, walking the edge forward (along +x or +y) or
+// backward. The cell is on the right of the walk.
+//
+void MapBuilder::AddSegs(const Edge &edge, bool forward)
+{
+   const Vertex &start = mVertices[edge.startCorner];
+   const Vertex &end = mVertices[edge.endCorner];
+   int angle;
+   if(start.y == end.y)
+      angle = forward ? 0 : 0x8000;
+   else
+      angle = forward ? 0x4000 : 0xc000;
+
+   for(int n = 0; n < mSplits; ++n)
+   {
+      int i = forward ? n : mSplits - 1 - n;
+      SegInfo seg;
+      seg.v1 = EdgeVertex(edge, forward ? i : i + 1);
+      seg.v2 = EdgeVertex(edge, forward ? i + 1 : i);
+      seg.angle = angle;
+      seg.linedef = edge.firstLine + i;
+      seg.dir = forward == edge.reversed ? 1 : 0;
+      mSegs.push_back(seg);
+   }
+}
+
+//
+// Splits the cells in [x0, x1) x [y0, y1) in halves until single cells remain.
+// Returns the child number to store in the parent node.
+//
+int MapBuilder::BuildNodes(int x0, int y0, int x1, int y1)
+{
+   if(x1 - x0 == 1 && y1 - y0 == 1)
+   {
+      // Clockwise around the cell: west side up, north side east, east side
+      // down, south side west
+      Subsector subsector;
+      subsector.startseg = static_cast<int>(mSegs.size());
+      AddSegs(mEdges[VerticalEdge(x0, y0)], true);
+      AddSegs(mEdges[HorizontalEdge(x0, y1)], true);
+      AddSegs(mEdges[VerticalEdge(x1, y0)], false);
+      AddSegs(mEdges[HorizontalEdge(x0, y0)], false);
+      subsector.segcount = static_cast<int>(mSegs.size()) - subsector.startseg;
+      mSubsectors.push_back(subsector);
+      return static_cast<int>(mSubsectors.size() - 1) | 0x8000;
+   }
+
+   NodeInfo node;
+   int left = mOriginX + x0 * CellSize, right = mOriginX + x1 * CellSize;
+   int bottom = mOriginY + y0 * CellSize, top = mOriginY + y1 * CellSize;
+   if(x1 - x0 >= y1 - y0)
+   {
+      // Vertical partition pointing north: its right side is east
+      int mid = (x0 + x1) / 2;
+      int midX = mOriginX + mid * CellSize;
+      node.partx = midX;
+      node.party = bottom;
+      node.dx = 0;
+      node.dy = top - bottom;
+      node.rightchild = BuildNodes(mid, y0, x1, y1);
+      node.leftchild = BuildNodes(x0, y0, mid, y1);
+      const int rightbox[4] = { top, bottom, midX, right };
+      const int leftbox[4] = { top, bottom, left, midX };
+      std::copy(rightbox, rightbox + 4, node.rightbox);
+      std::copy(leftbox, leftbox + 4, node.leftbox);
+   }
+   else
+   {
+      // Horizontal partition pointing east: its right side is south
+      int mid = (y0 + y1) / 2;
+      int midY = mOriginY + mid * CellSize;
+      node.partx = left;
+      node.party = midY;
+      node.dx = right - left;
+      node.dy = 0;
+      node.rightchild = BuildNodes(x0, y0, x1, mid);
+      node.leftchild = BuildNodes(x0, mid, x1, y1);
+      const int rightbox[4] = { midY, bottom, left, right };
+      const int leftbox[4] = { top, midY, left, right };
+      std::copy(rightbox, rightbox + 4, node.rightbox);
+      std::copy(leftbox, leftbox + 4, node.leftbox);
+   }
+   mNodes.push_back(node);
+   return static_cast<int>(mNodes.size() - 1);
+}
+
+//
+// Gives portal, ExtraData and translucency specials to randomly picked lines
+//
+void MapBuilder::AssignSpecials(MapRandom &random)
+{
+   std::vector<int> order(mLines.size());
+   for(size_t i = 0; i < order.size(); ++i)
+      order[i] = static_cast<int>(i);
+   for(size_t i = order.size(); i > 1; --i)
+      std::swap(order[i - 1], order[random.Below(static_cast<int>(i))]);
+
+   size_t next = 0;
+   int portals = std::min(mOptions.portals, static_cast<int>(mSectors.size()));
+   for(int i = 0; i < portals && next < order.size(); ++i)
+   {
+      Line &line = mLines[order[next++]];
+      line.special = SpecialPortalPlaneCeiling;
+      line.tag = PortalTagBase + i;
+      size_t sector = static_cast<size_t>(i) * mSectors.size() / portals;
+      mSectors[sector].tag = line.tag;
+   }
+   mExtraDataRecords = 0;
+   for(int i = 0; i < mOptions.extraDataRecords && next < order.size(); ++i)
+   {
+      Line &line = mLines[order[next++]];
+      line.special = SpecialExtraDataLinedef;
+      line.tag = ++mExtraDataRecords;
+   }
+   for(int i = 0; i < mOptions.translucentLines && next < order.size(); ++i)
+   {
+      Line &line = mLines[order[next++]];
+      line.special = SpecialTranslucent;
+      mSides[line.side[0]].mid = "TRANMAP";
+   }
+}
+
+//
+// Spreads the things over the cells, several to a cell if needed
+//
+void MapBuilder::AddThings()
+{
+   static const int types[] = { 3004, 9, 3001, 2011, 2048, 2035, 3002, 2014 };
+   const int cells = mWidth * mHeight;
+   int count = std::min(std::max(mOptions.things, 1), static_cast<int>(MaxCount));
+   for(int i = 0; i < count; ++i)
+   {
+      int cell = i % cells, slot = i / cells;
+      Thing thing;
+      thing.x = mOriginX + cell % mWidth * CellSize + 16 + slot % 4 * 32;
+      thing.y = mOriginY + cell / mWidth * CellSize + 16 + slot / 4 % 4 * 32;
+      thing.angle = i * 45 % 360;
+      thing.type = i ? types[i % (sizeof(types) / sizeof(*types))] : 1;
+      thing.flags = 7;
+      mThings.push_back(thing);
+   }
+}
+
+void MapBuilder::Build(uint32_t seed)
+{
+   MapRandom random(seed);
+
+   for(int y = 0; y <= mHeight; ++y)
+      for(int x = 0; x <= mWidth; ++x)
+         mVertices.push_back({ mOriginX + x * CellSize, mOriginY + y * CellSize });
+
+   // Lines along +x have the southern cell in front, lines along +y the
+   // eastern one. Boundary lines get reversed to keep their only cell in front.
+   for(int y = 0; y <= mHeight; ++y)
+      for(int x = 0; x < mWidth; ++x)
+      {
+         int south = Cell(x, y - 1), north = Cell(x, y);
+         AddEdge(Corner(x, y), Corner(x + 1, y), south >= 0 ? south : north,
+                 south >= 0 ? north : -1, south < 0);
+      }
+   for(int y = 0; y < mHeight; ++y)
+      for(int x = 0; x <= mWidth; ++x)
+      {
+         int east = Cell(x, y), west = Cell(x - 1, y);
+         AddEdge(Corner(x, y), Corner(x, y + 1), east >= 0 ? east : west,
+                 east >= 0 ? west : -1, east < 0);
+      }
+
+   for(int i = 0; i < mWidth * mHeight; ++i)
+      mSectors.push_back({ 128 + 16 * random.Below(4), 128 + 16 * random.Below(8), 0 });
+
+   BuildNodes(0, 0, mWidth, mHeight);
+   AssignSpecials(random);
+   AddThings();
+}
+
+//
+// Writes a lump name field, padded to 8 bytes
+//
+static void WriteName(const char *name, std::ostream &os)
+{
+   char field[8] = {};
+   memcpy(field, name, strnlen(name, sizeof(field)));
+   os.write(field, sizeof(field));
+}
+
+//
+// Builds a blockmap by line bounding boxes, which is exact for the axis
+// aligned lines here. Returns an empty one if it gets past the 16-bit offsets.
+//
+std::string MapBuilder::BuildBlockmap() const
+{
+   int left = mOriginX, bottom = mOriginY;
+   int columns = mWidth * CellSize / 128 + 1;
+   int rows = mHeight * CellSize / 128 + 1;
+   std::vector<std::vector<int>> blocks(static_cast<size_t>(columns * rows));
+   for(size_t i = 0; i < mLines.size(); ++i)
+   {
+      const Vertex &v1 = mVertices[mLines[i].v1];
+      const Vertex &v2 = mVertices[mLines[i].v2];
+      int bx1 = (std::min(v1.x, v2.x) - left) >> 7;
+      int bx2 = (std::max(v1.x, v2.x) - left) >> 7;
+      int by1 = (std::min(v1.y, v2.y) - bottom) >> 7;
+      int by2 = (std::max(v1.y, v2.y) - bottom) >> 7;
+      for(int by = by1; by <= by2; ++by)
+         for(int bx = bx1; bx <= bx2; ++bx)
+            blocks[by * columns + bx].push_back(static_cast<int>(i));
+   }
+
+   size_t size = 4 + blocks.size();
+   for(const std::vector<int> &block : blocks)
+      size += block.size() + 2;
+   if(size > 0xffff)
+      return std::string();
+
+   std::ostringstream oss;
+   WriteShort(left, oss);
+   WriteShort(bottom, oss);
+   WriteShort(columns, oss);
+   WriteShort(rows, oss);
+   size_t offset = 4 + blocks.size();
+   for(const std::vector<int> &block : blocks)
+   {
+      WriteShort(static_cast<intptr_t>(offset), oss);
+      offset += block.size() + 2;
+   }
+   for(const std::vector<int> &block : blocks)
+   {
+      WriteShort(0, oss);
+      for(int line : block)
+         WriteShort(line, oss);
+      WriteShort(-1, oss);
+   }
+   return oss.str();
+}
+
+void MapBuilder::AddLumps(const char *name, std::vector<Lump> &lumps) const
+{
+   lumps.emplace_back(name);
+
+   std::ostringstream oss;
+   for(const Thing &thing : mThings)
+   {
+      WriteShort(thing.x, oss);
+      WriteShort(thing.y, oss);
+      WriteShort(thing.angle, oss);
+      WriteShort(thing.type, oss);
+      WriteShort(thing.flags, oss);
+   }
+   lumps.emplace_back("THINGS", oss.str());
+
+   oss.str("");
+   for(const Line &line : mLines)
+   {
+      WriteShort(line.v1, oss);
+      WriteShort(line.v2, oss);
+      WriteShort(line.flags, oss);
+      WriteShort(line.special, oss);
+      WriteShort(line.tag, oss);
+      WriteShort(line.side[0], oss);
+      WriteShort(line.side[1], oss);
+   }
+   lumps.emplace_back("LINEDEFS", oss.str());
+
+   oss.str("");
+   for(const Side &side : mSides)
+   {
+      WriteShort(0, oss);
+      WriteShort(0, oss);
+      WriteName(side.upper, oss);
+      WriteName(side.lower, oss);
+      WriteName(side.mid, oss);
+      WriteShort(side.sector, oss);
+   }
+   lumps.emplace_back("SIDEDEFS", oss.str());
+
+   oss.str("");
+   for(const Vertex &vertex : mVertices)
+   {
+      WriteShort(vertex.x, oss);
+      WriteShort(vertex.y, oss);
+   }
+   lumps.emplace_back("VERTEXES", oss.str());
+
+   oss.str("");
+   for(const SegInfo &seg : mSegs)
+   {
+      WriteShort(seg.v1, oss);
+      WriteShort(seg.v2, oss);
+      WriteShort(seg.angle, oss);
+      WriteShort(seg.linedef, oss);
+      WriteShort(seg.dir, oss);
+      WriteShort(0, oss);  // segs cover whole linedefs
+   }
+   lumps.emplace_back("SEGS", oss.str());
+
+   oss.str("");
+   for(const Subsector &subsector : mSubsectors)
+   {
+      WriteShort(subsector.segcount, oss);
+      WriteShort(subsector.startseg, oss);
+   }
+   lumps.emplace_back("SSECTORS", oss.str());
+
+   oss.str("");
+   for(const NodeInfo &node : mNodes)
+   {
+      WriteShort(node.partx, oss);
+      WriteShort(node.party, oss);
+      WriteShort(node.dx, oss);
+      WriteShort(node.dy, oss);
+      for(int value : node.rightbox)
+         WriteShort(value, oss);
+      for(int value : node.leftbox)
+         WriteShort(value, oss);
+      WriteShort(node.rightchild, oss);
+      WriteShort(node.leftchild, oss);
+   }
+   lumps.emplace_back("NODES", oss.str());
+
+   oss.str("");
+   for(const SectorInfo &sector : mSectors)
+   {
+      WriteShort(0, oss);
+      WriteShort(sector.ceilingheight, oss);
+      WriteName("FLOOR4_8", oss);
+      WriteName("CEIL3_5", oss);
+      WriteShort(sector.lightlevel, oss);
+      WriteShort(0, oss);
+      WriteShort(sector.tag, oss);
+   }
+   lumps.emplace_back("SECTORS", oss.str());
+
+   lumps.emplace_back("REJECT");    // empty: no sight shortcuts
+   lumps.emplace_back("BLOCKMAP", BuildBlockmap());
+}
+
+//
+// ExtraData for the lines given the ExtraData special
+//
+std::string MapBuilder::ExtraDataText() const
+{
+   std::ostringstream oss;
+   for(int i = 1; i <= mExtraDataRecords; ++i)
+   {
+      oss << "linedef\n{\n   recordnum = " << i << "\n   special = Door_Raise\n"
+      "   args = { 0, 16, 150 }\n   tag = " << i << "\n"
+      "   extflags = \"PLAYER|USE|REPEAT\"\n}\n";
+   }
+   return oss.str();
+}
+
+GeneratedMapCounts MapBuilder::Counts() const
+{
+   GeneratedMapCounts counts;
+   counts.things = static_cast<int>(mThings.size());
+   counts.linedefs = static_cast<int>(mLines.size());
+   counts.sidedefs = static_cast<int>(mSides.size());
+   counts.vertices = static_cast<int>(mVertices.size());
+   counts.sectors = static_cast<int>(mSectors.size());
+   counts.segs = static_cast<int>(mSegs.size());
+   counts.subsectors = static_cast<int>(mSubsectors.size());
+   counts.nodes = static_cast<int>(mNodes.size());
+   return counts;
+}
+
+//
+// Picks the largest grid within the limits for the requested counts
+//
+static void MapGen_chooseGrid(const MapGeneratorOptions &options, int &width,
+                              int &height, int &splits)
+{
+   int sectors = std::min(std::max(options.sectors, 1), static_cast<int>(MaxCount));
+   for(;;)
+   {
+      width = std::max(static_cast<int>(sqrt(static_cast<double>(sectors))), 1);
+      height = std::max(sectors / width, 1);
+      int gridLines = width * (height + 1) + (width + 1) * height;
+      int boundary = 2 * (width + height);
+      splits = std::min(std::max(options.linedefs / gridLines, 1),
+                        static_cast<int>(MaxSplits));
+      for(; splits >= 1; --splits)
+      {
+         int lines = gridLines * splits;
+         int vertices = (width + 1) * (height + 1) + gridLines * (splits - 1);
+         int sides = (2 * gridLines - boundary) * splits;
+         if(lines <= MaxCount && vertices <= MaxCount && sides <= MaxCount)
+            return;
+      }
+      sectors = sectors * 15 / 16;
+   }
+}
+
+//
+// Generates the levels, MAP01 onwards, with their EMAPINFO and ExtraData
+//
+GeneratedMapCounts GenerateMaps(const MapGeneratorOptions &options,
+                                std::vector<Lump> &lumps)
+{
+   int width, height, splits;
+   MapGen_chooseGrid(options, width, height, splits);
+   int levels = std::min(std::max(options.levels, 1), 99);
+
+   std::vector<MapBuilder> builders;
+   builders.reserve(levels);
+   std::string emapinfo;
+   for(int i = 0; i < levels; ++i)
+   {
+      builders.emplace_back(options, width, height, splits);
+      builders.back().Build(options.seed + i);
+      if(options.extraDataRecords > 0)
+      {
+         char name[LumpNameLength + 1];
+         snprintf(name, sizeof(name), "EDMAP%02d", i + 1);
+         lumps.emplace_back(name, builders.back().ExtraDataText());
+         emapinfo += std::string("[MAP") + (name + 5) + "]\nextradata = " + name + "\n";
+      }
+   }
+   if(!emapinfo.empty())
+      lumps.emplace_back("EMAPINFO", emapinfo);
+   for(int i = 0; i < levels; ++i)
+   {
+      char name[LumpNameLength + 1];
+      snprintf(name, sizeof(name), "MAP%02d", i + 1);
+      builders[i].AddLumps(name, lumps);
+   }
+   return builders.back().Counts();
+}
@@ -0,0 +1,72 @@
+//
+// UDMF Converter EE
+// Copyright (C) 2019 Ioan Chera
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/
+//
+// Additional terms and conditions compatible with the GPLv3 apply. See the
+// file COPYING-EE for details.
+//
+// Purpose: Synthetic Doom-format map generator, for benchmarks
+// Authors: Ioan Chera
+//
+
+#ifndef MapGenerator_hpp
+#define MapGenerator_hpp
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+class Lump;
+
+//
+// What to generate. Counts are targets: the maps are grids of square
+// sectors, so sectors and linedefs get rounded to what a grid allows, and
+// sidedefs follow from the linedefs. Everything is clamped to the limits of
+// the signed 16-bit Doom format.
+//
+struct MapGeneratorOptions
+{
+   int levels = 1;
+   int sectors = 1024;
+   int linedefs = 0;          // beyond the grid lines, by splitting them
+   int things = 1024;
+   int portals = 0;           // ceiling plane portals
+   int extraDataRecords = 0;  // ExtraData linedef records
+   int translucentLines = 0;
+   uint32_t seed = 1;
+
+   std::string Describe() const;
+};
+
+//
+// Counts of what got generated in one level
+//
+struct GeneratedMapCounts
+{
+   int things;
+   int linedefs;
+   int sidedefs;
+   int vertices;
+   int sectors;
+   int segs;
+   int subsectors;
+   int nodes;
+};
+
+GeneratedMapCounts GenerateMaps(const MapGeneratorOptions &options,
+                                std::vector<Lump> &lumps);
+
+#endif /* MapGenerator_hpp */
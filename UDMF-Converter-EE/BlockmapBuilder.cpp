@@ -0,0 +1,232 @@
+//
+// UDMF Converter EE
+// Copyright (C) 2019 Ioan Chera
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/
+//
+// Additional terms and conditions compatible with the GPLv3 apply. See the
+// file COPYING-EE for details.
+//
+// Purpose: Blockmap builder
+// Authors: Ioan Chera
+//
+
+#include <math.h>
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+#include "BlockmapBuilder.hpp"
+#include "DoomLevel.hpp"
+#include "ThreadPool.hpp"
+
+enum
+{
+   BlockShift = 7,            // 128 map units
+   BlockSize = 1 << BlockShift,
+   OriginMargin = 8,          // space left below and left of the map
+   LinesPerTask = 4096,       // fewest lines worth handing to another thread
+   MaxOffset = 0xffff,        // offsets are read as unsigned 16-bit
+   MaxLine = 0xfffe,          // 0xffff ends the lists
+};
+
+//
+// Line found in a block
+//
+struct BlockEntry
+{
+   int block;
+   int line;
+};
+
+//
+// Adds the blocks crossed by each of a range of lines. Entries come in line
+// order.
+//
+static void Blockmap_rasterize(const DoomLevel &level, size_t first, size_t last,
+                               int originX, int originY, int columns, int rows,
+                               std::vector<BlockEntry> &entries)
+{
+   const std::vector<Linedef> &linedefs = level.GetLinedefs();
+   for(size_t i = first; i < last; ++i)
+   {
+      const Linedef &linedef = linedefs[i];
+      const Vertex *v1 = level.GetVertex(linedef.v1);
+      const Vertex *v2 = level.GetVertex(linedef.v2);
+      if(!v1 || !v2)
+         continue;
+      int line = static_cast<int>(i);
+      double x1 = v1->x - originX, y1 = v1->y - originY;
+      double x2 = v2->x - originX, y2 = v2->y - originY;
+      if(x1 > x2)
+      {
+         std::swap(x1, x2);
+         std::swap(y1, y2);
+      }
+      int firstColumn = static_cast<int>(x1) >> BlockShift;
+      int lastColumn = static_cast<int>(x2) >> BlockShift;
+      for(int column = firstColumn; column <= lastColumn; ++column)
+      {
+         // Part of the line within the column, as a row range
+         double left = std::max(x1, static_cast<double>(column << BlockShift));
+         double right = std::min(x2, static_cast<double>((column + 1) << BlockShift));
+         double ya = y1, yb = y2;
+         if(x2 > x1)
+         {
+            double slope = (y2 - y1) / (x2 - x1);
+            ya = y1 + slope * (left - x1);
+            yb = y1 + slope * (right - x1);
+         }
+         int firstRow = static_cast<int>(floor(std::min(ya, yb))) >> BlockShift;
+         int lastRow = static_cast<int>(floor(std::max(ya, yb))) >> BlockShift;
+         firstRow = std::max(firstRow, 0);
+         lastRow = std::min(lastRow, rows - 1);
+         if(column < 0 || column >= columns)
+            continue;
+         for(int row = firstRow; row <= lastRow; ++row)
+            entries.push_back({ row * columns + column, line });
+      }
+   }
+}
+
+//
+// Hashes a block list, to find identical ones
+//
+static uint64_t Blockmap_hashList(const int *lines, size_t count)
+{
+   uint64_t hash = 14695981039346656037ULL;
+   for(size_t i = 0; i < count; ++i)
+   {
+      hash ^= static_cast<uint32_t>(lines[i]);
+      hash *= 1099511628211ULL;
+   }
+   return hash ^ count;
+}
+
+//
+// Builds the blockmap from the linedefs. Lines get rasterized in ranges, on the
+// pool if given, then gathered per block. With compression, blocks with the
+// same lines share one list. Fails if the map has no vertices, or if the
+// result doesn't fit in the format; ports build their own if the lump is
+// empty.
+//
+bool BuildBlockmap(const DoomLevel &level, ThreadPool *pool, bool compress,
+                   std::vector<int16_t> &blockmap, BlockmapInfo &info)
+{
+   info = BlockmapInfo();
+   blockmap.clear();
+   if(level.GetVertices().empty())
+      return false;
+   const size_t numLines = level.GetLinedefs().size();
+   if(numLines > MaxLine + 1)
+      return false;
+
+   int left, bottom, right, top;
+   level.GetBounds(left, bottom, right, top);
+   const int originX = std::max(left - OriginMargin, static_cast<int>(INT16_MIN));
+   const int originY = std::max(bottom - OriginMargin, static_cast<int>(INT16_MIN));
+   info.columns = ((right - originX) >> BlockShift) + 1;
+   info.rows = ((top - originY) >> BlockShift) + 1;
+   const int columns = info.columns, rows = info.rows;
+   const size_t numBlocks = static_cast<size_t>(columns) * rows;
+
+   size_t numRanges = 1;
+   if(pool)
+   {
+      numRanges = std::min(static_cast<size_t>(pool->NumThreads()),
+                           numLines / LinesPerTask + 1);
+   }
+   std::vector<std::vector<BlockEntry>> ranges(numRanges);
+   std::vector<std::shared_ptr<PoolTask>> tasks;
+   for(size_t i = 0; i < numRanges; ++i)
+   {
+      size_t first = numLines * i / numRanges, last = numLines * (i + 1) / numRanges;
+      std::vector<BlockEntry> &entries = ranges[i];
+      auto work = [&level, first, last, originX, originY, columns, rows, &entries]() {
+         Blockmap_rasterize(level, first, last, originX, originY, columns, rows, entries);
+      };
+      if(i + 1 < numRanges)
+         tasks.push_back(PoolTask::Start(*pool, work));
+      else
+         work();
+   }
+   for(const std::shared_ptr<PoolTask> &task : tasks)
+      task->Join();
+
+   // Gather the lines per block. The ranges come in line order, so the lists
+   // do too.
+   std::vector<size_t> starts(numBlocks + 1);
+   for(const std::vector<BlockEntry> &entries : ranges)
+      for(const BlockEntry &entry : entries)
+         ++starts[entry.block + 1];
+   for(size_t i = 0; i < numBlocks; ++i)
+      starts[i + 1] += starts[i];
+   std::vector<int> lines(starts[numBlocks]);
+   {
+      std::vector<size_t> cursors(starts.begin(), starts.end() - 1);
+      for(const std::vector<BlockEntry> &entries : ranges)
+         for(const BlockEntry &entry : entries)
+            lines[cursors[entry.block]++] = entry.line;
+   }
+   ranges.clear();
+
+   // Lay out the lists after the header and offsets. Each starts with the 0
+   // which ports skip and ends with -1.
+   blockmap.reserve(4 + numBlocks * 3 + lines.size());
+   blockmap.resize(4 + numBlocks);
+   blockmap[0] = static_cast<int16_t>(originX);
+   blockmap[1] = static_cast<int16_t>(originY);
+   blockmap[2] = static_cast<int16_t>(columns);
+   blockmap[3] = static_cast<int16_t>(rows);
+   std::unordered_multimap<uint64_t, size_t> written;   // hash to block
+   for(size_t block = 0; block < numBlocks; ++block)
+   {
+      const int *list = lines.data() + starts[block];
+      size_t count = starts[block + 1] - starts[block];
+      if(count)
+         ++info.usedBlocks;
+      size_t offset = blockmap.size();
+      if(compress)
+      {
+         uint64_t hash = Blockmap_hashList(list, count);
+         auto range = written.equal_range(hash);
+         bool shared = false;
+         for(auto it = range.first; it != range.second && !shared; ++it)
+         {
+            size_t other = it->second;
+            if(starts[other + 1] - starts[other] == count &&
+               std::equal(list, list + count, lines.data() + starts[other]))
+            {
+               blockmap[4 + block] = blockmap[4 + other];
+               shared = true;
+            }
+         }
+         if(shared)
+            continue;
+         written.emplace(hash, block);
+      }
+      if(offset > MaxOffset)
+      {
+         blockmap.clear();
+         return false;
+      }
+      blockmap[4 + block] = static_cast<int16_t>(offset);
+      blockmap.push_back(0);
+      for(size_t i = 0; i < count; ++i)
+         blockmap.push_back(static_cast<int16_t>(list[i]));
+      blockmap.push_back(-1);
+      ++info.lists;
+   }
+   info.size = blockmap.size() * sizeof(int16_t);
+   return true;
+}
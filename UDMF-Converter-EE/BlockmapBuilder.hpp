@@ -0,0 +1,50 @@
+//
+// UDMF Converter EE
+// Copyright (C) 2019 Ioan Chera
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/
+//
+// Additional terms and conditions compatible with the GPLv3 apply. See the
+// file COPYING-EE for details.
+//
+// Purpose: Blockmap builder
+// Authors: Ioan Chera
+//
+
+#ifndef BlockmapBuilder_hpp
+#define BlockmapBuilder_hpp
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+class DoomLevel;
+class ThreadPool;
+
+//
+// What got built
+//
+struct BlockmapInfo
+{
+   int columns = 0;
+   int rows = 0;
+   size_t usedBlocks = 0;  // blocks with any lines
+   size_t lists = 0;       // block lists stored, fewer than blocks if shared
+   size_t size = 0;        // bytes
+};
+
+bool BuildBlockmap(const DoomLevel &level, ThreadPool *pool, bool compress,
+                   std::vector<int16_t> &blockmap, BlockmapInfo &info);
+
+#endif /* BlockmapBuilder_hpp */
@@ -19,12 +19,15 @@
  */
 
 #include <limits.h>
+#include <ctype.h>
 #include <errno.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/types.h>
+#include <unordered_map>
+#include <vector>
 #include "../Wad.hpp"
 #include "d_dwfile.h"
 
@@ -107,6 +110,164 @@ static char *cfg_strndup(const char *s, size_t n)
    return r;
 }
 
+//=============================================================================
+//
+// Tree Storage
+//
+
+//
+// Case-insensitive hash index of an option table. Since sections duplicate
+// the table of their option, one index serves all the sections of a kind.
+//
+struct cfg_optindex_t
+{
+   std::vector<int> slots; // option positions plus 1, 0 if empty
+   unsigned int mask;      // slots.size() - 1
+   int numopts;            // options in the table
+};
+
+//
+// Memory arena for the values of a cfg_t tree. Values are carved out of large
+// blocks instead of being allocated one by one, and they're all released at
+// once when the root cfg_t is freed. Also holds the option indices used by
+// the tree.
+//
+struct cfg_arena_t
+{
+   std::vector<char *> blocks;
+   size_t used; // bytes taken from the last block
+   size_t size; // size of the last block
+   std::unordered_map<const cfg_opt_t *, cfg_optindex_t> optindexes;
+};
+
+// arena sizes, in bytes
+static constexpr size_t ARENA_ALIGN      = 16;
+static constexpr size_t ARENA_FIRSTBLOCK = 4096;
+static constexpr size_t ARENA_MAXBLOCK   = 65536;
+
+static cfg_arena_t *cfg_arena_new()
+{
+   cfg_arena_t *arena = new cfg_arena_t;
+   arena->used = arena->size = 0;
+   return arena;
+}
+
+static void cfg_arena_free(cfg_arena_t *arena)
+{
+   if(!arena)
+      return;
+   for(char *block : arena->blocks)
+      free(block);
+   delete arena;
+}
+
+//
+// Returns zeroed memory from the arena
+//
+static void *cfg_arena_alloc(cfg_arena_t *arena, size_t size)
+{
+   size = (size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+   if(arena->blocks.empty() || arena->used + size > arena->size)
+   {
+      // blocks double in size up to a limit, so small trees stay small
+      size_t blocksize = arena->size ? arena->size * 2 : ARENA_FIRSTBLOCK;
+      if(blocksize > ARENA_MAXBLOCK)
+         blocksize = ARENA_MAXBLOCK;
+      if(blocksize < size)
+         blocksize = size;
+      char *block = (char *)calloc(blocksize, 1);
+      cfg_assert(block);
+      arena->blocks.push_back(block);
+      arena->used = 0;
+      arena->size = blocksize;
+   }
+   void *ptr = arena->blocks.back() + arena->used;
+   arena->used += size;
+   return ptr;
+}
+
+//
+// FNV-1a hash of an option name, ignoring case
+//
+static unsigned int cfg_hashname(const char *name)
+{
+   unsigned int hash = 2166136261u;
+   for(; *name; ++name)
+   {
+      hash ^= static_cast<unsigned char>(tolower(*name));
+      hash *= 16777619u;
+   }
+   return hash;
+}
+
+//
+// Gets the index of an option table, building it on first request
+//
+static const cfg_optindex_t *cfg_getoptindex(cfg_arena_t *arena, const cfg_opt_t *opts)
+{
+   if(!arena || !opts)
+      return NULL;
+   auto it = arena->optindexes.find(opts);
+   if(it != arena->optindexes.end())
+      return &it->second;
+
+   int n;
+   for(n = 0; opts[n].name; n++) /* do nothing */ ;
+
+   // keep the load factor at most one half
+   unsigned int size = 1;
+   while(size < 2 * static_cast<unsigned int>(n))
+      size <<= 1;
+
+   cfg_optindex_t &index = arena->optindexes[opts];
+   index.slots.assign(size, 0);
+   index.mask = size - 1;
+   index.numopts = n;
+   for(int i = 0; i < n; i++)
+   {
+      unsigned int slot = cfg_hashname(opts[i].name) & index.mask;
+      while(index.slots[slot])
+         slot = (slot + 1) & index.mask;
+      index.slots[slot] = i + 1;
+   }
+   return &index;
+}
+
+//
+// Looks up an option of a section using its index
+//
+static cfg_opt_t *cfg_findopt(cfg_t *sec, const char *name)
+{
+   bool nocase = is_set(CFGF_NOCASE, sec->flags);
+   if(sec->optindex)
+   {
+      const cfg_optindex_t *index = sec->optindex;
+      unsigned int slot = cfg_hashname(name) & index->mask;
+      for(; index->slots[slot]; slot = (slot + 1) & index->mask)
+      {
+         cfg_opt_t *opt = &sec->opts[index->slots[slot] - 1];
+         if(!(nocase ? strcasecmp(opt->name, name) : strcmp(opt->name, name)))
+            return opt;
+      }
+      return NULL;
+   }
+
+   for(int i = 0; sec->opts[i].name; i++)
+   {
+      if(nocase)
+      {
+         if(strcasecmp(sec->opts[i].name, name) == 0)
+            return &sec->opts[i];
+      } 
+      else 
+      {
+         if(strcmp(sec->opts[i].name, name) == 0)
+            return &sec->opts[i];
+      }
+   }
+   return NULL;
+}
+
 //=============================================================================
 //
 // Option Retrieval
@@ -114,7 +275,6 @@ static char *cfg_strndup(const char *s, size_t n)
 
 cfg_opt_t *cfg_getopt(cfg_t *cfg, const char *name)
 {
-   int i;
    cfg_t *sec = cfg;
    
    cfg_assert(cfg && cfg->name && name);
@@ -145,23 +305,41 @@ cfg_opt_t *cfg_getopt(cfg_t *cfg, const char *name)
    if(name[0] == '+' || name[0] == '-')
       ++name; // skip past it for lookup
    
-   for(i = 0; sec->opts[i].name; i++)
-   {
-      if(is_set(CFGF_NOCASE, sec->flags))
-      {
-         if(strcasecmp(sec->opts[i].name, name) == 0)
-            return &sec->opts[i];
-      } 
-      else 
-      {
-         if(strcmp(sec->opts[i].name, name) == 0)
-            return &sec->opts[i];
-      }
-   }
+   cfg_opt_t *opt = cfg_findopt(sec, name);
+   if(opt)
+      return opt;
    cfg_error(cfg, "no such option '%s'\n", name);
    return 0;
 }
 
+//
+// cfg_gethandle
+//
+// Resolves an option name to a handle once, so it can be fetched quickly
+// with cfg_getopthandle from any section sharing the option table.
+//
+cfg_handle_t cfg_gethandle(cfg_t *cfg, const char *name)
+{
+   cfg_opt_t *opt = cfg_getopt(cfg, name);
+   return opt ? static_cast<cfg_handle_t>(opt - cfg->opts) : -1;
+}
+
+cfg_opt_t *cfg_getopthandle(cfg_t *cfg, cfg_handle_t handle)
+{
+   cfg_assert(cfg);
+   int numopts = 0;
+   if(cfg->optindex)
+      numopts = cfg->optindex->numopts;
+   else
+      for(; cfg->opts[numopts].name; numopts++) /* do nothing */ ;
+   if(handle < 0 || handle >= numopts)
+   {
+      cfg_error(cfg, "invalid option handle %d\n", handle);
+      return 0;
+   }
+   return &cfg->opts[handle];
+}
+
 //
 // cfg_gettitleopt
 //
@@ -200,10 +378,8 @@ cfg_t *cfg_displaced(cfg_t *cfg)
    return cfg->displaced;
 }
 
-signed int cfg_getnint(cfg_t *cfg, const char *name, unsigned int index)
+signed int cfg_opt_getnint(cfg_opt_t *opt, unsigned int index)
 {
-   cfg_opt_t *opt = cfg_getopt(cfg, name);
-   
    if(opt)
    {
       cfg_assert(opt->type == CFGT_INT);
@@ -219,15 +395,18 @@ signed int cfg_getnint(cfg_t *cfg, const char *name, unsigned int index)
       return 0;
 }
 
+signed int cfg_getnint(cfg_t *cfg, const char *name, unsigned int index)
+{
+   return cfg_opt_getnint(cfg_getopt(cfg, name), index);
+}
+
 signed int cfg_getint(cfg_t *cfg, const char *name)
 {
    return cfg_getnint(cfg, name, 0);
 }
 
-double cfg_getnfloat(cfg_t *cfg, const char *name, unsigned int index)
+double cfg_opt_getnfloat(cfg_opt_t *opt, unsigned int index)
 {
-   cfg_opt_t *opt = cfg_getopt(cfg, name);
-   
    if(opt) 
    {
       cfg_assert(opt->type == CFGT_FLOAT);
@@ -243,15 +422,18 @@ double cfg_getnfloat(cfg_t *cfg, const char *name, unsigned int index)
       return 0;
 }
 
+double cfg_getnfloat(cfg_t *cfg, const char *name, unsigned int index)
+{
+   return cfg_opt_getnfloat(cfg_getopt(cfg, name), index);
+}
+
 double cfg_getfloat(cfg_t *cfg, const char *name)
 {
    return cfg_getnfloat(cfg, name, 0);
 }
 
-bool cfg_getnbool(cfg_t *cfg, const char *name, unsigned int index)
+bool cfg_opt_getnbool(cfg_opt_t *opt, unsigned int index)
 {
-   cfg_opt_t *opt = cfg_getopt(cfg, name);
-   
    if(opt)
    {
       cfg_assert(opt->type == CFGT_BOOL);
@@ -267,6 +449,11 @@ bool cfg_getnbool(cfg_t *cfg, const char *name, unsigned int index)
       return false;
 }
 
+bool cfg_getnbool(cfg_t *cfg, const char *name, unsigned int index)
+{
+   return cfg_opt_getnbool(cfg_getopt(cfg, name), index);
+}
+
 bool cfg_getbool(cfg_t *cfg, const char *name)
 {
    return cfg_getnbool(cfg, name, 0);
@@ -274,10 +461,8 @@ bool cfg_getbool(cfg_t *cfg, const char *name)
 
 // haleyjd 12/27/10: return value must be explicitly const (was implicitly
 // considered that way anyway)
-const char *cfg_getnstr(cfg_t *cfg, const char *name, unsigned int index)
+const char *cfg_opt_getnstr(cfg_opt_t *opt, unsigned int index)
 {
-   cfg_opt_t *opt = cfg_getopt(cfg, name);
-   
    if(opt)
    {
       cfg_assert(opt->type == CFGT_STR || opt->type == CFGT_STRFUNC); // haleyjd
@@ -292,6 +477,11 @@ const char *cfg_getnstr(cfg_t *cfg, const char *name, unsigned int index)
    return 0;
 }
 
+const char *cfg_getnstr(cfg_t *cfg, const char *name, unsigned int index)
+{
+   return cfg_opt_getnstr(cfg_getopt(cfg, name), index);
+}
+
 const char *cfg_getstr(cfg_t *cfg, const char *name)
 {
    return cfg_getnstr(cfg, name, 0);
@@ -307,8 +497,11 @@ char *cfg_getstrdup(cfg_t *cfg, const char *name)
 
 cfg_t *cfg_getnsec(cfg_t *cfg, const char *name, unsigned int index)
 {
-   cfg_opt_t *opt = cfg_getopt(cfg, name);
-   
+   return cfg_opt_getnsec(cfg_getopt(cfg, name), index);
+}
+
+cfg_t *cfg_opt_getnsec(cfg_opt_t *opt, unsigned int index)
+{
    if(opt) 
    {
       cfg_assert(opt->type == CFGT_SEC);
@@ -443,12 +636,19 @@ cfg_t *cfg_gettitleprops(cfg_t *cfg)
 // Internal Value Maintenance
 //
 
-static cfg_value_t *cfg_addval(cfg_opt_t *opt)
+static cfg_value_t *cfg_addval(cfg_t *cfg, cfg_opt_t *opt)
 {
-   opt->values = (cfg_value_t **)realloc(opt->values,
-                          (opt->nvalues+1) * sizeof(cfg_value_t *));
-   cfg_assert(opt->values);
-   opt->values[opt->nvalues] = (cfg_value_t *)calloc(sizeof(cfg_value_t), 1);
+   // grow the array geometrically: its capacity is the next power of two
+   // of nvalues, so it's full whenever nvalues is a power of two
+   if(!(opt->nvalues & (opt->nvalues - 1)))
+   {
+      unsigned int capacity = opt->nvalues ? opt->nvalues * 2 : 1;
+      opt->values = (cfg_value_t **)realloc(opt->values,
+                                            capacity * sizeof(cfg_value_t *));
+      cfg_assert(opt->values);
+   }
+   opt->values[opt->nvalues] =
+      (cfg_value_t *)cfg_arena_alloc(cfg->arena, sizeof(cfg_value_t));
    return opt->values[opt->nvalues++];
 }
 
@@ -525,7 +725,7 @@ cfg_value_t *cfg_setopt(cfg_t *cfg, cfg_opt_t *opt, const char *value)
             }
          }
          if(val == 0)
-            val = cfg_addval(opt);
+            val = cfg_addval(cfg, opt);
       }
       else
          val = opt->values[0];
@@ -611,6 +811,10 @@ cfg_value_t *cfg_setopt(cfg_t *cfg, cfg_opt_t *opt, const char *value)
       val->section->filename  = cfg->filename;
       val->section->line      = cfg->line;
       val->section->errfunc   = cfg->errfunc;
+      val->section->errdata   = cfg->errdata;
+      val->section->lexer     = cfg->lexer;
+      val->section->arena     = cfg->arena;
+      val->section->optindex  = cfg_getoptindex(cfg->arena, opt->subopts);
       val->section->title     = value ? strdup(value) : NULL;
       // haleyjd 01/02/12: make the old section a displaced version of the
       // new one, so that it can remain accessible
@@ -676,7 +880,7 @@ void cfg_free_value(cfg_opt_t *opt)
          free(opt->values[i]->string);
       else if(opt->type == CFGT_SEC || opt->type == CFGT_MVPROP) // haleyjd
          cfg_free(opt->values[i]->section);
-      free(opt->values[i]);
+      // the value itself is in the arena of the root cfg_t
    }
    free(opt->values);
    opt->values = 0;
@@ -698,6 +902,16 @@ cfg_errfunc_t cfg_set_error_function(cfg_t *cfg, cfg_errfunc_t errfunc)
    return old;
 }
 
+void *cfg_set_error_data(cfg_t *cfg, void *errdata)
+{
+   void *old;
+
+   cfg_assert(cfg);
+   old = cfg->errdata;
+   cfg->errdata = errdata;
+   return old;
+}
+
 //
 // cfg_set_lexer_callback
 //
@@ -855,11 +1069,11 @@ static int cfg_pstate_expectoption(cfg_t *cfg, int level, cfg_pstate_t &pstate)
 
    if(pstate.tok != CFGT_STR)
    {
-      cfg_error(cfg, "unexpected token '%s'\n", mytext);
+      cfg_error(cfg, "unexpected token '%s'\n", lexer_tokentext(cfg));
       return STATE_ERROR;
    }         
 
-   if((pstate.opt = cfg_getopt(cfg, mytext)) == 0) // haleyjd
+   if((pstate.opt = cfg_getopt(cfg, lexer_tokentext(cfg))) == 0) // haleyjd
       return STATE_ERROR;
 
    switch(pstate.opt->type)
@@ -876,7 +1090,7 @@ static int cfg_pstate_expectoption(cfg_t *cfg, int level, cfg_pstate_t &pstate)
       break;
 
    case CFGT_FLAG: // haleyjd: flag options, which are simple keywords
-      if(cfg_setopt(cfg, pstate.opt, mytext) == 0)
+      if(cfg_setopt(cfg, pstate.opt, lexer_tokentext(cfg)) == 0)
          return STATE_ERROR;
       // remain in STATE_EXPECT_OPTION
       break;
@@ -967,7 +1181,7 @@ static int cfg_pstate_expectvalue(cfg_t *cfg, int level, cfg_pstate_t &pstate)
    {
       if(!pstate.list_nobraces)
       {
-         lexer_set_unquoted_spaces(false); /* haleyjd */
+         lexer_set_unquoted_spaces(cfg, false); /* haleyjd */
          pstate.state = STATE_EXPECT_OPTION;
          return STATE_CONTINUE;
       }
@@ -975,7 +1189,7 @@ static int cfg_pstate_expectvalue(cfg_t *cfg, int level, cfg_pstate_t &pstate)
 
    if(pstate.tok != CFGT_STR)
    {
-      cfg_error(cfg, "unexpected token '%s'\n", mytext);
+      cfg_error(cfg, "unexpected token '%s'\n", lexer_tokentext(cfg));
       return STATE_ERROR;
    }
 
@@ -985,7 +1199,7 @@ static int cfg_pstate_expectvalue(cfg_t *cfg, int level, cfg_pstate_t &pstate)
    if(pstate.opt->type == CFGT_STRFUNC)
       pstate.next_state = STATE_EXPECT_PAREN;
 
-   if(cfg_setopt(cfg, pstate.opt, mytext) == 0)
+   if(cfg_setopt(cfg, pstate.opt, lexer_tokentext(cfg)) == 0)
       return STATE_ERROR;
 
    pstate.state = pstate.next_state;
@@ -1007,7 +1221,7 @@ static int cfg_pstate_expectlistbrace(cfg_t *cfg, int level, cfg_pstate_t &pstat
 
    // haleyjd 12/23/06: set unquoted string state
    if(is_set(CFGF_STRSPACE, pstate.opt->flags))
-      lexer_set_unquoted_spaces(true);
+      lexer_set_unquoted_spaces(cfg, true);
    
    pstate.state      = STATE_EXPECT_VALUE;
    pstate.next_state = STATE_EXPECT_LISTNEXT;
@@ -1028,7 +1242,7 @@ static int cfg_pstate_expectlistnext(cfg_t *cfg, int level, cfg_pstate_t &pstate
    } 
    else if(!pstate.list_nobraces && pstate.tok == '}')
    {
-      lexer_set_unquoted_spaces(false);   // haleyjd
+      lexer_set_unquoted_spaces(cfg, false);   // haleyjd
       pstate.state = STATE_EXPECT_OPTION;
    }
    else if(pstate.list_nobraces)
@@ -1040,7 +1254,7 @@ static int cfg_pstate_expectlistnext(cfg_t *cfg, int level, cfg_pstate_t &pstate
    }
    else
    {
-      cfg_error(cfg, "unexpected token '%s'\n", mytext);
+      cfg_error(cfg, "unexpected token '%s'\n", lexer_tokentext(cfg));
       return STATE_ERROR;
    }
 
@@ -1149,7 +1363,7 @@ static int cfg_pstate_expecttitle(cfg_t *cfg, int level, cfg_pstate_t &pstate)
       return STATE_ERROR;
    }
    else
-      pstate.opttitle = strdup(mytext);
+      pstate.opttitle = cfg_strndup(cfg->lexer->token.data(), cfg->lexer->token.size());
    
    pstate.state = STATE_EXPECT_SECBRACE;   
    return STATE_CONTINUE;
@@ -1212,8 +1426,8 @@ static int cfg_pstate_expectargument(cfg_t *cfg, int level, cfg_pstate_t &pstate
    }
    else if(pstate.tok == CFGT_STR)
    {
-      pstate.val = cfg_addval(&pstate.funcopt);
-      pstate.val->string = strdup(mytext);
+      pstate.val = cfg_addval(cfg, &pstate.funcopt);
+      pstate.val->string = cfg_strndup(cfg->lexer->token.data(), cfg->lexer->token.size());
       pstate.state = STATE_EXPECT_ARGNEXT;
    } 
    else 
@@ -1275,19 +1489,19 @@ static int cfg_pstate_expectlookfor(cfg_t *cfg, int level, cfg_pstate_t &pstate)
    // encountered
    if(is_set(CFGF_NOCASE, cfg->flags))
    {
-      if(!strcasecmp(mytext, cfg->lookfor))
+      if(!strcasecmp(lexer_tokentext(cfg), cfg->lookfor))
          pstate.found_func = true;
    }
    else
    {
-      if(!strcmp(mytext, cfg->lookfor))
+      if(!strcmp(lexer_tokentext(cfg), cfg->lookfor))
          pstate.found_func = true;
    }
 
    // Found the "lookfor" function?
    if(pstate.found_func == true)
    {
-      pstate.opt = cfg_getopt(cfg, mytext);
+      pstate.opt = cfg_getopt(cfg, lexer_tokentext(cfg));
       if(pstate.opt == 0)
          return STATE_ERROR;
 
@@ -1416,8 +1630,11 @@ cfg_t *cfg_init(cfg_opt_t *opts, cfg_flag_t flags)
    cfg->line     = 0;
    cfg->lumpnum  = -1;   // haleyjd
    cfg->errfunc  = 0;
+   cfg->errdata  = NULL;
    cfg->lexfunc  = 0;    // haleyjd
    cfg->lookfor  = NULL; // haleyjd
+   cfg->arena    = cfg_arena_new();
+   cfg->optindex = cfg_getoptindex(cfg->arena, opts);
 
    // haleyjd: removed ENABLE_NLS
 
@@ -1451,12 +1668,18 @@ int cfg_parse_dwfile(cfg_t *cfg, const char *filename, DWFILE *file)
 
    cfg->lumpnum = file->getLumpNum();
 
+   // Each parse has its own lexer state, so separate cfg_t objects may be
+   // parsed from different threads at once.
+   cfg_lexer_t lexer;
+   cfg->lexer = &lexer;
+
    // haleyjd: initialize the lexer
    if(lexer_init(cfg, file) == 0)
       ret = cfg_parse_internal(cfg, 0);
 
    // haleyjd: reset the lexer state
-   lexer_reset();
+   lexer_reset(cfg);
+   cfg->lexer = nullptr;
 
    if(ret == STATE_ERROR)
       return CFG_PARSE_ERROR;
@@ -1484,7 +1707,7 @@ int cfg_parse(cfg_t *cfg, const char *filename)
 int cfg_parselump(cfg_t *cfg, const Wad &wad, const char *lumpname, int lumpnum)
 {
    const Lump *lump = wad.FindLump(lumpname);
-   if(!lump || lump->Data().empty())
+   if(!lump || !lump->Size())
       return CFG_SUCCESS;
 
    DWFILE dwfile; // haleyjd
@@ -1521,7 +1744,10 @@ void cfg_free(cfg_t *cfg)
       free(const_cast<char *>(cfg->title));
    }
    else
+   {
       free(cfg->filename);
+      cfg_arena_free(cfg->arena);
+   }
    
    free(cfg);
 }
@@ -1529,6 +1755,7 @@ void cfg_free(cfg_t *cfg)
 int cfg_include(cfg_t *cfg, cfg_opt_t *opt, int argc, const char **argv)
 {
    char *data;
+   size_t len;
 
    if(argc != 1)      
    {
@@ -1536,10 +1763,10 @@ int cfg_include(cfg_t *cfg, cfg_opt_t *opt, int argc, const char **argv)
       return 1;
    }
 
-   if(!(data = cfg_lexer_mustopen(cfg, argv[0], nullptr, -1, NULL)))
+   if(!(data = cfg_lexer_mustopen(cfg, argv[0], nullptr, -1, &len)))
       return 1;
 
-   return cfg_lexer_include(cfg, data, argv[0], -1);
+   return cfg_lexer_include(cfg, data, len, argv[0], -1);
 }
 
 //=============================================================================
@@ -1547,7 +1774,7 @@ int cfg_include(cfg_t *cfg, cfg_opt_t *opt, int argc, const char **argv)
 // haleyjd 04/03/08: added cfg_t value-setting functions from libConfuse 2.0
 //
 
-static cfg_value_t *cfg_getval(cfg_opt_t *opt, unsigned int index)
+static cfg_value_t *cfg_getval(cfg_t *cfg, cfg_opt_t *opt, unsigned int index)
 {
    cfg_value_t *val = 0;
 
@@ -1568,7 +1795,7 @@ static cfg_value_t *cfg_getval(cfg_opt_t *opt, unsigned int index)
       */
       if(index >= opt->nvalues)
       {
-         val = cfg_addval(opt);
+         val = cfg_addval(cfg, opt);
       }
       else
          val = opt->values[index];
@@ -1583,7 +1810,7 @@ void cfg_opt_setnint(cfg_t *cfg, cfg_opt_t *opt, int value,
    cfg_value_t *val;
 
    cfg_assert(cfg && opt && opt->type == CFGT_INT);
-   val = cfg_getval(opt, index);
+   val = cfg_getval(cfg, opt, index);
    val->number = value;
 }
 
@@ -1607,7 +1834,7 @@ void cfg_opt_setnfloat(cfg_t *cfg, cfg_opt_t *opt, double value,
    cfg_value_t *val;
 
    cfg_assert(cfg && opt && opt->type == CFGT_FLOAT);
-   val = cfg_getval(opt, index);
+   val = cfg_getval(cfg, opt, index);
    val->fpnumber = value;
 }
 
@@ -1631,7 +1858,7 @@ void cfg_opt_setnbool(cfg_t *cfg, cfg_opt_t *opt, bool value,
    cfg_value_t *val;
 
    cfg_assert(cfg && opt && opt->type == CFGT_BOOL);
-   val = cfg_getval(opt, index);
+   val = cfg_getval(cfg, opt, index);
    val->boolean = value;
 }
 
@@ -1655,7 +1882,7 @@ void cfg_opt_setnstr(cfg_t *cfg, cfg_opt_t *opt, const char *value,
    cfg_value_t *val;
 
    cfg_assert(cfg && opt && opt->type == CFGT_STR);
-   val = cfg_getval(opt, index);
+   val = cfg_getval(cfg, opt, index);
    if(val->string) // haleyjd: !
       free(val->string);
    val->string = value ? strdup(value) : 0;
@@ -95,6 +95,9 @@ enum cfg_dialect_t
 union  cfg_value_t;
 struct cfg_opt_t;
 struct cfg_t;
+struct cfg_lexer_t;
+struct cfg_arena_t;
+struct cfg_optindex_t;
 
 typedef int cfg_flag_t;
 
@@ -179,10 +182,17 @@ struct cfg_t
    cfg_errfunc_t errfunc;  /**< This function (set with
                                 * cfg_set_error_function) is called for
                                 * any error message. */
+   void *errdata;          /**< User data for errfunc, set with
+                                * cfg_set_error_data. */
    cfg_lexfunc_t lexfunc;  /**< haleyjd: A callback dispatched by the lexer
                                 * when initially opening a file. */
    const char *lookfor;    /**< Name of a function to look for. */
    cfg_t *displaced;       /**< haleyjd: pointer to a displaced section */
+   cfg_lexer_t *lexer;     /**< State of the lexer while this section is
+                                * being parsed; shared with subsections. */
+   cfg_arena_t *arena;     /**< Storage of the values of the root cfg_t and
+                                * all its subsections. */
+   const cfg_optindex_t *optindex; /**< Hash index of opts, owned by arena */
 };
 
 /** 
@@ -433,6 +443,12 @@ void          cfg_free(cfg_t *cfg);
  */
 cfg_errfunc_t cfg_set_error_function(cfg_t *cfg, cfg_errfunc_t errfunc);
 
+/** Set user data for the error reporting function, kept in cfg->errdata
+ * of the context and its sections.
+ * @return The old user data is returned.
+ */
+void         *cfg_set_error_data(cfg_t *cfg, void *errdata);
+
 /** Install a user-defined lexer callback function.
  * @return The old lexer callback function is returned.
  */
@@ -664,6 +680,41 @@ int cfg_parse_boolean(const char *s);
  */
 cfg_opt_t *cfg_getopt(cfg_t *cfg, const char *name);
 
+/** Handle of an option, resolved once by name. It stays valid for all the
+ * sections created from the same option table.
+ */
+typedef int cfg_handle_t;
+
+/** Resolve the name of an option to a handle.
+ *
+ * @param cfg The configuration file context.
+ * @param name The name of the option.
+ *
+ * @return Returns the handle, or -1 if the option is not found (an error
+ * message is also printed).
+ */
+cfg_handle_t cfg_gethandle(cfg_t *cfg, const char *name);
+
+/** Return an option given its handle, as returned from cfg_gethandle().
+ *
+ * @param cfg The configuration file context.
+ * @param handle The handle of the option.
+ *
+ * @return Returns the option, or NULL if the handle is out of range (an
+ * error message is also printed).
+ */
+cfg_opt_t *cfg_getopthandle(cfg_t *cfg, cfg_handle_t handle);
+
+/** Indexed value getters for an option structure, as returned from
+ * cfg_getopt() or cfg_getopthandle(). They return the default value if the
+ * option has no values.
+ */
+int           cfg_opt_getnint(cfg_opt_t *opt, unsigned int index);
+double        cfg_opt_getnfloat(cfg_opt_t *opt, unsigned int index);
+const char *  cfg_opt_getnstr(cfg_opt_t *opt, unsigned int index);
+bool          cfg_opt_getnbool(cfg_opt_t *opt, unsigned int index);
+cfg_t *       cfg_opt_getnsec(cfg_opt_t *opt, unsigned int index);
+
 /** Set a value of an integer option.
  *
  * @param cfg The configuration file context.
@@ -77,6 +77,9 @@ public:
    inline bool isData()     const { return !!data;  }
    inline int  getLumpNum() const { return lumpnum; }
 
+   // Contents of an open lump, for reading them in place
+   inline const uint8_t *getLumpData() const { return lump; }
+
    // haleyjd 03/21/10
    enum DWFType
    {
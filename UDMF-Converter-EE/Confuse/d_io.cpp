@@ -156,8 +156,8 @@ void DWFILE::openLump(const Wad &wad, int p_lumpnum)
 
    // haleyjd 04/03/03: added origsize field for D_Ungetc
    lumpnum = p_lumpnum;
-   size = origsize = (int)wad.Lumps()[p_lumpnum].Data().size();
-   inp = lump = wad.Lumps()[p_lumpnum].Data().data();
+   size = origsize = (int)wad.Lumps()[p_lumpnum].Size();
+   inp = lump = wad.Lumps()[p_lumpnum].Data();
    type    = DWF_LUMP;
 
    // zero out fields not used for lump reading
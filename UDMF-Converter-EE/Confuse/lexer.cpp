@@ -35,10 +35,7 @@
 #include <string>
 
 #include "confuse.h"
-
-// file include stack
-
-#define MAX_INCLUDE_DEPTH 16
+#include "lexer.h"
 
 // haleyjd 10/30/06: enum for text control characters
 enum
@@ -71,30 +68,6 @@ enum
    TEXT_CONTROL_MAX
 };
 
-static struct cfginclude_s
-{
-   char          *filename;
-   int            lumpnum;  // haleyjd
-   unsigned int   line;
-   char          *buffer;   // haleyjd 03/16/08
-   char          *pos;
-   cfg_dialect_t  dialect;  // haleyjd 09/17/12
-} include_stack[MAX_INCLUDE_DEPTH];
-
-static int include_stack_ptr = 0;
-
-// haleyjd 09/17/12: current parser dialect
-static cfg_dialect_t currentDialect = CFG_DIALECT_DELTA;
-
-const char *mytext; // haleyjd: equivalent to yytext
-
-// haleyjd 07/11/03: dynamic string buffer solution from 
-// libConfuse v2.0; eliminates unsafe, overflowable array
-// 02/12/04: replaced with generalized solution in m_qstr.c
-
-static std::string qstr;
-static std::string hexchar;
-
 //
 // lexer_error
 //
@@ -106,24 +79,16 @@ static void lexer_error(cfg_t *cfg, const char *msg)
    cfg_error(cfg, "lexer error @ %s:%d:\n\t%s\n", cfg->filename, cfg->line, msg);
 }
 
-// haleyjd 12/23/06: if true, unquoted strings can contain spaces
-// at the moment. Defaults to false.
-
-static bool unquoted_spaces = false;
-
 //
 // lexer_set_unquoted_spaces
 //
 // Toggles the behavior of spaces inside unquoted strings.
 //
-void lexer_set_unquoted_spaces(bool us)
+void lexer_set_unquoted_spaces(cfg_t *cfg, bool us)
 {
-   unquoted_spaces = us;
+   cfg->lexer->unquoted_spaces = us;
 }
 
-static char *lexbuffer; // current file buffer
-static char *bufferpos; // position in buffer
-
 static char *lexer_buffer_file(DWFILE *dwfile, size_t *len)
 {
    size_t  foo;
@@ -131,7 +96,7 @@ static char *lexer_buffer_file(DWFILE *dwfile, size_t *len)
    char   *buffer;
    
    size   = static_cast<size_t>(dwfile->fileLength());
-   buffer = (char *)malloc(size + 1);
+   buffer = (char *)malloc(size ? size : 1);
 
    if((foo = dwfile->read(buffer, 1, size)) != size)
    {
@@ -140,9 +105,6 @@ static char *lexer_buffer_file(DWFILE *dwfile, size_t *len)
       exit(EXIT_FAILURE);
    }
 
-   // null-terminate buffer
-   buffer[size] = '\0';
-
    // write back size
    if(len)
       *len = size;
@@ -150,11 +112,12 @@ static char *lexer_buffer_file(DWFILE *dwfile, size_t *len)
    return buffer;
 }
 
-static void lexer_free_buffer()
+static void lexer_free_buffer(cfg_lexer_t *lex)
 {
-   if(lexbuffer)
-      free(lexbuffer);
-   lexbuffer = bufferpos = NULL;
+   if(lex->lexbuffer)
+      free(lex->lexbuffer);
+   lex->lexbuffer = NULL;
+   lex->bufferpos = lex->bufferend = NULL;
 }
 
 //
@@ -164,21 +127,34 @@ static void lexer_free_buffer()
 //
 int lexer_init(cfg_t *cfg, DWFILE *file)
 {
-   char   *buf;
-   size_t len;
-   int    code = 0;
+   char       *buf = NULL;
+   const char *data;
+   size_t      len;
+   int         code = 0;
 
-   buf = lexer_buffer_file(file, &len);
+   // lumps are already in memory, so they're lexed in place
+   if(file->isLump())
+   {
+      data = reinterpret_cast<const char *>(file->getLumpData());
+      len  = static_cast<size_t>(file->fileLength());
+   }
+   else
+      data = buf = lexer_buffer_file(file, &len);
 
    // haleyjd 03/21/10: optional cfg_t lexer callback
    if(cfg && cfg->lexfunc)
-      code = cfg->lexfunc(cfg, buf, (int)len);
+      code = cfg->lexfunc(cfg, data, (int)len);
 
    if(!code)
    {
-      qstr.clear();
-      bufferpos = lexbuffer = buf;
+      cfg_lexer_t *lex = cfg->lexer;
+      lex->qstr.clear();
+      lex->lexbuffer = buf;
+      lex->bufferpos = data;
+      lex->bufferend = data + len;
    }
+   else if(buf)
+      free(buf);
 
    return code;
 }
@@ -190,22 +166,26 @@ int lexer_init(cfg_t *cfg, DWFILE *file)
 // important for this to be called by the libConfuse parser before parsing
 // each independent cfg_t.
 //
-void lexer_reset()
+void lexer_reset(cfg_t *cfg)
 {
+   cfg_lexer_t *lex = cfg->lexer;
+
    // clear include stack
-   memset(include_stack, 0, MAX_INCLUDE_DEPTH*sizeof(struct cfginclude_s));
-   include_stack_ptr = 0;
+   memset(lex->include_stack, 0, sizeof(lex->include_stack));
+   lex->include_stack_ptr = 0;
 
    // reset lexer variables
-   mytext = NULL;
-   unquoted_spaces = false;
-   currentDialect  = CFG_DIALECT_DELTA;
+   lex->token = std::string_view();
+   lex->tokenstart = lex->tokenend = NULL;
+   lex->tokencopied = false;
+   lex->unquoted_spaces = false;
+   lex->currentDialect  = CFG_DIALECT_DELTA;
 
    // free qstring buffer
-   qstr.clear();
+   lex->qstr.clear();
 
    // ensure that buffer state is reset
-   lexer_free_buffer();
+   lexer_free_buffer(lex);
 }
 
 //=============================================================================
@@ -229,6 +209,7 @@ enum
 typedef struct lexerstate_s
 {
    cfg_t *cfg;        // current cfg_t
+   cfg_lexer_t *lex;  // lexer state of the cfg_t
    int   state;       // current state of the lexer
    int   stringtype;  // type of string being parsed
    int   heredoctype; // type of heredoc delimiter being used
@@ -238,6 +219,94 @@ typedef struct lexerstate_s
 // lexer function protocol
 typedef int (*lexfunc_t)(lexerstate_t *);
 
+//
+// lexer_peek
+//
+// Looks ahead to the next character, which is '\0' at the end of the input.
+//
+static char lexer_peek(const cfg_lexer_t *lex)
+{
+   return lex->bufferpos < lex->bufferend ? *lex->bufferpos : '\0';
+}
+
+//
+// lexer_begintoken
+//
+// Starts a string token at the given position of the input.
+//
+static void lexer_begintoken(cfg_lexer_t *lex, const char *start)
+{
+   lex->tokenstart  = start;
+   lex->tokenend    = start;
+   lex->tokencopied = false;
+   lex->qstr.clear();
+}
+
+//
+// lexer_copytoken
+//
+// Copies the token read so far, up to end, into qstr. Needed when the rest
+// of the token isn't the same as the input.
+//
+static void lexer_copytoken(cfg_lexer_t *lex, const char *end)
+{
+   if(!lex->tokencopied)
+   {
+      lex->qstr.assign(lex->tokenstart, end - lex->tokenstart);
+      lex->tokencopied = true;
+   }
+}
+
+//
+// lexer_addchar
+//
+// Adds a character from the input to the token. A token which is still a
+// view of the input already has it.
+//
+static void lexer_addchar(cfg_lexer_t *lex, char c)
+{
+   if(lex->tokencopied)
+      lex->qstr += c;
+}
+
+//
+// lexer_endtoken
+//
+// Finishes the current string token, which ends at tokenend unless copied.
+//
+static void lexer_endtoken(cfg_lexer_t *lex)
+{
+   if(lex->tokencopied)
+      lex->token = lex->qstr;
+   else
+   {
+      // carriage returns are never part of tokens; a view can only have
+      // them at the end, before the line break which ended it
+      const char *end = lex->tokenend;
+      while(end > lex->tokenstart && end[-1] == '\r')
+         --end;
+      lex->token = std::string_view(lex->tokenstart, end - lex->tokenstart);
+   }
+}
+
+//
+// lexer_tokentext
+//
+// Returns the current token as a NUL-terminated string, copying it if it's
+// a view of the input.
+//
+const char *lexer_tokentext(cfg_t *cfg)
+{
+   cfg_lexer_t *lex = cfg->lexer;
+
+   if(lex->token.data() != lex->qstr.data())
+   {
+      lex->qstr.assign(lex->token.data(), lex->token.size());
+      lex->token = lex->qstr;
+   }
+   return lex->qstr.c_str();
+}
+
 // state enumeration for lexer FSA
 enum
 {
@@ -281,9 +350,9 @@ static int lexer_state_mlcomment(lexerstate_t *ls)
    
    if(ls->c == '*')
    {
-      if(*bufferpos == '/') // look ahead to next char
+      if(lexer_peek(ls->lex) == '/') // look ahead to next char
       {
-         ++bufferpos; // move past '/'
+         ++ls->lex->bufferpos; // move past '/'
          ls->state = STATE_NONE;
       }
    }
@@ -305,26 +374,29 @@ static int lexer_state_string(lexerstate_t *ls)
       if(ls->stringtype == 1) // double-quoted string, end it
       {
          // check for coalescence
+         ls->lex->tokenend = ls->lex->bufferpos - 1;
          ls->state = STATE_STRINGCOALESCE;
       }
       else
-         qstr += ls->c;
+         lexer_addchar(ls->lex, ls->c);
       break;
    case '\'':
       if(ls->stringtype == 2) // single-quoted string, end it
       {               
          // check for coalescence
+         ls->lex->tokenend = ls->lex->bufferpos - 1;
          ls->state = STATE_STRINGCOALESCE;
       }
       else
-         qstr += ls->c;
+         lexer_addchar(ls->lex, ls->c);
       break;
    case '\\':
       // a forward slash begins an escape sequence
+      lexer_copytoken(ls->lex, ls->lex->bufferpos - 1);
       ls->state = STATE_ESCAPE;
       break;
    default:
-      qstr += ls->c;
+      lexer_addchar(ls->lex, ls->c);
       break;
    }
 
@@ -345,19 +417,19 @@ static int lexer_state_escape(lexerstate_t *ls)
       ls->state = STATE_LINECONTINUANCE;
       return -1;
    case 'a': // bell
-      qstr += '\a'; 
+      ls->lex->qstr += '\a'; 
       break;
    case 'b': // rub
-      qstr += '\b'; 
+      ls->lex->qstr += '\b'; 
       break;
    case 'n': // line break
-      qstr += '\n'; 
+      ls->lex->qstr += '\n'; 
       break;
    case 't': // tab
-      qstr += '\t'; 
+      ls->lex->qstr += '\t'; 
       break;
    case 'x': // hex escape sequence
-      hexchar.clear();
+      ls->lex->hexchar.clear();
       ls->state = STATE_HEXESCAPE;
       return -1;
    case '0': // NB: *not* null char! Brick color.
@@ -370,31 +442,31 @@ static int lexer_state_escape(lexerstate_t *ls)
    case '7':
    case '8':
    case '9': // haleyjd 03/14/06: color codes      
-      qstr += (char)((ls->c - '0') + TEXT_COLOR_MIN);
+      ls->lex->qstr += (char)((ls->c - '0') + TEXT_COLOR_MIN);
       break;
    case 'C': // absCentered
-      qstr += (char)TEXT_CONTROL_ABSCENTER;
+      ls->lex->qstr += (char)TEXT_CONTROL_ABSCENTER;
       break;
    case 'E': // error
-      qstr += (char)TEXT_COLOR_ERROR;
+      ls->lex->qstr += (char)TEXT_COLOR_ERROR;
       break;
    case 'H': // hi
-      qstr += (char)TEXT_COLOR_HI;
+      ls->lex->qstr += (char)TEXT_COLOR_HI;
       break;
    case 'K': // 'K' is an old alias for "brick" color.
-      qstr += (char)TEXT_COLOR_MIN;
+      ls->lex->qstr += (char)TEXT_COLOR_MIN;
       break;
    case 'N': // normal
-      qstr += (char)TEXT_COLOR_NORMAL;
+      ls->lex->qstr += (char)TEXT_COLOR_NORMAL;
       break;
    case 'S': // shadowed
-      qstr += (char)TEXT_CONTROL_SHADOW;
+      ls->lex->qstr += (char)TEXT_CONTROL_SHADOW;
       break;
    case 'T': // translucency
-      qstr += (char)TEXT_CONTROL_TRANS;
+      ls->lex->qstr += (char)TEXT_CONTROL_TRANS;
       break;
    default: // Anything else is treated literally
-      qstr += ls->c;
+      ls->lex->qstr += ls->c;
       break;
    }
 
@@ -414,11 +486,11 @@ static int lexer_state_hexescape(lexerstate_t *ls)
       (ls->c >= 'A' && ls->c <= 'F') ||
       (ls->c >= 'a' && ls->c <= 'f'))
    {
-      hexchar += ls->c;
+      ls->lex->hexchar += ls->c;
 
-      if(hexchar.length() == 2) // Only two chars max.
+      if(ls->lex->hexchar.length() == 2) // Only two chars max.
       {
-         qstr += (char)strtol(hexchar.c_str(), nullptr, 16);
+         ls->lex->qstr += (char)strtol(ls->lex->hexchar.c_str(), nullptr, 16);
          ls->state = STATE_STRING; // Back to string parsing.
       }
    }
@@ -442,7 +514,7 @@ static int lexer_state_linecontinuance(lexerstate_t *ls)
    if(ls->c != ' ' && ls->c != '\t')
    {
       // put back the last character and return to STATE_STRING
-      --bufferpos;
+      --ls->lex->bufferpos;
       ls->state = STATE_STRING;
    }
 
@@ -467,12 +539,13 @@ static int lexer_state_stringcoalesce(lexerstate_t *ls)
       return -1;
    case '"':     // quotations: coalesce with previous token
    case '\'':
+      lexer_copytoken(ls->lex, ls->lex->tokenend);
       ls->state = STATE_STRING; // go back to string state.
       ls->stringtype = (ls->c == '\'' ? 2 : 1);
       return -1;
    default:      // something else; put it back and return token
-      --bufferpos;
-      mytext = qstr.c_str();
+      --ls->lex->bufferpos;
+      lexer_endtoken(ls->lex);
       return CFGT_STR;
    }
 }
@@ -484,23 +557,24 @@ static int lexer_state_unquotedstring(lexerstate_t *ls)
 {
    char c = ls->c;
 
-   if((!unquoted_spaces && (c == ' ' || c == '\t'))       || 
-      (currentDialect >= CFG_DIALECT_ALFHEIM && c == ':') ||
+   if((!ls->lex->unquoted_spaces && (c == ' ' || c == '\t'))      || 
+      (ls->lex->currentDialect >= CFG_DIALECT_ALFHEIM && c == ':') ||
       c == '"'  || c == '\'' || c == '\n' || c == '='     || 
       c == '{'  || c == '}'  || c == '('  || c == ')'     || 
       c == '+'  || c == ','  || c == '#'  || c == '/'     || 
       c == ';')
    {
       // any special character ends an unquoted string
-      --bufferpos; // put it back
-      mytext = qstr.c_str();
-      
+      --ls->lex->bufferpos; // put it back
+      ls->lex->tokenend = ls->lex->bufferpos;
+      lexer_endtoken(ls->lex);
+
       return CFGT_STR; // return a string token
    }
    else // normal characters
    {
-      qstr += c;
-      
+      lexer_addchar(ls->lex, c);
+
       return -1; // continue parsing
    }
 }
@@ -525,10 +599,11 @@ static int lexer_state_heredoc(lexerstate_t *ls)
    }
 
    // check for end of heredoc
-   if(ls->c == c && *bufferpos == '@')
+   if(ls->c == c && lexer_peek(ls->lex) == '@')
    {
-      ++bufferpos; // move forward past @
-      mytext = qstr.c_str();
+      ls->lex->tokenend = ls->lex->bufferpos - 1;
+      ++ls->lex->bufferpos; // move forward past @
+      lexer_endtoken(ls->lex);
 
       return CFGT_STR; // return a string token
    }
@@ -537,7 +612,7 @@ static int lexer_state_heredoc(lexerstate_t *ls)
       if(ls->c == '\n')
          ls->cfg->line++; // still need to track line numbers
       
-      qstr += ls->c;
+      lexer_addchar(ls->lex, ls->c);
 
       return -1; // continue parsing
    }
@@ -565,12 +640,12 @@ static int lexer_state_none(lexerstate_t *ls)
       ls->state = STATE_SLCOMMENT;
       break;
    case '/':
-      la = *bufferpos; // look ahead to next character
+      la = lexer_peek(ls->lex); // look ahead to next character
       switch(la)
       {
       case '/':
       case '*':
-         ++bufferpos; // move past / or *
+         ++ls->lex->bufferpos; // move past / or *
          ls->state = (la == '/') ? STATE_SLCOMMENT : STATE_MLCOMMENT;
          break;
       default:
@@ -579,59 +654,59 @@ static int lexer_state_none(lexerstate_t *ls)
       }
       break;
    case '{':
-      mytext = "{";
+      ls->lex->token = "{";
       ret = '{';
       break;
    case '}':
-      mytext = "}";
+      ls->lex->token = "}";
       ret = '}';
       break;
    case '(':
-      mytext = "(";
+      ls->lex->token = "(";
       ret = '(';
       break;
    case ')':
-      mytext = ")";
+      ls->lex->token = ")";
       ret = ')';
       break;
    case '=':
-      mytext = "=";
+      ls->lex->token = "=";
       ret = '=';
       break;
    case '+':
-      if(*bufferpos != '=') // look ahead to next character
+      if(lexer_peek(ls->lex) != '=') // look ahead to next character
       {
          // if not '=', start an unquoted string
-         qstr.clear();
-         qstr += ls->c;
+         lexer_begintoken(ls->lex, ls->lex->bufferpos - 1);
          ls->state = STATE_UNQUOTEDSTRING;
       }
       else
       {
-         ++bufferpos; // move past =
-         mytext = "+=";
+         ++ls->lex->bufferpos; // move past =
+         ls->lex->token = "+=";
          ret = '+';
       }
       break;
    case ',':
-      mytext = ",";
+      ls->lex->token = ",";
       ret = ',';
       break;
    case '"': // open double-quoted string
-      qstr.clear();
+      lexer_begintoken(ls->lex, ls->lex->bufferpos);
       ls->state = STATE_STRING;
       ls->stringtype = 1;
       break;
    case '\'': // open single-quoted string
-      qstr.clear();
+      lexer_begintoken(ls->lex, ls->lex->bufferpos);
       ls->state = STATE_STRING;
       ls->stringtype = 2;
       break;
    case '@': // possibly open heredoc string
-      if(*bufferpos == '"' || *bufferpos == '\'') // look ahead to next character
+      la = lexer_peek(ls->lex); // look ahead to next character
+      if(la == '"' || la == '\'')
       {
          // 6/19/09: keep track of heredoc type by opening delimiter
-         switch(*bufferpos)
+         switch(la)
          {
          case '\'':
             ls->heredoctype = HEREDOC_SINGLE;
@@ -640,22 +715,21 @@ static int lexer_state_none(lexerstate_t *ls)
             ls->heredoctype = HEREDOC_DOUBLE;
             break;
          }
-         ++bufferpos; // move past secondary delimiter character
-         qstr.clear();
+         ++ls->lex->bufferpos; // move past secondary delimiter character
+         lexer_begintoken(ls->lex, ls->lex->bufferpos);
          ls->state = STATE_HEREDOC;
          break;
       }
       // fall through, @ is not special unless followed by " or '
    default:  // anything else is part of an unquoted string
-      if(ls->c == ':' && currentDialect >= CFG_DIALECT_ALFHEIM)
+      if(ls->c == ':' && ls->lex->currentDialect >= CFG_DIALECT_ALFHEIM)
       {
-         mytext = ":";
+         ls->lex->token = ":";
          ret    = ':'; 
       }
       else
       {
-         qstr.clear();
-         qstr += ls->c;
+         lexer_begintoken(ls->lex, ls->lex->bufferpos - 1);
          ls->state = STATE_UNQUOTEDSTRING;
       }
       break;
@@ -686,21 +760,33 @@ static lexfunc_t lexerfuncs[] =
 //
 int mylex(cfg_t *cfg)
 {
+   cfg_lexer_t *lex = cfg->lexer;
    lexerstate_t ls;
    int ret;
 
    ls.state      = STATE_NONE;
    ls.stringtype = 0;
    ls.cfg        = cfg;
+   ls.lex        = cfg->lexer;
 
 include:
-   while((ls.c = *bufferpos++))
+   // input ends at its size, or at a NUL character like it used to
+   while(lex->bufferpos < lex->bufferend && (ls.c = *lex->bufferpos) != '\0')
    {
+      ++lex->bufferpos;
       if(ls.c != '\r') // keep reading on \r's
       {
          if((ret = lexerfuncs[ls.state](&ls)) != -1)
             return ret;
       }
+      else if(!lex->tokencopied &&
+              (ls.state == STATE_STRING || ls.state == STATE_HEREDOC ||
+               (ls.state == STATE_UNQUOTEDSTRING && lexer_peek(lex) != '\n')))
+      {
+         // the \r is left out of the token, which can't be a view anymore,
+         // unless it's at the end of an unquoted string
+         lexer_copytoken(lex, lex->bufferpos - 1);
+      }
    }
 
    // handle special cases at EOF:
@@ -720,28 +806,31 @@ include:
       // EOF after unquoted string or while looking ahead for string
       // literal coalescence -- return the string, next call will 
       // return EOF.
-      --bufferpos;
-      mytext = qstr.c_str();
+      if(ls.state == STATE_UNQUOTEDSTRING)
+         lex->tokenend = lex->bufferpos;
+      lexer_endtoken(lex);
       return CFGT_STR;
 
    default:      
       // EOF handling -- check the include stack
-      if(--include_stack_ptr < 0)
+      if(--lex->include_stack_ptr < 0)
       {
-         lexer_free_buffer();
+         lexer_free_buffer(lex);
          return EOF;
       }      
       else
       {
          // done with an include file      
          free(cfg->filename);
-         lexer_free_buffer();
-         lexbuffer      = include_stack[include_stack_ptr].buffer;
-         bufferpos      = include_stack[include_stack_ptr].pos;
-         cfg->filename  = include_stack[include_stack_ptr].filename;
-         cfg->line      = include_stack[include_stack_ptr].line;
-         cfg->lumpnum   = include_stack[include_stack_ptr].lumpnum;
-         currentDialect = include_stack[include_stack_ptr].dialect;
+         lexer_free_buffer(lex);
+         cfginclude_t &inc = lex->include_stack[lex->include_stack_ptr];
+         lex->lexbuffer      = inc.buffer;
+         lex->bufferpos      = inc.pos;
+         lex->bufferend      = inc.end;
+         cfg->filename       = inc.filename;
+         cfg->line           = inc.line;
+         cfg->lumpnum        = inc.lumpnum;
+         lex->currentDialect = inc.dialect;
 
          ls.state = STATE_NONE; // make sure it's not in an odd state
          goto include; // haleyjd: goto -- kill me now!
@@ -780,28 +869,35 @@ char *cfg_lexer_mustopen(cfg_t *cfg, const char *filename, const Wad *wad, int l
    return ret;
 }
 
-int cfg_lexer_include(cfg_t *cfg, char *buffer, const char *filename, int lumpnum)
+int cfg_lexer_include(cfg_t *cfg, char *buffer, size_t len, const char *filename,
+                      int lumpnum)
 {
-   if(include_stack_ptr >= MAX_INCLUDE_DEPTH)
+   cfg_lexer_t *lex = cfg->lexer;
+
+   if(lex->include_stack_ptr >= MAX_INCLUDE_DEPTH)
    {
       cfg_error(cfg, "Error: includes nested too deeply.\n");
       return 1;
    }
 
    // haleyjd
-   include_stack[include_stack_ptr].filename = cfg->filename;
-   include_stack[include_stack_ptr].line     = cfg->line;
-   include_stack[include_stack_ptr].lumpnum  = cfg->lumpnum;
-   include_stack[include_stack_ptr].buffer   = lexbuffer;
-   include_stack[include_stack_ptr].pos      = bufferpos;
-   include_stack[include_stack_ptr].dialect  = currentDialect;
-   include_stack_ptr++;
+   cfginclude_t &inc = lex->include_stack[lex->include_stack_ptr];
+   inc.filename = cfg->filename;
+   inc.line     = cfg->line;
+   inc.lumpnum  = cfg->lumpnum;
+   inc.buffer   = lex->lexbuffer;
+   inc.pos      = lex->bufferpos;
+   inc.end      = lex->bufferend;
+   inc.dialect  = lex->currentDialect;
+   lex->include_stack_ptr++;
 
    cfg->filename = cfg_tilde_expand(filename);
    cfg->line     = 1;
    cfg->lumpnum  = lumpnum;
 
-   bufferpos = lexbuffer = buffer;
+   lex->lexbuffer = buffer;
+   lex->bufferpos = buffer;
+   lex->bufferend = buffer + len;
 
    return 0;
 }
@@ -823,9 +919,9 @@ int cfg_lexer_source_type(cfg_t *cfg)
 //
 // Change the dialect being used by the lexer.
 //
-void cfg_lexer_set_dialect(cfg_dialect_t dialect)
+void cfg_lexer_set_dialect(cfg_t *cfg, cfg_dialect_t dialect)
 {
-   currentDialect = dialect;
+   cfg->lexer->currentDialect = dialect;
 }
 
 // EOF
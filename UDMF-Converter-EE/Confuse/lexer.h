@@ -25,19 +25,75 @@
 #ifndef LEXER_H__
 #define LEXER_H__
 
-extern const char *mytext; // haleyjd
+#include <string>
+#include <string_view>
+
 class DWFILE;
 class Wad;
 
+// file include stack
+
+#define MAX_INCLUDE_DEPTH 16
+
+struct cfginclude_t
+{
+   char          *filename;
+   int            lumpnum;  // haleyjd
+   unsigned int   line;
+   char          *buffer;   // haleyjd 03/16/08
+   const char    *pos;
+   const char    *end;
+   cfg_dialect_t  dialect;  // haleyjd 09/17/12
+};
+
+//
+// State of the lexer for one cfg_parse call. It used to be kept in globals,
+// which prevented independent cfg_t objects from being parsed concurrently.
+// The root cfg_t and all its sections point to it while parsing.
+//
+struct cfg_lexer_t
+{
+   cfginclude_t include_stack[MAX_INCLUDE_DEPTH] = {};
+   int include_stack_ptr = 0;
+
+   // haleyjd 09/17/12: current parser dialect
+   cfg_dialect_t currentDialect = CFG_DIALECT_DELTA;
+
+   // Current token, equivalent to yytext. It's a view of the input while
+   // possible, and only gets copied into qstr when escape sequences, string
+   // coalescence or carriage returns make it differ from the input.
+   std::string_view token;
+   const char *tokenstart = nullptr; // start of the token in the input
+   const char *tokenend = nullptr;   // end of the token in the input
+   bool tokencopied = false;         // token is being built in qstr
+
+   // haleyjd 07/11/03: dynamic string buffer solution from
+   // libConfuse v2.0; eliminates unsafe, overflowable array
+   std::string qstr;
+   std::string hexchar;
+
+   // haleyjd 12/23/06: if true, unquoted strings can contain spaces
+   // at the moment. Defaults to false.
+   bool unquoted_spaces = false;
+
+   // The input doesn't need to be NUL-terminated. Lumps are read in place,
+   // so only file buffers are owned by the lexer.
+   char *lexbuffer = nullptr;       // current file buffer, if owned
+   const char *bufferpos = nullptr; // position in input
+   const char *bufferend = nullptr; // end of input
+};
+
 int   mylex(cfg_t *cfg);
+const char *lexer_tokentext(cfg_t *cfg);
 int   lexer_init(cfg_t *cfg, DWFILE *);
-void  lexer_reset(void);
-void  lexer_set_unquoted_spaces(bool);
+void  lexer_reset(cfg_t *cfg);
+void  lexer_set_unquoted_spaces(cfg_t *cfg, bool);
 char *cfg_lexer_open(const char *filename, const Wad *wad, int lumpnum, size_t *len);
 char *cfg_lexer_mustopen(cfg_t *cfg, const char *filename, const Wad *wad, int lumpnum, size_t *len);
-int   cfg_lexer_include(cfg_t *cfg, char *buffer, const char *fname, int lumpnum);
+int   cfg_lexer_include(cfg_t *cfg, char *buffer, size_t len, const char *fname,
+                        int lumpnum);
 int   cfg_lexer_source_type(cfg_t *cfg);
-void  cfg_lexer_set_dialect(cfg_dialect_t dialect);
+void  cfg_lexer_set_dialect(cfg_t *cfg, cfg_dialect_t dialect);
 
 #endif
 
@@ -47,7 +47,14 @@ public:
    uint8_t ReadByte();
    int16_t ReadShort()
    {
-      return ReadByte() | ReadByte() << 8;
+      uint8_t low = ReadByte();
+      return static_cast<int16_t>(low | ReadByte() << 8);
+   }
+   int32_t ReadInt()
+   {
+      uint16_t low = static_cast<uint16_t>(ReadShort());
+      uint16_t high = static_cast<uint16_t>(ReadShort());
+      return static_cast<int32_t>(low | static_cast<uint32_t>(high) << 16);
    }
    std::string ReadString(size_t length);
 
@@ -55,6 +62,10 @@ public:
    {
       return mPos >= mDataSize;
    }
+   size_t Remaining() const
+   {
+      return mPos < mDataSize ? mDataSize - mPos : 0;
+   }
 private:
    const uint8_t *mData = nullptr;
    size_t mDataSize = 0;
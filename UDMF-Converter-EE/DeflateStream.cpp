@@ -0,0 +1,92 @@
+//
+// UDMF Converter EE
+// Copyright (C) 2019 Ioan Chera
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/
+//
+// Additional terms and conditions compatible with the GPLv3 apply. See the
+// file COPYING-EE for details.
+//
+// Purpose: Output stream deflating with zlib as it's written to
+// Authors: Ioan Chera
+//
+
+#include "DeflateStream.hpp"
+
+//
+// Starts deflating into the target at the given zlib level
+//
+DeflateBuffer::DeflateBuffer(std::ostream &target, int level) : mTarget(target)
+{
+   mOpen = deflateInit(&mStream, level) == Z_OK;
+   setp(mInput, mInput + sizeof(mInput));
+}
+
+DeflateBuffer::~DeflateBuffer()
+{
+   if(mOpen)
+      deflateEnd(&mStream);
+}
+
+//
+// Compresses the written data and finishes the stream. Returns false if
+// anything failed along the way.
+//
+bool DeflateBuffer::Finish()
+{
+   if(!mOpen)
+      return false;
+   bool result = Deflate(Z_FINISH);
+   deflateEnd(&mStream);
+   mOpen = false;
+   setp(nullptr, nullptr);
+   return result && mTarget.good();
+}
+
+//
+// Compresses the full input buffer to make room for more
+//
+DeflateBuffer::int_type DeflateBuffer::overflow(int_type ch)
+{
+   if(!mOpen || !Deflate(Z_NO_FLUSH))
+      return traits_type::eof();
+   if(!traits_type::eq_int_type(ch, traits_type::eof()))
+   {
+      *pptr() = traits_type::to_char_type(ch);
+      pbump(1);
+   }
+   return traits_type::not_eof(ch);
+}
+
+//
+// Feeds the buffered input to zlib, writing out whatever it makes of it.
+// Empties the input buffer.
+//
+bool DeflateBuffer::Deflate(int flush)
+{
+   mStream.next_in = reinterpret_cast<Bytef *>(pbase());
+   mStream.avail_in = static_cast<uInt>(pptr() - pbase());
+   int status;
+   do
+   {
+      mStream.next_out = reinterpret_cast<Bytef *>(mOutput);
+      mStream.avail_out = sizeof(mOutput);
+      status = deflate(&mStream, flush);
+      if(status == Z_STREAM_ERROR)
+         return false;
+      mTarget.write(mOutput, sizeof(mOutput) - mStream.avail_out);
+   } while(!mStream.avail_out);
+   setp(mInput, mInput + sizeof(mInput));
+   return flush != Z_FINISH || status == Z_STREAM_END;
+}
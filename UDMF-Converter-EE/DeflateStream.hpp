@@ -0,0 +1,78 @@
+//
+// UDMF Converter EE
+// Copyright (C) 2019 Ioan Chera
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/
+//
+// Additional terms and conditions compatible with the GPLv3 apply. See the
+// file COPYING-EE for details.
+//
+// Purpose: Output stream deflating with zlib as it's written to
+// Authors: Ioan Chera
+//
+
+#ifndef DeflateStream_hpp
+#define DeflateStream_hpp
+
+#include <zlib.h>
+#include <ostream>
+#include <streambuf>
+
+//
+// Buffer deflating whatever gets written to it into another stream
+//
+class DeflateBuffer : public std::streambuf
+{
+public:
+   DeflateBuffer(std::ostream &target, int level);
+   ~DeflateBuffer();
+
+   bool Finish();
+
+protected:
+   int_type overflow(int_type ch) override;
+
+private:
+   bool Deflate(int flush);
+
+   std::ostream &mTarget;
+   z_stream mStream = {};
+   bool mOpen = false;
+   char mInput[4096];
+   char mOutput[16384];
+};
+
+//
+// Stream compressing into another one. Finish must be called after the last
+// write, to complete the compressed data.
+//
+class DeflateStream : public std::ostream
+{
+public:
+   DeflateStream(std::ostream &target, int level) : std::ostream(nullptr),
+   mBuffer(target, level)
+   {
+      rdbuf(&mBuffer);
+   }
+
+   bool Finish()
+   {
+      return mBuffer.Finish();
+   }
+
+private:
+   DeflateBuffer mBuffer;
+};
+
+#endif /* DeflateStream_hpp */
@@ -23,8 +23,8 @@
 //
 
 #include <algorithm>
-#include "DataStreamer.hpp"
 #include "DoomLevel.hpp"
+#include "IOHelpers.hpp"
 #include "Wad.hpp"
 
 //
@@ -34,6 +34,9 @@ bool DoomLevel::LoadWad(const Wad &wad, size_t lumpIndex)
 {
    if(lumpIndex + 10 >= wad.Lumps().size())
       return false;
+   for(size_t i = 1; i <= 10; ++i)
+      if(wad.Lumps()[lumpIndex + i].Failed())
+         return false;
    LoadThings(wad.Lumps()[lumpIndex + 1]);
    LoadLinedefs(wad.Lumps()[lumpIndex + 2]);
    LoadSidedefs(wad.Lumps()[lumpIndex + 3]);
@@ -43,7 +46,8 @@ bool DoomLevel::LoadWad(const Wad &wad, size_t lumpIndex)
    LoadSubsectors(wad.Lumps()[lumpIndex + 6]);
    LoadNodes(wad.Lumps()[lumpIndex + 7]);
    LoadSectors(wad.Lumps()[lumpIndex + 8]);
-   mReject = wad.Lumps()[lumpIndex + 9].Data();
+   const Lump &reject = wad.Lumps()[lumpIndex + 9];
+   mReject.assign(reject.Data(), reject.Data() + reject.Size());
    LoadBlockmap(wad.Lumps()[lumpIndex + 10]);
    mWad = &wad;
    return true;
@@ -94,6 +98,8 @@ std::vector<LumpInfo> DoomLevel::FindLevelLumps(const Wad &wad)
       info.lump = &*it;
       info.index = static_cast<int>(it - lumps.begin());
       ret.push_back(info);
+      // Lumps are loaded lazily, so get the whole level now in one pass
+      wad.Prefetch(info.index, 11);
       it += 10;
    }
    return ret;
@@ -110,6 +116,100 @@ int DoomLevel::GetFrontSectorIndex(const Linedef &line) const
    return side->sector >= 0 && side->sector < mSectors.size() ? side->sector : -1;
 }
 
+//
+// Checks whether the loaded nodes, segs and subsectors are complete and only
+// reference existing items. Missing nodes, or ones broken by overflowing the
+// vanilla limits, fail this.
+//
+bool DoomLevel::HasValidNodes() const
+{
+   if(mSegs.empty() || mSubsectors.empty() || (mNodes.empty() && mSubsectors.size() > 1))
+      return false;
+   const size_t numVertices = mVertices.size() + mNodeVertices.size();
+   for(const Seg &seg : mSegs)
+   {
+      if(seg.startVertex < 0 || static_cast<size_t>(seg.startVertex) >= numVertices ||
+         seg.endVertex < 0 || static_cast<size_t>(seg.endVertex) >= numVertices ||
+         seg.linedef < 0 || static_cast<size_t>(seg.linedef) >= mLinedefs.size() ||
+         (seg.dir != 0 && seg.dir != 1))
+      {
+         return false;
+      }
+   }
+   for(const Subsector &subsector : mSubsectors)
+   {
+      if(subsector.segcount <= 0 || subsector.startseg < 0 ||
+         static_cast<size_t>(subsector.startseg) + subsector.segcount > mSegs.size())
+      {
+         return false;
+      }
+   }
+   for(const Node &node : mNodes)
+   {
+      for(int child : { node.rightchild, node.leftchild })
+      {
+         // Children are read signed, so subsector references come negative
+         child &= 0xffff;
+         size_t index = child & 0x7fff;
+         if(child & 0x8000 ? index >= mSubsectors.size() : index >= mNodes.size())
+            return false;
+      }
+   }
+   return true;
+}
+
+//
+// Checks whether the loaded blockmap is complete: every block offset points to
+// a list ending before the lump does. Offsets are taken as unsigned, like the
+// ports do. Missing blockmaps, and ones overflowing the offsets, fail this.
+// Only list starts need to fit in 16 bits, so the last list may run past 64K
+// words.
+//
+bool DoomLevel::HasValidBlockmap() const
+{
+   if(mBlockmap.size() < 4)
+      return false;
+   int columns = mBlockmap[2], rows = mBlockmap[3];
+   if(columns <= 0 || rows <= 0)
+      return false;
+   size_t numBlocks = static_cast<size_t>(columns) * rows;
+   if(mBlockmap.size() < 4 + numBlocks)
+      return false;
+   // Words already found on a list that ends in time. Blocks sharing a list,
+   // or lists sharing an end, then only get walked once.
+   std::vector<bool> checked(mBlockmap.size());
+   for(size_t i = 0; i < numBlocks; ++i)
+   {
+      size_t offset = static_cast<uint16_t>(mBlockmap[4 + i]);
+      if(offset < 4 + numBlocks)
+         return false;
+      for(; offset < mBlockmap.size() && !checked[offset]; ++offset)
+      {
+         checked[offset] = true;
+         if(mBlockmap[offset] == -1)
+            break;
+      }
+      if(offset >= mBlockmap.size())
+         return false;
+   }
+   return true;
+}
+
+//
+// Checks whether the loaded REJECT is worth keeping: sized for the sectors and
+// hiding at least one pair. Ports take an empty one as hiding nothing, which
+// is all a zero-filled one does. Wrongly sized ones were made for another
+// sector list, so their bits can't be trusted.
+//
+bool DoomLevel::HasUsefulReject() const
+{
+   if(mReject.size() != (mSectors.size() * mSectors.size() + 7) / 8)
+      return false;
+   return std::any_of(mReject.begin(), mReject.end(), [](uint8_t bits) {
+      return bits != 0;
+   });
+}
+
 void DoomLevel::GetBounds(int &left, int &bottom, int &right, int &top) const
 {
    left = bottom = INT_MAX;
@@ -130,159 +230,160 @@ void DoomLevel::GetBounds(int &left, int &bottom, int &right, int &top) const
 }
 
 //
-// Loads all things
+// Decodes a lump of fixed-size records. The size is only checked once, so the
+// fields can be read straight from memory. A trailing partial record is
+// ignored.
 //
-void DoomLevel::LoadThings(const Lump &lump)
+template<typename T, typename F>
+static void LoadRecords(const Lump &lump, size_t recordSize, std::vector<T> &items, F decode)
 {
-   mThings.resize(lump.Data().size() / 10);
-   DataStreamer stream(lump.Data());
-   for(Thing &thing : mThings)
+   size_t count = lump.Size() / recordSize;
+   items.resize(count);
+   const uint8_t *data = lump.Data();
+   for(T &item : items)
    {
-      thing.x = stream.ReadShort();
-      thing.y = stream.ReadShort();
-      thing.angle = stream.ReadShort();
-      thing.type = stream.ReadShort();
-      thing.flags = stream.ReadShort();
+      decode(data, item);
+      data += recordSize;
    }
 }
 
+//
+// Loads all things
+//
+void DoomLevel::LoadThings(const Lump &lump)
+{
+   LoadRecords(lump, 10, mThings, [](const uint8_t *data, Thing &thing) {
+      thing.x = ReadShort(data);
+      thing.y = ReadShort(data + 2);
+      thing.angle = ReadShort(data + 4);
+      thing.type = ReadShort(data + 6);
+      thing.flags = ReadShort(data + 8);
+   });
+}
+
 void DoomLevel::LoadLinedefs(const Lump &lump)
 {
-   mLinedefs.resize(lump.Data().size() / 14);
-   DataStreamer stream(lump.Data());
-   for(Linedef &linedef : mLinedefs)
-   {
-      linedef.v1 = stream.ReadShort();
-      linedef.v2 = stream.ReadShort();
-      linedef.flags = stream.ReadShort();
-      linedef.special = stream.ReadShort();
-      linedef.tag = stream.ReadShort();
-      linedef.sidenum[0] = stream.ReadShort();
-      linedef.sidenum[1] = stream.ReadShort();
-   }
+   LoadRecords(lump, 14, mLinedefs, [](const uint8_t *data, Linedef &linedef) {
+      linedef.v1 = ReadShort(data);
+      linedef.v2 = ReadShort(data + 2);
+      linedef.flags = ReadShort(data + 4);
+      linedef.special = ReadShort(data + 6);
+      linedef.tag = ReadShort(data + 8);
+      linedef.sidenum[0] = ReadShort(data + 10);
+      linedef.sidenum[1] = ReadShort(data + 12);
+   });
 }
 
 void DoomLevel::LoadSidedefs(const Lump &lump)
 {
-   mSidedefs.resize(lump.Data().size() / 30);
-   DataStreamer stream(lump.Data());
-   for(Sidedef &sidedef : mSidedefs)
-   {
-      sidedef.xoffset = stream.ReadShort();
-      sidedef.yoffset = stream.ReadShort();
-      sidedef.upperpic = stream.ReadString(8);
-      sidedef.lowerpic = stream.ReadString(8);
-      sidedef.midpic = stream.ReadString(8);
-      sidedef.sector = stream.ReadShort();
-   }
+   LoadRecords(lump, 30, mSidedefs, [](const uint8_t *data, Sidedef &sidedef) {
+      sidedef.xoffset = ReadShort(data);
+      sidedef.yoffset = ReadShort(data + 2);
+      sidedef.upperpic = ReadString(data + 4, 8);
+      sidedef.lowerpic = ReadString(data + 12, 8);
+      sidedef.midpic = ReadString(data + 20, 8);
+      sidedef.sector = ReadShort(data + 28);
+   });
 }
 
 void DoomLevel::LoadVertices(const Lump &lump)
 {
-   mVertices.resize(lump.Data().size() / 4);
-   DataStreamer stream(lump.Data());
-   for(Vertex &vertex : mVertices)
+   LoadRecords(lump, 4, mVertices, [](const uint8_t *data, Vertex &vertex) {
+      vertex.x = ReadShort(data);
+      vertex.y = ReadShort(data + 2);
+   });
+}
+
+//
+// Counts the leading vertices which belong to the editor map: all up to the
+// last one used by a linedef. Node builders append theirs after those.
+//
+size_t DoomLevel::CountEditorVertices(const std::vector<Vertex> &vertices,
+                                      const std::vector<Linedef> &linedefs)
+{
+   size_t count = 0;
+   for(const Linedef &linedef : linedefs)
    {
-      vertex.x = stream.ReadShort();
-      vertex.y = stream.ReadShort();
+      if(linedef.v1 >= 0 && static_cast<size_t>(linedef.v1) >= count)
+         count = linedef.v1 + 1;
+      if(linedef.v2 >= 0 && static_cast<size_t>(linedef.v2) >= count)
+         count = linedef.v2 + 1;
    }
+   return count < vertices.size() ? count : vertices.size();
 }
 
+//
+// Moves the trailing node builder vertices out of mVertices
+//
 void DoomLevel::SeparateSegVertices()
 {
-   if(mVertices.empty())
-      return;
-   size_t index = mVertices.size() - 1;
-   mNodeVertices.reserve(mVertices.size());
-   for(auto it = mVertices.rbegin(); it != mVertices.rend(); ++it, --index)
-   {
-      bool found = false;
-      for(const Linedef &linedef : mLinedefs)
-      {
-         if(linedef.v1 == index || linedef.v2 == index)
-         {
-            found = true;
-            break;
-         }
-      }
-      if(!found)
-      {
-         mNodeVertices.push_back(*it);
-         mVertices.pop_back();
-      }
-   }
-   std::reverse(mNodeVertices.begin(), mNodeVertices.end());
+   size_t count = CountEditorVertices(mVertices, mLinedefs);
+   mNodeVertices.assign(mVertices.begin() + count, mVertices.end());
+   mVertices.resize(count);
 }
 
 void DoomLevel::LoadSegs(const Lump &lump)
 {
-   mSegs.resize(lump.Data().size() / 12);
-   DataStreamer stream(lump.Data());
-   for(Seg &seg : mSegs)
-   {
-      seg.startVertex = stream.ReadShort();
-      seg.endVertex = stream.ReadShort();
-      seg.angle = stream.ReadShort();
-      seg.linedef = stream.ReadShort();
-      seg.dir = stream.ReadShort();
-      seg.offset = stream.ReadShort();
-   }
+   LoadRecords(lump, 12, mSegs, [](const uint8_t *data, Seg &seg) {
+      seg.startVertex = ReadShort(data);
+      seg.endVertex = ReadShort(data + 2);
+      seg.angle = ReadShort(data + 4);
+      seg.linedef = ReadShort(data + 6);
+      seg.dir = ReadShort(data + 8);
+      seg.offset = ReadShort(data + 10);
+   });
 }
 
 void DoomLevel::LoadSubsectors(const Lump &lump)
 {
-   mSegs.resize(lump.Data().size() / 4);
-   DataStreamer stream(lump.Data());
-   for(Subsector &subsector : mSubsectors)
-   {
-      subsector.segcount = stream.ReadShort();
-      subsector.startseg = stream.ReadShort();
-   }
+   LoadRecords(lump, 4, mSubsectors, [](const uint8_t *data, Subsector &subsector) {
+      subsector.segcount = ReadShort(data);
+      subsector.startseg = ReadShort(data + 2);
+   });
 }
 
 void DoomLevel::LoadNodes(const Lump &lump)
 {
-   mNodes.resize(lump.Data().size() / 28);
-   DataStreamer stream(lump.Data());
-   for(Node &node : mNodes)
-   {
-      node.partx = stream.ReadShort();
-      node.party = stream.ReadShort();
-      node.dx = stream.ReadShort();
-      node.dy = stream.ReadShort();
-      node.rightbox[0] = stream.ReadShort();
-      node.rightbox[1] = stream.ReadShort();
-      node.rightbox[2] = stream.ReadShort();
-      node.rightbox[3] = stream.ReadShort();
-      node.leftbox[0] = stream.ReadShort();
-      node.leftbox[1] = stream.ReadShort();
-      node.leftbox[2] = stream.ReadShort();
-      node.leftbox[3] = stream.ReadShort();
-      node.rightchild = stream.ReadShort();
-      node.leftchild = stream.ReadShort();
-   }
+   LoadRecords(lump, 28, mNodes, [](const uint8_t *data, Node &node) {
+      node.partx = ReadShort(data);
+      node.party = ReadShort(data + 2);
+      node.dx = ReadShort(data + 4);
+      node.dy = ReadShort(data + 6);
+      for(int i = 0; i < 4; ++i)
+      {
+         node.rightbox[i] = ReadShort(data + 8 + 2 * i);
+         node.leftbox[i] = ReadShort(data + 16 + 2 * i);
+      }
+      node.rightchild = ReadShort(data + 24);
+      node.leftchild = ReadShort(data + 26);
+   });
 }
 
 void DoomLevel::LoadSectors(const Lump &lump)
 {
-   mSectors.resize(lump.Data().size() / 26);
-   DataStreamer stream(lump.Data());
-   for(Sector &sector : mSectors)
-   {
-      sector.floorheight = stream.ReadShort();
-      sector.ceilingheight = stream.ReadShort();
-      sector.floorpic = stream.ReadString(8);
-      sector.ceilingpic = stream.ReadString(8);
-      sector.lightlevel = stream.ReadShort();
-      sector.special = stream.ReadShort();
-      sector.tag = stream.ReadShort();
-   }
+   LoadRecords(lump, 26, mSectors, [](const uint8_t *data, Sector &sector) {
+      sector.floorheight = ReadShort(data);
+      sector.ceilingheight = ReadShort(data + 2);
+      sector.floorpic = ReadString(data + 4, 8);
+      sector.ceilingpic = ReadString(data + 12, 8);
+      sector.lightlevel = ReadShort(data + 20);
+      sector.special = ReadShort(data + 22);
+      sector.tag = ReadShort(data + 24);
+   });
 }
 
 void DoomLevel::LoadBlockmap(const Lump &lump)
 {
-   mBlockmap.resize(lump.Data().size() / 2);
-   DataStreamer stream(lump.Data());
+   mBlockmap.resize(lump.Size() / 2);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+   // Same layout as in the lump
+   memcpy(mBlockmap.data(), lump.Data(), mBlockmap.size() * sizeof(int16_t));
+#else
+   const uint8_t *data = lump.Data();
    for(int16_t &val : mBlockmap)
-      val = stream.ReadShort();
+   {
+      val = ReadShort(data);
+      data += 2;
+   }
+#endif
 }
@@ -48,6 +48,11 @@ class DoomLevel
 public:
    bool LoadWad(const Wad &wad, size_t lumpIndex);
    static std::vector<LumpInfo> FindLevelLumps(const Wad &wad);
+   static size_t CountEditorVertices(const std::vector<Vertex> &vertices,
+                                     const std::vector<Linedef> &linedefs);
+   bool HasValidNodes() const;
+   bool HasValidBlockmap() const;
+   bool HasUsefulReject() const;
 
    const std::vector<Thing> &GetThings() const
    {
@@ -103,6 +108,11 @@ public:
    {
       return index >= 0 && index < mVertices.size() ? &mVertices[index] : nullptr;
    }
+   bool IsNodeVertex(int index) const
+   {
+      return index >= 0 && static_cast<size_t>(index) >= mVertices.size() &&
+             static_cast<size_t>(index) < mVertices.size() + mNodeVertices.size();
+   }
 
    int IndexOf(const Linedef& line) const
    {
@@ -112,7 +112,6 @@ struct dehflagset_t
 {
    dehflags_t *flaglist;
    int mode;
-   unsigned int results[MAXFLAGFIELDS];
 };
 
 // mapthing flag values and mnemonics
@@ -131,7 +130,7 @@ static dehflags_t mapthingflags[] =
    { NULL,        0 }
 };
 
-static dehflagset_t mt_flagset =
+static const dehflagset_t mt_flagset =
 {
    mapthingflags, // flaglist
    0,             // mode
@@ -160,7 +159,7 @@ static dehflags_t extlineflags[] =
    { NULL,           0                  }
 };
 
-static dehflagset_t ld_flagset =
+static const dehflagset_t ld_flagset =
 {
    extlineflags, // flaglist
    0,            // mode
@@ -193,7 +192,7 @@ static dehflags_t sectorflags[] =
    { NULL,            0                  }
 };
 
-static dehflagset_t sector_flagset =
+static const dehflagset_t sector_flagset =
 {
    sectorflags, // flaglist
    0,           // mode
@@ -209,7 +208,7 @@ static dehflags_t sectordamageflags[] =
    { NULL,         0               }
 };
 
-static dehflagset_t sectordamage_flagset =
+static const dehflagset_t sectordamage_flagset =
 {
    sectordamageflags, // flaglist
    0                  // mode
@@ -228,7 +227,7 @@ static dehflags_t sectorportalflags[] =
    { NULL,           0               }
 };
 
-static dehflagset_t sectorportal_flagset =
+static const dehflagset_t sectorportal_flagset =
 {
    sectorportalflags, // flaglist
    0                  // mode
@@ -452,15 +451,20 @@ static cfg_opt_t ed_opts[] =
 //
 static void OnError(cfg_t *cfg, const char *fmt, va_list ap)
 {
-   vfprintf(stderr, fmt, ap);
+   AppendFormatV(static_cast<MessageLog *>(cfg->errdata)->warnings, fmt, ap);
    throw EXIT_FAILURE;
 }
 
 //
 // Load a lump for ExtraData
 //
-bool ExtraData::LoadLump(const Wad &wad, const char *name)
+bool ExtraData::LoadLump(const Wad &wad, const char *name, MessageLog &log)
 {
+   // cfg_t keeps its values inside the option table, so each parse needs its
+   // own copy of it, otherwise parallel level conversions would share values.
+   cfg_opt_t opts[lengthof(ed_opts)];
+   memcpy(opts, ed_opts, sizeof(opts));
+
    cfg_t *cfg = nullptr;
    try
    {
@@ -468,59 +472,117 @@ bool ExtraData::LoadLump(const Wad &wad, const char *name)
       const Lump *lump = wad.FindLump(name, &index);
       if(!lump)
       {
-         fprintf(stderr, "Couldn't find ExtraData lump %s\n", name);
+         log.Warning("Couldn't find ExtraData lump %s\n", name);
+         Clear();
+         return false;
+      }
+      if(lump->Failed())
+      {
+         log.Warning("Couldn't read ExtraData lump %s\n", name);
          Clear();
          return false;
       }
 
-      cfg = cfg_init(ed_opts, CFGF_NOCASE);
+      cfg = cfg_init(opts, CFGF_NOCASE);
       cfg_set_error_function(cfg, OnError);
+      cfg_set_error_data(cfg, &log);
 
       int result = cfg_parselump(cfg, wad, name, index);
       if(result != CFG_SUCCESS)
       {
-         fprintf(stderr, "Couldn't parse ExtraData lump %s: error %d\n", name, result);
+         log.Warning("Couldn't parse ExtraData lump %s: error %d\n", name, result);
          cfg_free(cfg);
          Clear();
          return false;
       }
 
-      if(!ProcessThings(cfg))
+      if(!ProcessThings(cfg, log))
       {
-         fprintf(stderr, "Couldn't process things from ExtraData %s\n", name);
+         log.Warning("Couldn't process things from ExtraData %s\n", name);
          cfg_free(cfg);
          Clear();
          return false;
       }
 
-      if(!ProcessLines(cfg))
+      if(!ProcessLines(cfg, log))
       {
-         fprintf(stderr, "Couldn't process linedefs from ExtraData %s\n", name);
+         log.Warning("Couldn't process linedefs from ExtraData %s\n", name);
          cfg_free(cfg);
          Clear();
          return false;
       }
 
-      if(!ProcessSectors(cfg))
+      if(!ProcessSectors(cfg, log))
       {
-         fprintf(stderr, "Couldn't process sectors from ExtraData %s\n", name);
+         log.Warning("Couldn't process sectors from ExtraData %s\n", name);
          cfg_free(cfg);
          Clear();
          return false;
       }
 
       cfg_free(cfg);
+      mThings.Freeze();
+      mLines.Freeze();
+      mSectors.Freeze();
       return true;
    }
    catch(int result)
    {
-      fprintf(stderr, "An error occurred, quitting ExtraData processing for %s\n", name);
+      log.Warning("An error occurred, quitting ExtraData processing for %s\n", name);
       cfg_free(cfg);
       Clear();
       return false;
    }
 }
 
+//
+// Gets the ExtraData parsed from the given lump, parsing it if this is the
+// first request. Returns null if it failed loading. If several threads ask
+// for the same lump at once, one parses and the others wait for it. The wad
+// doesn't change, so the lump index tells the content apart. Messages from
+// parsing are kept with the result, and only added to the log if asked, so
+// callers can have them reported once.
+//
+std::shared_ptr<const ExtraData> ExtraDataCache::Get(const char *name, MessageLog &log,
+                                                     bool reportLoad)
+{
+   int index = 0;
+   const Lump *lump = mWad.FindLump(name, &index);
+   if(!lump)
+   {
+      log.Warning("Couldn't find ExtraData lump %s\n", name);
+      return nullptr;
+   }
+   std::promise<Loaded> promise;
+   Entry entry;
+   bool parse = false;
+   {
+      std::lock_guard<std::mutex> lock(mMutex);
+      auto it = mEntries.find(index);
+      if(it == mEntries.end())
+      {
+         entry = promise.get_future().share();
+         mEntries.emplace(index, entry);
+         parse = true;
+      }
+      else
+         entry = it->second;
+   }
+
+   if(parse)
+   {
+      Loaded loaded;
+      auto extraData = std::make_shared<ExtraData>(mThingMapping);
+      if(extraData->LoadLump(mWad, name, loaded.messages))
+         loaded.extraData = extraData;
+      promise.set_value(std::move(loaded));
+   }
+   const Loaded &loaded = entry.get();
+   if(reportLoad)
+      log.Append(loaded.messages);
+   return loaded.extraData;
+}
+
 //
 // From Eternity:
 // Returns the result of strchr called on the string in value.
@@ -528,7 +590,8 @@ bool ExtraData::LoadLump(const Wad &wad, const char *name)
 // prefix written into prefixbuf. If the return value is NULL,
 // prefixbuf is unmodified.
 //
-static const char *ExtractPrefix(const char *value, char *prefixbuf, int buflen)
+static const char *ExtractPrefix(const char *value, char *prefixbuf, int buflen,
+                                 MessageLog &log)
 {
    const char *colonloc = strchr(value, ':');
    if(!colonloc)
@@ -545,7 +608,7 @@ static const char *ExtractPrefix(const char *value, char *prefixbuf, int buflen)
    // check validity of the string value location (could be end)
    if(!(*strval))
    {
-      fprintf(stderr, "ExtractPrefix: invalid prefix:value %s\n", value);
+      log.Warning("ExtractPrefix: invalid prefix:value %s\n", value);
       throw EXIT_FAILURE;  // dunno what else to do, just kill it off
    }
    return colonloc;
@@ -556,13 +619,13 @@ static const char *ExtractPrefix(const char *value, char *prefixbuf, int buflen)
 // Parses thing type fields in ExtraData. Allows resolving of
 // EDF thingtype mnemonics to their corresponding doomednums.
 //
-int ExtraData::ParseTypeField(const char *value) const
+int ExtraData::ParseTypeField(const char *value, MessageLog &log) const
 {
    char *numpos = nullptr;
    long num = strtol(value, &numpos, 0);
 
    char prefix[16] = {};
-   const char *colonloc = ExtractPrefix(value, prefix, sizeof(prefix));
+   const char *colonloc = ExtractPrefix(value, prefix, sizeof(prefix), log);
    if(colonloc || (numpos && *numpos))
    {
       const char *strval;
@@ -574,7 +637,7 @@ int ExtraData::ParseTypeField(const char *value) const
       int type = mThingMapping[strval];
       if(type <= 0)
       {
-         fprintf(stderr, "Unknown thing type %s\n", strval);
+         log.Warning("Unknown thing type %s\n", strval);
          return 0;
       }
       return type;
@@ -589,11 +652,11 @@ int ExtraData::ParseTypeField(const char *value) const
 //
 // davidph 01/14/14: split from deh_ParseFlags
 //
-static dehflags_t *deh_ParseFlag(dehflagset_t &flagset, const char *name)
+static const dehflags_t *deh_ParseFlag(const dehflagset_t &flagset, const char *name)
 {
    int mode = flagset.mode;
 
-   for(dehflags_t *flag = flagset.flaglist; flag->name; ++flag)
+   for(const dehflags_t *flag = flagset.flaglist; flag->name; ++flag)
    {
       if(!strcasecmp(name, flag->name) &&
          (flag->index == mode || mode == DEHFLAGS_MODE_ALL))
@@ -608,19 +671,19 @@ static dehflags_t *deh_ParseFlag(dehflagset_t &flagset, const char *name)
 // deh_ParseFlags
 // Purpose: Handle thing flag fields in a general manner
 // Args:    flagset -- pointer to a dehflagset_t object
-//          strval  -- ptr-to-ptr to string containing flags
-//                     Note: MUST be a mutable string pointer!
+//          str     -- string containing flags
+//          results -- array of MAXFLAGFIELDS values
 // Returns: Nothing. Results for each parsing mode are written
-//          into the corresponding index of the results array
-//          within the flagset object.
+//          into the corresponding index of the results array.
 //
 // haleyjd 11/03/02: generalized from code that was previously below
 // haleyjd 04/10/03: made global for use in EDF and ExtraData
 // haleyjd 02/19/04: rewrote for combined flags support
 //
-static void deh_ParseFlags(dehflagset_t &flagset, char **strval)
+static void deh_ParseFlags(const dehflagset_t &flagset, const char *str,
+                           unsigned int *results, MessageLog &log)
 {
-   unsigned int *results  = flagset.results;  // pointer to results array
+   static const char delimiters[] = ",+| \t\f\r";
 
    // haleyjd: init all results to zero
    memset(results, 0, MAXFLAGFIELDS * sizeof(*results));
@@ -629,15 +692,22 @@ static void deh_ParseFlags(dehflagset_t &flagset, char **strval)
    // Fix error-handling case ('found' var wasn't being reset)
    //
    // Use OR logic instead of addition, to allow repetition
+   //
+   // The string is split without strtok, which keeps hidden state and would
+   // not allow ExtraData lumps to be parsed from several threads.
 
-   for(;(*strval = strtok(*strval, ",+| \t\f\r")); *strval = NULL)
+   for(str += strspn(str, delimiters); *str; str += strspn(str, delimiters))
    {
-      dehflags_t *flag = deh_ParseFlag(flagset, *strval);
+      size_t length = strcspn(str, delimiters);
+      std::string name(str, length);
+      str += length;
+
+      const dehflags_t *flag = deh_ParseFlag(flagset, name.c_str());
 
       if(flag)
          results[flag->index] |= flag->value;
       else
-         fprintf(stderr, "Could not find flag %s\n", *strval);
+         log.Warning("Could not find flag %s\n", name.c_str());
    }
 }
 
@@ -645,66 +715,100 @@ static void deh_ParseFlags(dehflagset_t &flagset, char **strval)
 // Parses EDF syntax flags
 // From Eternity
 //
-static unsigned ParseFlags(const char *str, dehflagset_t &flagset)
+static unsigned ParseFlags(const char *str, const dehflagset_t &flagset,
+                           MessageLog &log)
 {
-   char *buffer, *bufptr;
-   bufptr = buffer = strdup(str);
-   deh_ParseFlags(flagset, &bufptr);
-   free(buffer);
-   return flagset.results[0];
+   unsigned int results[MAXFLAGFIELDS];
+   deh_ParseFlags(flagset, str, results, log);
+   return results[0];
+}
+
+//
+// Field getters by handles, which are resolved once from the first record of a
+// kind and then used for all of them, instead of looking up names each time
+//
+static int GetInt(cfg_t *sec, cfg_handle_t field)
+{
+   return cfg_opt_getnint(cfg_getopthandle(sec, field), 0);
+}
+static double GetFloat(cfg_t *sec, cfg_handle_t field)
+{
+   return cfg_opt_getnfloat(cfg_getopthandle(sec, field), 0);
+}
+static const char *GetString(cfg_t *sec, cfg_handle_t field)
+{
+   return cfg_opt_getnstr(cfg_getopthandle(sec, field), 0);
+}
+static unsigned GetSize(cfg_t *sec, cfg_handle_t field)
+{
+   cfg_opt_t *opt = cfg_getopthandle(sec, field);
+   return opt ? opt->nvalues : 0;
 }
 
 //
 // Parse ExtraData thing args
 //
-static void ParseArgs(int *args, int numArgs, cfg_t *sec, const char *fieldName)
+static void ParseArgs(int *args, int numArgs, cfg_t *sec, cfg_handle_t field)
 {
-   unsigned numargs = cfg_size(sec, fieldName);
+   cfg_opt_t *opt = cfg_getopthandle(sec, field);
+   unsigned numargs = opt ? opt->nvalues : 0;
    memset(args, 0, sizeof(int) * numArgs);
    for(unsigned i = 0; i < numargs && i < numArgs; ++i)
-      args[i] = cfg_getnint(sec, fieldName, i);
+      args[i] = cfg_opt_getnint(opt, i);
 }
 
 //
 // Load things
 //
-bool ExtraData::ProcessThings(cfg_t *cfg)
+bool ExtraData::ProcessThings(cfg_t *cfg, MessageLog &log)
 {
-   unsigned size = cfg_size(cfg, SEC_MAPTHING);
+   cfg_opt_t *sections = cfg_getopt(cfg, SEC_MAPTHING);
+   unsigned size = sections ? sections->nvalues : 0;
+   if(!size)
+      return true;
+   cfg_t *first = cfg_opt_getnsec(sections, 0);
+   const cfg_handle_t fieldNum = cfg_gethandle(first, FIELD_NUM);
+   const cfg_handle_t fieldType = cfg_gethandle(first, FIELD_TYPE);
+   const cfg_handle_t fieldOptions = cfg_gethandle(first, FIELD_OPTIONS);
+   const cfg_handle_t fieldTID = cfg_gethandle(first, FIELD_TID);
+   const cfg_handle_t fieldArgs = cfg_gethandle(first, FIELD_ARGS);
+   const cfg_handle_t fieldHeight = cfg_gethandle(first, FIELD_HEIGHT);
+   const cfg_handle_t fieldSpecial = cfg_gethandle(first, FIELD_SPECIAL);
    for(unsigned i = 0; i < size; ++i)
    {
-      cfg_t *thingsec = cfg_getnsec(cfg, SEC_MAPTHING, i);
-      int recordnum = cfg_getint(thingsec, FIELD_NUM);
-      if(mThings.find(recordnum) != mThings.end())
+      cfg_t *thingsec = cfg_opt_getnsec(sections, i);
+      int recordnum = GetInt(thingsec, fieldNum);
+      EDThing *thingRecord = mThings.Add(recordnum);
+      if(!thingRecord)
       {
-         fprintf(stderr, "Error: duplicate mapthing recordnum %d\n", recordnum);
+         log.Warning("Error: duplicate mapthing recordnum %d\n", recordnum);
          return false;
       }
 
-      EDThing &thing = mThings[recordnum];
-      const char *name = cfg_getstr(thingsec, FIELD_TYPE);
-      thing.type = ParseTypeField(name);
+      EDThing &thing = *thingRecord;
+      const char *name = GetString(thingsec, fieldType);
+      thing.type = ParseTypeField(name, log);
       if(thing.type == kExtraDataDoomednum)
          thing.type = 0;   // just remove it
       if(!thing.type)   // don't waste time processing zero-type things
       {
-         fprintf(stderr, "Warning: mapthing recordnum %d has invalid type\n", recordnum);
-         mThings.erase(recordnum);
+         log.Warning("Warning: mapthing recordnum %d has invalid type\n", recordnum);
+         mThings.Remove(recordnum);
          continue;
       }
-      const char *opts = cfg_getstr(thingsec, FIELD_OPTIONS);
+      const char *opts = GetString(thingsec, fieldOptions);
       if(!*opts)
          thing.options = 0;
       else
-         thing.options = ParseFlags(opts, mt_flagset);
+         thing.options = ParseFlags(opts, mt_flagset, log);
 
-      thing.tid = cfg_getint(thingsec, FIELD_TID);
+      thing.tid = GetInt(thingsec, fieldTID);
       if(thing.tid < 0)
          thing.tid = 0;
 
-      ParseArgs(thing.args, lengthof(thing.args), thingsec, FIELD_ARGS);
-      thing.height = cfg_getint(thingsec, FIELD_HEIGHT);
-      thing.special = cfg_getint(thingsec, FIELD_SPECIAL);
+      ParseArgs(thing.args, lengthof(thing.args), thingsec, fieldArgs);
+      thing.height = GetInt(thingsec, fieldHeight);
+      thing.special = GetInt(thingsec, fieldSpecial);
 
    }
    return true;
@@ -713,42 +817,55 @@ bool ExtraData::ProcessThings(cfg_t *cfg)
 //
 // Processes ExtraData linedefs
 //
-bool ExtraData::ProcessLines(cfg_t *cfg)
+bool ExtraData::ProcessLines(cfg_t *cfg, MessageLog &log)
 {
-   unsigned size = cfg_size(cfg, SEC_LINEDEF);
+   cfg_opt_t *sections = cfg_getopt(cfg, SEC_LINEDEF);
+   unsigned size = sections ? sections->nvalues : 0;
+   if(!size)
+      return true;
+   cfg_t *first = cfg_opt_getnsec(sections, 0);
+   const cfg_handle_t fieldNum = cfg_gethandle(first, FIELD_LINE_NUM);
+   const cfg_handle_t fieldSpecial = cfg_gethandle(first, FIELD_LINE_SPECIAL);
+   const cfg_handle_t fieldTag = cfg_gethandle(first, FIELD_LINE_TAG);
+   const cfg_handle_t fieldExtFlags = cfg_gethandle(first, FIELD_LINE_EXTFLAGS);
+   const cfg_handle_t fieldArgs = cfg_gethandle(first, FIELD_LINE_ARGS);
+   const cfg_handle_t fieldID = cfg_gethandle(first, FIELD_LINE_ID);
+   const cfg_handle_t fieldAlpha = cfg_gethandle(first, FIELD_LINE_ALPHA);
+   const cfg_handle_t fieldPortalID = cfg_gethandle(first, FIELD_LINE_PORTALID);
    for(unsigned i = 0; i < size; ++i)
    {
-      cfg_t *linesec = cfg_getnsec(cfg, SEC_LINEDEF, i);
-      int recordnum = cfg_getint(linesec, FIELD_LINE_NUM);
-      if(mLines.find(recordnum) != mLines.end())
+      cfg_t *linesec = cfg_opt_getnsec(sections, i);
+      int recordnum = GetInt(linesec, fieldNum);
+      EDLine *lineRecord = mLines.Add(recordnum);
+      if(!lineRecord)
       {
-         fprintf(stderr, "Error: duplicate linedef recordnum %d\n", recordnum);
+         log.Warning("Error: duplicate linedef recordnum %d\n", recordnum);
          return false;
       }
 
-      EDLine &line = mLines[recordnum];
-      line.special = cfg_getint(linesec, FIELD_LINE_SPECIAL);
-      line.tag = cfg_getint(linesec, FIELD_LINE_TAG);
-      bool tagset = cfg_size(linesec, FIELD_LINE_TAG) > 0;
+      EDLine &line = *lineRecord;
+      line.special = GetInt(linesec, fieldSpecial);
+      line.tag = GetInt(linesec, fieldTag);
+      bool tagset = GetSize(linesec, fieldTag) > 0;
 
-      const char *flags = cfg_getstr(linesec, FIELD_LINE_EXTFLAGS);
+      const char *flags = GetString(linesec, fieldExtFlags);
       if(!*flags)
          line.extflags = 0;
       else
-         line.extflags = ParseFlags(flags, ld_flagset);
+         line.extflags = ParseFlags(flags, ld_flagset, log);
 
-      ParseArgs(line.args, lengthof(line.args), linesec, FIELD_LINE_ARGS);
+      ParseArgs(line.args, lengthof(line.args), linesec, fieldArgs);
 
       if(!tagset)
-         line.tag = cfg_getint(linesec, FIELD_LINE_ID);
+         line.tag = GetInt(linesec, fieldID);
 
-      line.alpha = cfg_getfloat(linesec, FIELD_LINE_ALPHA);
+      line.alpha = GetFloat(linesec, fieldAlpha);
       if(line.alpha < 0)
          line.alpha = 0;
       else if(line.alpha > 1)
          line.alpha = 1;
 
-      line.portalid = cfg_getint(linesec, FIELD_LINE_PORTALID);
+      line.portalid = GetInt(linesec, fieldPortalID);
    }
 
    return true;
@@ -784,102 +901,138 @@ static double NormalizeFlatAngle(double input)
 //
 // Process ExtraData sectors
 //
-bool ExtraData::ProcessSectors(cfg_t *cfg)
+bool ExtraData::ProcessSectors(cfg_t *cfg, MessageLog &log)
 {
-   unsigned size = cfg_size(cfg, SEC_SECTOR);
+   cfg_opt_t *sections = cfg_getopt(cfg, SEC_SECTOR);
+   unsigned size = sections ? sections->nvalues : 0;
+   if(!size)
+      return true;
+   cfg_t *first = cfg_opt_getnsec(sections, 0);
+   const cfg_handle_t fieldNum = cfg_gethandle(first, FIELD_SECTOR_NUM);
+   const cfg_handle_t fieldFlags = cfg_gethandle(first, FIELD_SECTOR_FLAGS);
+   const cfg_handle_t fieldFlagsAdd = cfg_gethandle(first, FIELD_SECTOR_FLAGSADD);
+   const cfg_handle_t fieldFlagsRemove = cfg_gethandle(first, FIELD_SECTOR_FLAGSREM);
+   const cfg_handle_t fieldDamage = cfg_gethandle(first, FIELD_SECTOR_DAMAGE);
+   const cfg_handle_t fieldDamageMask = cfg_gethandle(first, FIELD_SECTOR_DAMAGEMASK);
+   const cfg_handle_t fieldDamageMod = cfg_gethandle(first, FIELD_SECTOR_DAMAGEMOD);
+   const cfg_handle_t fieldDamageFlags = cfg_gethandle(first, FIELD_SECTOR_DAMAGEFLAGS);
+   const cfg_handle_t fieldDamageFlagsAdd = cfg_gethandle(first, FIELD_SECTOR_DMGFLAGSADD);
+   const cfg_handle_t fieldDamageFlagsRemove = cfg_gethandle(first, FIELD_SECTOR_DMGFLAGSREM);
+   const cfg_handle_t fieldFloorOffsetX = cfg_gethandle(first, FIELD_SECTOR_FLOOROFFSETX);
+   const cfg_handle_t fieldFloorOffsetY = cfg_gethandle(first, FIELD_SECTOR_FLOOROFFSETY);
+   const cfg_handle_t fieldCeilingOffsetX = cfg_gethandle(first, FIELD_SECTOR_CEILINGOFFSETX);
+   const cfg_handle_t fieldCeilingOffsetY = cfg_gethandle(first, FIELD_SECTOR_CEILINGOFFSETY);
+   const cfg_handle_t fieldFloorScaleX = cfg_gethandle(first, FIELD_SECTOR_FLOORSCALEX);
+   const cfg_handle_t fieldFloorScaleY = cfg_gethandle(first, FIELD_SECTOR_FLOORSCALEY);
+   const cfg_handle_t fieldCeilingScaleX = cfg_gethandle(first, FIELD_SECTOR_CEILINGSCALEX);
+   const cfg_handle_t fieldCeilingScaleY = cfg_gethandle(first, FIELD_SECTOR_CEILINGSCALEY);
+   const cfg_handle_t fieldFloorAngle = cfg_gethandle(first, FIELD_SECTOR_FLOORANGLE);
+   const cfg_handle_t fieldCeilingAngle = cfg_gethandle(first, FIELD_SECTOR_CEILINGANGLE);
+   const cfg_handle_t fieldTopMap = cfg_gethandle(first, FIELD_SECTOR_TOPMAP);
+   const cfg_handle_t fieldMidMap = cfg_gethandle(first, FIELD_SECTOR_MIDMAP);
+   const cfg_handle_t fieldBottomMap = cfg_gethandle(first, FIELD_SECTOR_BOTTOMMAP);
+   const cfg_handle_t fieldFloorTerrain = cfg_gethandle(first, FIELD_SECTOR_FLOORTERRAIN);
+   const cfg_handle_t fieldCeilingTerrain = cfg_gethandle(first, FIELD_SECTOR_CEILINGTERRAIN);
+   const cfg_handle_t fieldPortalFlagsFloor = cfg_gethandle(first, FIELD_SECTOR_PORTALFLAGS_F);
+   const cfg_handle_t fieldPortalFlagsCeiling = cfg_gethandle(first, FIELD_SECTOR_PORTALFLAGS_C);
+   const cfg_handle_t fieldOverlayAlphaFloor = cfg_gethandle(first, FIELD_SECTOR_OVERLAYALPHA_F);
+   const cfg_handle_t fieldOverlayAlphaCeiling = cfg_gethandle(first, FIELD_SECTOR_OVERLAYALPHA_C);
+   const cfg_handle_t fieldPortalIDFloor = cfg_gethandle(first, FIELD_SECTOR_PORTALID_F);
+   const cfg_handle_t fieldPortalIDCeiling = cfg_gethandle(first, FIELD_SECTOR_PORTALID_C);
    for(unsigned i = 0; i < size; ++i)
    {
-      cfg_t *section = cfg_getnsec(cfg, SEC_SECTOR, i);
-      int recordnum = cfg_getint(section, FIELD_SECTOR_NUM);
-      if(mSectors.find(recordnum) != mSectors.end())
+      cfg_t *section = cfg_opt_getnsec(sections, i);
+      int recordnum = GetInt(section, fieldNum);
+      EDSector *sectorRecord = mSectors.Add(recordnum);
+      if(!sectorRecord)
       {
-         fprintf(stderr, "Error: duplicate sector recordnum %d\n", recordnum);
+         log.Warning("Error: duplicate sector recordnum %d\n", recordnum);
          return false;
       }
 
-      EDSector &sector = mSectors[recordnum];
-      const char *flags = cfg_getstr(section, FIELD_SECTOR_FLAGS);
+      EDSector &sector = *sectorRecord;
+      const char *flags = GetString(section, fieldFlags);
       if(*flags)
       {
          sector.hasflags = true;
-         sector.flags = ParseFlags(flags, sector_flagset);
+         sector.flags = ParseFlags(flags, sector_flagset, log);
       }
 
-      flags = cfg_getstr(section, FIELD_SECTOR_FLAGSADD);
+      flags = GetString(section, fieldFlagsAdd);
       if(*flags)
-         sector.flagsadd = ParseFlags(flags, sector_flagset);
+         sector.flagsadd = ParseFlags(flags, sector_flagset, log);
 
-      flags = cfg_getstr(section, FIELD_SECTOR_FLAGSREM);
+      flags = GetString(section, fieldFlagsRemove);
       if(*flags)
-         sector.flagsrem = ParseFlags(flags, sector_flagset);
+         sector.flagsrem = ParseFlags(flags, sector_flagset, log);
 
-      sector.damage = cfg_getint(section, FIELD_SECTOR_DAMAGE);
-      sector.damagemask = cfg_getint(section, FIELD_SECTOR_DAMAGEMASK);
+      sector.damage = GetInt(section, fieldDamage);
+      sector.damagemask = GetInt(section, fieldDamageMask);
 
-      sector.damagetype = cfg_getstr(section, FIELD_SECTOR_DAMAGEMOD);
+      sector.damagetype = GetString(section, fieldDamageMod);
 
-      flags = cfg_getstr(section, FIELD_SECTOR_DAMAGEFLAGS);
+      flags = GetString(section, fieldDamageFlags);
       if(*flags)
       {
          sector.hasdamageflags = true;
-         sector.damageflags = ParseFlags(flags, sectordamage_flagset);
+         sector.damageflags = ParseFlags(flags, sectordamage_flagset, log);
       }
 
-      flags = cfg_getstr(section, FIELD_SECTOR_DMGFLAGSADD);
+      flags = GetString(section, fieldDamageFlagsAdd);
       if(*flags)
-         sector.damageflagsadd = ParseFlags(flags, sectordamage_flagset);
-      flags = cfg_getstr(section, FIELD_SECTOR_DMGFLAGSREM);
+         sector.damageflagsadd = ParseFlags(flags, sectordamage_flagset, log);
+      flags = GetString(section, fieldDamageFlagsRemove);
       if(*flags)
-         sector.damageflagsrem = ParseFlags(flags, sectordamage_flagset);
+         sector.damageflagsrem = ParseFlags(flags, sectordamage_flagset, log);
 
-      sector.floor_xoffs = cfg_getfloat(section, FIELD_SECTOR_FLOOROFFSETX);
-      sector.floor_yoffs = cfg_getfloat(section, FIELD_SECTOR_FLOOROFFSETY);
-      sector.ceiling_xoffs = cfg_getfloat(section, FIELD_SECTOR_CEILINGOFFSETX);
-      sector.ceiling_yoffs = cfg_getfloat(section, FIELD_SECTOR_CEILINGOFFSETY);
+      sector.floor_xoffs = GetFloat(section, fieldFloorOffsetX);
+      sector.floor_yoffs = GetFloat(section, fieldFloorOffsetY);
+      sector.ceiling_xoffs = GetFloat(section, fieldCeilingOffsetX);
+      sector.ceiling_yoffs = GetFloat(section, fieldCeilingOffsetY);
 
-      sector.floor_xscale = cfg_getfloat(section, FIELD_SECTOR_FLOORSCALEX);
-      sector.floor_yscale = cfg_getfloat(section, FIELD_SECTOR_FLOORSCALEY);
-      sector.ceiling_xscale = cfg_getfloat(section, FIELD_SECTOR_CEILINGSCALEX);
-      sector.ceiling_yscale = cfg_getfloat(section, FIELD_SECTOR_CEILINGSCALEY);
+      sector.floor_xscale = GetFloat(section, fieldFloorScaleX);
+      sector.floor_yscale = GetFloat(section, fieldFloorScaleY);
+      sector.ceiling_xscale = GetFloat(section, fieldCeilingScaleX);
+      sector.ceiling_yscale = GetFloat(section, fieldCeilingScaleY);
 
-      sector.floorangle = NormalizeFlatAngle(cfg_getfloat(section, FIELD_SECTOR_FLOORANGLE));
-      sector.ceilingangle = NormalizeFlatAngle(cfg_getfloat(section, FIELD_SECTOR_CEILINGANGLE));
+      sector.floorangle = NormalizeFlatAngle(GetFloat(section, fieldFloorAngle));
+      sector.ceilingangle = NormalizeFlatAngle(GetFloat(section, fieldCeilingAngle));
 
-      sector.topmap = cfg_getstr(section, FIELD_SECTOR_TOPMAP);
-      sector.midmap = cfg_getstr(section, FIELD_SECTOR_MIDMAP);
-      sector.bottommap = cfg_getstr(section, FIELD_SECTOR_BOTTOMMAP);
+      sector.topmap = GetString(section, fieldTopMap);
+      sector.midmap = GetString(section, fieldMidMap);
+      sector.bottommap = GetString(section, fieldBottomMap);
 
-      sector.floorterrain = cfg_getstr(section, FIELD_SECTOR_FLOORTERRAIN);
-      sector.ceilingterrain = cfg_getstr(section, FIELD_SECTOR_CEILINGTERRAIN);
+      sector.floorterrain = GetString(section, fieldFloorTerrain);
+      sector.ceilingterrain = GetString(section, fieldCeilingTerrain);
 
-      flags = cfg_getstr(section, FIELD_SECTOR_PORTALFLAGS_F);
+      flags = GetString(section, fieldPortalFlagsFloor);
       if(*flags)
-         sector.f_pflags = ParseFlags(flags, sectorportal_flagset);
-      flags = cfg_getstr(section, FIELD_SECTOR_PORTALFLAGS_C);
+         sector.f_pflags = ParseFlags(flags, sectorportal_flagset, log);
+      flags = GetString(section, fieldPortalFlagsCeiling);
       if(*flags)
-         sector.c_pflags = ParseFlags(flags, sectorportal_flagset);
+         sector.c_pflags = ParseFlags(flags, sectorportal_flagset, log);
 
-      sector.f_alpha = cfg_getint(section, FIELD_SECTOR_OVERLAYALPHA_F);
+      sector.f_alpha = GetInt(section, fieldOverlayAlphaFloor);
       if(sector.f_alpha < 0)
          sector.f_alpha = 0;
       else if(sector.f_alpha > 255)
          sector.f_alpha = 255;
 
-      sector.c_alpha = cfg_getint(section, FIELD_SECTOR_OVERLAYALPHA_C);
+      sector.c_alpha = GetInt(section, fieldOverlayAlphaCeiling);
       if(sector.c_alpha < 0)
          sector.c_alpha = 0;
       else if(sector.c_alpha > 255)
          sector.c_alpha = 255;
 
-      sector.f_portalid = cfg_getint(section, FIELD_SECTOR_PORTALID_F);
-      sector.c_portalid = cfg_getint(section, FIELD_SECTOR_PORTALID_C);
+      sector.f_portalid = GetInt(section, fieldPortalIDFloor);
+      sector.c_portalid = GetInt(section, fieldPortalIDCeiling);
    }
    return true;
 }
 
 void ExtraData::Clear()
 {
-   mThings.clear();
-   mLines.clear();
-   mSectors.clear();
+   mThings.Clear();
+   mLines.Clear();
+   mSectors.Clear();
 }
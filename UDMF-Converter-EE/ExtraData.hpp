@@ -25,8 +25,16 @@
 #ifndef ExtraData_hpp
 #define ExtraData_hpp
 
+#include <stdint.h>
+#include <algorithm>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
+#include "Helpers.hpp"
 
 class ThingMapping;
 class Wad;
@@ -216,7 +224,98 @@ struct EDSector
 };
 
 //
-// Holds ExtraData stuff
+// ExtraData records by recordnum. They're collected in a hash table while
+// loading, then frozen into a vector sorted by recordnum. Recordnums are
+// usually small and dense, so lookups then go through a direct index, unless
+// the recordnums are too spread out, when a binary search is used instead.
+//
+template<typename T>
+class RecordTable
+{
+public:
+   //
+   // Adds a new record while loading. Returns null if recordnum exists.
+   //
+   T *Add(int recordnum)
+   {
+      auto result = mPending.emplace(recordnum, T());
+      return result.second ? &result.first->second : nullptr;
+   }
+
+   void Remove(int recordnum)
+   {
+      mPending.erase(recordnum);
+   }
+
+   size_t Size() const
+   {
+      return mNumbers.size();
+   }
+
+   //
+   // Builds the lookup tables. No more records can be added after this.
+   //
+   void Freeze()
+   {
+      mNumbers.clear();
+      mNumbers.reserve(mPending.size());
+      for(const auto &item : mPending)
+         mNumbers.push_back(item.first);
+      std::sort(mNumbers.begin(), mNumbers.end());
+
+      mRecords.clear();
+      mRecords.reserve(mNumbers.size());
+      for(int recordnum : mNumbers)
+         mRecords.push_back(std::move(mPending[recordnum]));
+      mPending.clear();
+
+      mSlots.clear();
+      if(mNumbers.empty())
+         return;
+      mBase = mNumbers.front();
+      int64_t range = static_cast<int64_t>(mNumbers.back()) - mBase + 1;
+      if(range > 4 * static_cast<int64_t>(mNumbers.size()) + 256)
+         return;  // too sparse
+      mSlots.assign(static_cast<size_t>(range), -1);
+      for(size_t i = 0; i < mNumbers.size(); ++i)
+         mSlots[mNumbers[i] - mBase] = static_cast<int>(i);
+   }
+
+   const T *Get(int recordnum) const
+   {
+      if(!mSlots.empty())
+      {
+         int64_t slot = static_cast<int64_t>(recordnum) - mBase;
+         if(slot < 0 || slot >= static_cast<int64_t>(mSlots.size()))
+            return nullptr;
+         int index = mSlots[static_cast<size_t>(slot)];
+         return index >= 0 ? &mRecords[index] : nullptr;
+      }
+      auto it = std::lower_bound(mNumbers.begin(), mNumbers.end(), recordnum);
+      if(it == mNumbers.end() || *it != recordnum)
+         return nullptr;
+      return &mRecords[it - mNumbers.begin()];
+   }
+
+   void Clear()
+   {
+      mPending.clear();
+      mNumbers.clear();
+      mRecords.clear();
+      mSlots.clear();
+   }
+
+private:
+   std::unordered_map<int, T> mPending;   // records still being loaded
+   std::vector<int> mNumbers;             // sorted recordnums
+   std::vector<T> mRecords;               // records matching mNumbers
+   std::vector<int> mSlots;               // recordnum - mBase to mRecords index
+   int mBase = 0;
+};
+
+//
+// Holds ExtraData stuff. It doesn't change after loading, so it can be shared
+// between threads.
 //
 class ExtraData
 {
@@ -225,43 +324,70 @@ public:
    {
    }
 
-   bool LoadLump(const Wad &wad, const char *name);
+   bool LoadLump(const Wad &wad, const char *name, MessageLog &log);
    const EDThing *GetThing(int recordnum) const
    {
-      return Get(mThings, recordnum);
+      return mThings.Get(recordnum);
    }
    const EDLine *GetLine(int recordnum) const
    {
-      return Get(mLines, recordnum);
+      return mLines.Get(recordnum);
    }
    const EDSector *GetSector(int recordnum) const
    {
-      return Get(mSectors, recordnum);
+      return mSectors.Get(recordnum);
+   }
+   size_t NumRecords() const
+   {
+      return mThings.Size() + mLines.Size() + mSectors.Size();
    }
 
 private:
-   bool ProcessThings(cfg_t *cfg);
-   bool ProcessLines(cfg_t *cfg);
-   bool ProcessSectors(cfg_t *cfg);
+   bool ProcessThings(cfg_t *cfg, MessageLog &log);
+   bool ProcessLines(cfg_t *cfg, MessageLog &log);
+   bool ProcessSectors(cfg_t *cfg, MessageLog &log);
 
    void Clear();
 
-   template<typename T>
-   const T *Get(const std::unordered_map<int, T> &map, int recordnum) const
+   int ParseTypeField(const char *value, MessageLog &log) const;
+
+   const ThingMapping &mThingMapping;
+
+   RecordTable<EDThing> mThings;
+   RecordTable<EDLine> mLines;
+   RecordTable<EDSector> mSectors;
+};
+
+//
+// Parses each ExtraData lump only once and shares the result between all the
+// levels using it. Safe to use from several threads at once.
+//
+class ExtraDataCache
+{
+public:
+   ExtraDataCache(const Wad &wad, const ThingMapping &thingMapping) :
+   mWad(wad), mThingMapping(thingMapping)
    {
-      auto it = map.find(recordnum);
-      if(it != map.end())
-         return &it->second;
-      return nullptr;
    }
 
-   int ParseTypeField(const char *value) const;
+   std::shared_ptr<const ExtraData> Get(const char *name, MessageLog &log, bool reportLoad);
+
+private:
+   //
+   // Parse result, with the messages it made
+   //
+   struct Loaded
+   {
+      std::shared_ptr<const ExtraData> extraData;   // null if it failed
+      MessageLog messages;
+   };
+   typedef std::shared_future<Loaded> Entry;
 
+   const Wad &mWad;
    const ThingMapping &mThingMapping;
 
-   std::unordered_map<int, EDThing> mThings;
-   std::unordered_map<int, EDLine> mLines;
-   std::unordered_map<int, EDSector> mSectors;
+   std::mutex mMutex;
+   std::map<int, Entry> mEntries;   // keyed by lump index
 };
 
 #endif /* ExtraData_hpp */
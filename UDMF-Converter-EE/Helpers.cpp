@@ -22,6 +22,8 @@
 // Authors: Ioan Chera
 //
 
+#include <stdarg.h>
+#include <stdio.h>
 #include "Helpers.hpp"
 
 std::string LowerCase(const char *string)
@@ -60,6 +62,16 @@ void MakeUpperCase(std::string &string)
       c = toupper(c);
 }
 
+bool EqualNoCase(std::string_view string1, std::string_view string2)
+{
+   if(string1.length() != string2.length())
+      return false;
+   for(size_t i = 0; i < string1.length(); ++i)
+      if(tolower(string1[i]) != tolower(string2[i]))
+         return false;
+   return true;
+}
+
 std::string Escape(const std::string &string)
 {
    std::string ret;
@@ -72,3 +84,54 @@ std::string Escape(const std::string &string)
    }
    return ret;
 }
+
+//
+// Adds printf-style formatted text to the end of a string
+//
+void AppendFormat(std::string &text, const char *format, ...)
+{
+   va_list ap;
+   va_start(ap, format);
+   AppendFormatV(text, format, ap);
+   va_end(ap);
+}
+
+void AppendFormatV(std::string &text, const char *format, va_list ap)
+{
+   va_list copy;
+   va_copy(copy, ap);
+   int length = vsnprintf(nullptr, 0, format, copy);
+   va_end(copy);
+   if(length > 0)
+   {
+      size_t start = text.size();
+      text.resize(start + length + 1);
+      vsnprintf(&text[start], length + 1, format, ap);
+      text.resize(start + length);
+   }
+}
+
+void MessageLog::Progress(const char *format, ...)
+{
+   va_list ap;
+   va_start(ap, format);
+   AppendFormatV(progress, format, ap);
+   va_end(ap);
+}
+
+void MessageLog::Warning(const char *format, ...)
+{
+   va_list ap;
+   va_start(ap, format);
+   AppendFormatV(warnings, format, ap);
+   va_end(ap);
+}
+
+//
+// Adds the messages of another log after these
+//
+void MessageLog::Append(const MessageLog &other)
+{
+   progress += other.progress;
+   warnings += other.warnings;
+}
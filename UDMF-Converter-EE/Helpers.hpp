@@ -25,16 +25,42 @@
 #ifndef Helpers_hpp
 #define Helpers_hpp
 
+#include <stdarg.h>
 #include <string>
+#include <string_view>
 
 #define lengthof(x) (sizeof(x) / sizeof(*(x)))
 
+// Lets the compiler check printf-style arguments
+#ifdef __GNUC__
+#define PRINTF_FORMAT(index, first) __attribute__((format(printf, index, first)))
+#else
+#define PRINTF_FORMAT(index, first)
+#endif
+
 std::string LowerCase(const char *string);
 void MakeLowerCase(std::string &string);
 std::string UpperCase(const char *string);
 void MakeUpperCase(std::string &string);
+bool EqualNoCase(std::string_view string1, std::string_view string2);
 
 std::string Escape(const std::string &string);
+void AppendFormat(std::string &text, const char *format, ...) PRINTF_FORMAT(2, 3);
+void AppendFormatV(std::string &text, const char *format, va_list ap);
+
+//
+// Messages kept to be printed later, so that those of work done at once on
+// several threads don't get mixed
+//
+struct MessageLog
+{
+   std::string progress;   // for stdout
+   std::string warnings;   // for stderr
+
+   void Progress(const char *format, ...) PRINTF_FORMAT(2, 3);
+   void Warning(const char *format, ...) PRINTF_FORMAT(2, 3);
+   void Append(const MessageLog &other);
+};
 
 template<typename T>
 inline static bool NullOrEmpty(const T *vector)
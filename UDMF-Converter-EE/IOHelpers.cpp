@@ -29,7 +29,7 @@ bool ReadInt(std::istream &is, int &number)
    char n[4];
    if(!is.read(n, 4))
       return false;
-   number = n[0] | n[1] << 8 | n[2] << 16 | n[3] << 24;
+   number = ReadInt(reinterpret_cast<const uint8_t *>(n));
    return true;
 }
 
@@ -26,11 +26,37 @@
 #define IOHelpers_hpp
 
 #include <stdint.h>
+#include <string.h>
 #include <istream>
 #include <ostream>
+#include <string>
+#include <vector>
 
 bool ReadInt(std::istream &is, int &number);
 
+//
+// Little-endian decoders from memory known to be large enough. Meant for bulk
+// decoding of records after checking the size once.
+//
+inline int16_t ReadShort(const uint8_t *data)
+{
+   return static_cast<int16_t>(data[0] | data[1] << 8);
+}
+inline int ReadInt(const uint8_t *data)
+{
+   return static_cast<int>(data[0] | data[1] << 8 | data[2] << 16 |
+                           static_cast<uint32_t>(data[3]) << 24);
+}
+
+//
+// Gets a fixed-length string field, which may not be null-terminated
+//
+inline std::string ReadString(const uint8_t *data, size_t length)
+{
+   const char *text = reinterpret_cast<const char *>(data);
+   return std::string(text, strnlen(text, length));
+}
+
 void WriteInt(intptr_t number, std::ostream &os);
 void WriteShort(intptr_t number, std::ostream &os);
 
@@ -0,0 +1,225 @@
+//
+// UDMF Converter EE
+// Copyright (C) 2019 Ioan Chera
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/
+//
+// Additional terms and conditions compatible with the GPLv3 apply. See the
+// file COPYING-EE for details.
+//
+// Purpose: Conversion of one level to UDMF
+// Authors: Ioan Chera
+//
+
+#include <algorithm>
+#include <memory>
+#include <sstream>
+#include "BlockmapBuilder.hpp"
+#include "DoomLevel.hpp"
+#include "ExtraData.hpp"
+#include "Helpers.hpp"
+#include "LevelConverter.hpp"
+#include "NodeBuilder.hpp"
+#include "NodeReader.hpp"
+#include "RejectBuilder.hpp"
+#include "Stats.hpp"
+#include "TextmapWriter.hpp"
+#include "ThingMapping.hpp"
+#include "UDMFItems.hpp"
+#include "Wad.hpp"
+
+//
+// Converts a level to UDMF lumps
+//
+ConvertedLevel ConvertLevel(const Wad &wad, const LumpInfo &info,
+                            const ThingMapping &thingnames,
+                            ExtraDataCache &extraDataCache,
+                            const std::string &extraDataName,
+                            bool reportExtraDataLoad,
+                            const ConvertOptions &options, RunStats *stats)
+{
+   ConvertedLevel converted;
+   std::vector<Lump> &lumps = converted.lumps;
+   const char *name = info.lump->Name();
+   std::shared_ptr<const ExtraData> extraData;
+   if(!extraDataName.empty())
+   {
+      StageTimer timer(stats, Stage::extraData);
+      extraData = extraDataCache.Get(extraDataName.c_str(), converted.messages,
+                                     reportExtraDataLoad);
+      if(!extraData)
+      {
+         converted.messages.Warning("Warning: failed loading ExtraData %s for %s\n",
+                                    extraDataName.c_str(), name);
+      }
+      else
+         timer.Count(0, extraData->NumRecords());
+   }
+   if(!extraData)
+      extraData = std::make_shared<ExtraData>(thingnames);
+
+   DoomLevel level;
+   uint64_t levelItems = 0;
+   {
+      StageTimer timer(stats, Stage::levelLoad);
+      if(!level.LoadWad(wad, info.index))
+      {
+         const size_t end = std::min<size_t>(info.index + 11, wad.Lumps().size());
+         for(size_t i = info.index + 1; i < end; ++i)
+         {
+            const Lump &lump = wad.Lumps()[i];
+            if(lump.Failed())
+               converted.messages.Warning("Failed reading lump %s of %s\n", lump.Name(), name);
+         }
+         converted.messages.Warning("Failed loading level %s\n", name);
+         return converted;
+      }
+      uint64_t bytes = 0;
+      for(int i = 1; i <= 10; ++i)
+         bytes += wad.Lumps()[info.index + i].Size();
+      levelItems = level.GetThings().size() + level.GetLinedefs().size() +
+      level.GetSidedefs().size() + level.GetVertices().size() +
+      level.GetSectors().size();
+      timer.Count(bytes, levelItems);
+   }
+   converted.messages.Progress("Loaded level %s\n", name);
+
+   // Now we have both the level and its ExtraData loaded. Let's see how we convert it now
+   std::unique_ptr<UDMFLevel> udmfLevel;
+   {
+      StageTimer timer(stats, Stage::udmfBuild);
+      udmfLevel.reset(new UDMFLevel(level, *extraData, converted.messages));
+      timer.Count(0, levelItems);
+   }
+
+   // Create the new level lumps
+   lumps.emplace_back(name);  // marker
+   {
+      StageTimer timer(stats, Stage::textmap);
+      TextmapWriter textmap;
+      textmap << *udmfLevel;
+      lumps.emplace_back("TEXTMAP", textmap.Release());
+      timer.Count(lumps.back().Size(), 1);
+   }
+   // Use the GL or extended nodes shipped with the level if there are any.
+   // Otherwise build nodes if asked to or if the level's own can't be used.
+   std::unique_ptr<GLNodes> glNodes;
+   if(!options.buildNodes)
+   {
+      StageTimer timer(stats, Stage::nodeRead);
+      glNodes.reset(new GLNodes);
+      std::string format;
+      if(ReadGLNodes(wad, info, level, *glNodes, format, converted.messages))
+      {
+         converted.messages.Progress("Using %s nodes of %s\n", format.c_str(), name);
+         timer.Count(0, glNodes->segs.size());
+      }
+      else
+         glNodes.reset();
+   }
+   if(!glNodes && (options.buildNodes || !level.HasValidNodes()))
+   {
+      StageTimer timer(stats, Stage::nodeBuild);
+      glNodes.reset(new GLNodes);
+      if(BuildGLNodes(level, options.pool, *glNodes))
+         timer.Count(0, glNodes->segs.size());
+      else
+      {
+         converted.messages.Warning("Warning: failed building nodes for %s\n", name);
+         glNodes.reset();
+      }
+   }
+   {
+      StageTimer timer(stats, Stage::znodes);
+      std::ostringstream oss;
+      auto writeNodes = [&glNodes, &level, &oss](int compression) {
+         if(glNodes)
+            WriteZNodes(*glNodes, oss, compression);
+         else
+            WriteZNodes(level, oss, compression);
+      };
+      writeNodes(options.nodeCompression);
+      // A half-written ZGL3 lump would break the level, so fall back to XGL3
+      if(!oss && options.nodeCompression != ZNodesUncompressed)
+      {
+         converted.messages.Warning("Warning: failed compressing the nodes of %s, "
+                                    "writing them uncompressed\n", name);
+         oss.clear();
+         oss.str(std::string());
+         writeNodes(ZNodesUncompressed);
+      }
+      lumps.emplace_back("ZNODES", oss.str());
+      timer.Count(lumps.back().Size(), glNodes ? glNodes->nodes.size() :
+                  level.GetNodes().size());
+   }
+   // Also add reject and blockmap. REJECT can't tell what's seen through
+   // portals, so it's not built for levels with them.
+   bool buildReject = options.buildReject;
+   if(buildReject && udmfLevel->HasPortals())
+   {
+      converted.messages.Warning("Warning: %s has portals, so its REJECT isn't "
+                                 "built\n", name);
+      buildReject = false;
+   }
+   if(buildReject)
+   {
+      StageTimer timer(stats, Stage::reject);
+      std::vector<uint8_t> reject;
+      RejectInfo rejectInfo;
+      if(BuildReject(level, options.pool, reject, rejectInfo))
+      {
+         converted.messages.Progress("Built REJECT for %s: %zu of %zu sector pairs "
+                                     "hidden, %zu bytes\n", name, rejectInfo.hiddenPairs,
+                                     rejectInfo.sectors * rejectInfo.sectors, rejectInfo.size);
+         if(rejectInfo.givenUp)
+         {
+            converted.messages.Warning("Warning: %s has %zu sectors with too many "
+                                       "sight lines to follow, which are assumed to "
+                                       "see all they're joined to\n", name,
+                                       rejectInfo.givenUp);
+         }
+      }
+      lumps.emplace_back("REJECT", std::move(reject));
+      timer.Count(lumps.back().Size(), rejectInfo.sectors);
+   }
+   else if(level.HasUsefulReject())
+      lumps.emplace_back("REJECT", level.GetReject());
+   else
+      lumps.emplace_back("REJECT");  // zero-filled or wrongly sized ones do nothing
+   if(options.buildBlockmap || options.compressBlockmap || !level.HasValidBlockmap())
+   {
+      StageTimer timer(stats, Stage::blockmap);
+      std::vector<int16_t> blockmap;
+      BlockmapInfo blockmapInfo;
+      if(BuildBlockmap(level, options.pool, options.compressBlockmap, blockmap,
+                       blockmapInfo))
+      {
+         converted.messages.Progress("Built blockmap for %s: %dx%d blocks, %zu used, "
+                                     "%zu lists, %zu bytes\n", name, blockmapInfo.columns,
+                                     blockmapInfo.rows, blockmapInfo.usedBlocks, blockmapInfo.lists,
+                                     blockmapInfo.size);
+      }
+      else
+      {
+         converted.messages.Warning("Warning: blockmap of %s doesn't fit, leaving it "
+                                    "for the port to build\n", name);
+      }
+      lumps.emplace_back("BLOCKMAP", blockmap);
+      timer.Count(lumps.back().Size(), blockmapInfo.lists);
+   }
+   else
+      lumps.emplace_back("BLOCKMAP", level.GetBlockmap());
+   lumps.emplace_back("ENDMAP");
+   return converted;
+}
@@ -0,0 +1,78 @@
+//
+// UDMF Converter EE
+// Copyright (C) 2019 Ioan Chera
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/
+//
+// Additional terms and conditions compatible with the GPLv3 apply. See the
+// file COPYING-EE for details.
+//
+// Purpose: Conversion of one level to UDMF
+// Authors: Ioan Chera
+//
+
+#ifndef LevelConverter_hpp
+#define LevelConverter_hpp
+
+#include <string>
+#include <vector>
+#include "Helpers.hpp"
+#include "Lump.hpp"
+#include "ZNodes.hpp"
+
+class ExtraDataCache;
+class ThingMapping;
+class ThreadPool;
+class Wad;
+struct LumpInfo;
+struct RunStats;
+
+//
+// Settings for converting levels
+//
+struct ConvertOptions
+{
+   bool buildNodes = false;         // build GL nodes even if the level has valid ones
+   bool buildBlockmap = false;      // build the blockmap even if the level has a valid one
+   bool compressBlockmap = false;   // share identical block lists when building
+   bool buildReject = false;        // build REJECT from line of sight
+   int nodeCompression = ZNodesUncompressed; // zlib level for ZGL3 nodes
+   ThreadPool *pool = nullptr;      // for work within a level, if given
+};
+
+//
+// Converted level. Messages about it are kept to be printed when it's written,
+// so that those of levels converted at once don't get mixed.
+//
+struct ConvertedLevel
+{
+   std::vector<Lump> lumps;
+   MessageLog messages;
+};
+
+//
+// Converts a level to UDMF lumps. Returns no lumps if the level can't be
+// loaded. Safe to call from several threads at once. Nothing gets printed:
+// all messages are returned with the level. Those from parsing its ExtraData
+// are only included if asked, so levels sharing it can report them once.
+// Stats, if given, get the stage timings.
+//
+ConvertedLevel ConvertLevel(const Wad &wad, const LumpInfo &info,
+                            const ThingMapping &thingnames,
+                            ExtraDataCache &extraDataCache,
+                            const std::string &extraDataName,
+                            bool reportExtraDataLoad,
+                            const ConvertOptions &options, RunStats *stats);
+
+#endif /* LevelConverter_hpp */
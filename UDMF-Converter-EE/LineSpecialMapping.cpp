@@ -22,7 +22,7 @@
 // Authors: Ioan Chera
 //
 
-#include <unordered_map>
+#include <stdint.h>
 #include "LineSpecialMapping.hpp"
 #include "Helpers.hpp"
 
@@ -296,524 +296,858 @@ enum ClassicSpecial
    WRStartLineScript = 280,
 };
 
-static std::unordered_map<int, UdmfSpecialTarget> gMapping;
-static std::unordered_map<std::string, UdmfSpecial> gEDMapping;
+//
+// Classic special to UDMF table, indexed by the special number and filled in
+// at compile time
+//
+class LineMappingTable
+{
+public:
+   constexpr LineMappingTable();
+
+   const UdmfSpecialTarget *Get(int special) const
+   {
+      if(special < 0 || special >= NumSpecials || !mDefined[special])
+         return nullptr;
+      return &mTargets[special];
+   }
+
+private:
+   static const int NumSpecials = EV_STATIC_PORTAL_HORIZON_LINE + 1;
+
+   constexpr UdmfSpecialTarget &operator[](int special)
+   {
+      mDefined[special] = true;
+      return mTargets[special];
+   }
+
+   UdmfSpecialTarget mTargets[NumSpecials] = {};
+   bool mDefined[NumSpecials] = {};
+};
 
 //
 // Initializes line mapping
 //
-void InitLineMapping()
+constexpr LineMappingTable::LineMappingTable()
+{
+   LineMappingTable &map = *this;
+   map[D1DoorBlazeOpen] = {Door_Open, {0, 64, 0, 0, 0}, PlayerUses | NoTag, &LinedefConversion::SetLightTag};
+   map[D1OpenDoorBlue] = {Door_LockedRaise, {0, 16, 0, EV_LOCKDEF_BLUE, 0}, PlayerUses | NoTag, &LinedefConversion::SetLightTag};
+   map[D1OpenDoorRed] = {Door_LockedRaise, {0, 16, 0, EV_LOCKDEF_REDGREEN, 0}, PlayerUses | NoTag, &LinedefConversion::SetLightTag};
+   map[D1OpenDoorYellow] = {Door_LockedRaise, {0, 16, 0, EV_LOCKDEF_YELLOW, 0}, PlayerUses | NoTag, &LinedefConversion::SetLightTag};
+   map[D1OpenDoor] = {Door_Open, {0, 16, 0, 0, 0}, PlayerUses | NoTag, &LinedefConversion::SetLightTag};
+   map[DRDoorBlazeRaise] = {Door_Raise, {0, 64, 150, 0, 0}, PlayerUses | Repeatable | NoTag, &LinedefConversion::SetLightTag};
+   map[DRRaiseDoorBlue] = {Door_LockedRaise, {0, 16, 150, EV_LOCKDEF_BLUE, 0}, PlayerUses | Repeatable | NoTag, &LinedefConversion::SetLightTag};
+   map[DRRaiseDoorRed] = {Door_LockedRaise, {0, 16, 150, EV_LOCKDEF_REDGREEN, 0}, PlayerUses | Repeatable | NoTag, &LinedefConversion::SetLightTag};
+   map[DRRaiseDoorYellow] = {Door_LockedRaise, {0, 16, 150, EV_LOCKDEF_YELLOW, 0}, PlayerUses | Repeatable | NoTag, &LinedefConversion::SetLightTag};
+   map[DRRaiseDoor] = {Door_Raise, {0, 16, 150, 0, 0}, PlayerUses | MonsterUses | Repeatable | NoTag, &LinedefConversion::SetLightTag};
+   map[G1ExitLevel] = {Exit_Normal, {0, 0, 0, 0, 0}, PlayerShoots | NoTag};
+   map[G1PlatRaiseNearestChange] = {Plat_RaiseAndStayTx0, {0, 4, 0, 0, 0}, PlayerShoots};
+   map[G1RaiseFloor] = {Floor_RaiseToLowestCeiling, {0, 8, 0, 0, 0}, PlayerShoots};
+   map[G1SecretExit] = {Exit_Secret, {0, 0, 0, 0, 0}, PlayerShoots | NoTag};
+   map[G1StartLineScript] = {ACS_Execute, {0, 0, 0, 0, 0}, PlayerShoots};
+   map[GROpenDoor] = {Door_Open, {0, 16, 0, 0, 0}, PlayerShoots | MonsterShoots | Repeatable};
+   map[GRStartLineScript] = {ACS_Execute, {0, 0, 0, 0, 0}, PlayerShoots | Repeatable};
+   map[S1BOOMRaiseCeilingOrLowerFloor] = {FloorAndCeiling_LowerRaise, {0, 8, 8, 1998, 0}, PlayerUses};
+   map[S1BuildStairsTurbo16] = {Stairs_BuildUpDoom, {0, 32, 16, 0, 0}, PlayerUses};
+   map[S1BuildStairsUp8] = {Stairs_BuildUpDoom, {0, 2, 8, 0, 0}, PlayerUses};
+   map[S1CeilingCrushAndRaise] = {Ceiling_CrushAndRaiseDist, {0, 8, 8, 10, 0}, PlayerUses};
+   map[S1CeilingCrushStop] = {Ceiling_CrushStop, {0, 0, 0, 0, 0}, PlayerUses};
+   map[S1CeilingLowerAndCrush] = {Ceiling_LowerToFloor, {0, 8, 0, 0, 8}, PlayerUses};
+   map[S1CeilingLowerToFloor] = {Ceiling_LowerToFloor, {0, 8, 0, 0, 0}, PlayerUses};
+   map[S1CeilingLowerToLowest] = {Ceiling_LowerToLowest, {0, 8, 0, 0, 0}, PlayerUses};
+   map[S1CeilingLowerToMaxFloor] = {Ceiling_LowerToHighestFloor, {0, 8, 0, 0, 0}, PlayerUses};
+   map[S1ChangeOnlyNumeric] = {Floor_TransferNumeric, {0, 0, 0, 0, 0}, PlayerUses};
+   map[S1ChangeOnly] = {Floor_TransferTrigger, {0, 0, 0, 0, 0}, PlayerUses};
+   map[S1CloseDoor30] = {Door_CloseWaitOpen, {0, 16, 240, 0, 0}, PlayerUses};
+   map[S1CloseDoor] = {Door_Close, {0, 16, 0, 0, 0}, PlayerUses};
+   map[S1DoDonut] = {Floor_Donut, {0, 4, 4, 0, 0}, PlayerUses};
+   map[S1DoorBlazeClose] = {Door_Close, {0, 64, 0, 0, 0}, PlayerUses};
+   map[S1DoorBlazeOpenBlue] = {Door_LockedRaise, {0, 64, 0, EV_LOCKDEF_BLUE, 0}, PlayerUses};
+   map[S1DoorBlazeOpenRed] = {Door_LockedRaise, {0, 64, 0, EV_LOCKDEF_REDGREEN, 0}, PlayerUses};
+   map[S1DoorBlazeOpenYellow] = {Door_LockedRaise, {0, 64, 0, EV_LOCKDEF_YELLOW, 0}, PlayerUses};
+   map[S1DoorBlazeOpen] = {Door_Open, {0, 64, 0, 0, 0}, PlayerUses};
+   map[S1DoorBlazeRaise] = {Door_Raise, {0, 64, 150, 0, 0}, PlayerUses};
+   map[S1ElevatorCurrent] = {Elevator_MoveToFloor, {0, 32, 0, 0, 0}, PlayerUses};
+   map[S1ElevatorDown] = {Elevator_LowerToNearest, {0, 32, 0, 0, 0}, PlayerUses};
+   map[S1ElevatorUp] = {Elevator_RaiseToNearest, {0, 32, 0, 0, 0}, PlayerUses};
+   map[S1ExitLevel] = {Exit_Normal, {0, 0, 0, 0, 0}, PlayerUses | NoTag};
+   map[S1FastCeilCrushRaise] = {Ceiling_CrushAndRaiseDist, {0, 8, 16, 10, 0}, PlayerUses};
+   map[S1FloorLowerAndChange] = {Floor_LowerToLowest, {0, 8, 6, 0, 0}, PlayerUses};
+   map[S1FloorLowerToLowest] = {Floor_LowerToLowest, {0, 8, 0, 0, 0}, PlayerUses};
+   map[S1FloorLowerToNearest] = {Floor_LowerToNearest, {0, 8, 0, 0, 0}, PlayerUses};
+   map[S1FloorRaiseCrush] = {Floor_RaiseToLowestCeiling, {0, 8, 0, 10, 8}, PlayerUses};
+   map[S1FloorRaiseToNearest] = {Floor_RaiseToNearest, {0, 8, 0, 0, 0}, PlayerUses};
+   map[S1FloorRaiseToTexture] = {Floor_RaiseByTexture, {0, 8, 0, 0, 0}, PlayerUses};
+   map[S1LightTurnOn255] = {Light_ChangeToValue, {0, 255, 0, 0, 0}, PlayerUses};
+   map[S1LightTurnOn] = {Light_MaxNeighbor, {0, 0, 0, 0, 0}, PlayerUses};
+   map[S1LightsVeryDark] = {Light_ChangeToValue, {0, 35, 0, 0, 0}, PlayerUses};
+   map[S1LowerFloorTurbo] = {Floor_LowerToHighest, {0, 32, 136, 0, 0}, PlayerUses};
+   map[S1LowerFloor] = {Floor_LowerToHighestEE, {0, 8, 0, 0, 0}, PlayerUses};
+   map[S1OpenDoor] = {Door_Open, {0, 16, 0, 0, 0}, PlayerUses};
+   map[S1PlatBlazeDWUS] = {Plat_DownWaitUpStayLip, {0, 64, 105, 0, 0}, PlayerUses};
+   map[S1PlatDownWaitUpStay] = {Plat_DownWaitUpStayLip, {0, 32, 105, 0, 0}, PlayerUses};
+   map[S1PlatPerpetualRaise] = {Plat_PerpetualRaiseLip, {0, 8, 105, 0, 0}, PlayerUses};
+   map[S1PlatRaise24Change] = {Plat_UpByValueStayTx, {0, 4, 3, 0, 0}, PlayerUses};
+   map[S1PlatRaise32Change] = {Plat_UpByValueStayTx, {0, 4, 4, 0, 0}, PlayerUses};
+   map[S1PlatRaiseNearestChange] = {Plat_RaiseAndStayTx0, {0, 4, 0, 0, 0}, PlayerUses};
+   map[S1PlatStop] = {Plat_Stop, {0, 0, 0, 0, 0}, PlayerUses};
+   map[S1RaiseDoor] = {Door_Raise, {0, 16, 150, 0, 0}, PlayerUses};
+   map[S1RaiseFloor24Change] = {Floor_RaiseByValue, {0, 8, 24, 5, 0}, PlayerUses};
+   map[S1RaiseFloor24] = {Floor_RaiseByValue, {0, 8, 24, 0, 0}, PlayerUses};
+   map[S1RaiseFloor512] = {Floor_RaiseByValue, {0, 8, 512, 0, 0}, PlayerUses};
+   map[S1RaiseFloorTurbo] = {Floor_RaiseToNearest, {0, 32, 0, 0, 0}, PlayerUses};
+   map[S1RaiseFloor] = {Floor_RaiseToLowestCeiling, {0, 8, 0, 0, 0}, PlayerUses};
+   map[S1SecretExit] = {Exit_Secret, {0, 0, 0, 0, 0}, PlayerUses | NoTag};
+   map[S1SilentCrushAndRaise] = {Ceiling_CrushAndRaiseSilentDist, {0, 8, 8, 10, 0}, PlayerUses};
+   map[S1SilentTeleport] = {Teleport_NoFog, {0, 2, 0, 1, 0}, PlayerUses | MonsterUses | TagThird};
+   map[S1StartLightStrobing] = {Light_StrobeDoom, {0, 5, 35, 0, 0}, PlayerUses};
+   map[S1StartLineScript] = {ACS_Execute, {0, 0, 0, 0, 0}, PlayerUses};
+   map[S1Teleport] = {Teleport, {0, 0, 0, 0, 0}, PlayerUses | MonsterUses | TagSecond};
+   map[S1TurnTagLightsOff] = {Light_MinNeighbor, {0, 0, 0, 0, 0}, PlayerCrosses};
+   map[SRBOOMRaiseCeilingOrLowerFloor] = {FloorAndCeiling_LowerRaise, {0, 8, 8, 1998, 0}, PlayerUses | Repeatable};
+   map[SRBuildStairsTurbo16] = {Stairs_BuildUpDoom, {0, 32, 16, 0, 0}, PlayerUses | Repeatable};
+   map[SRBuildStairsUp8] = {Stairs_BuildUpDoom, {0, 2, 8, 0, 0}, PlayerUses | Repeatable};
+   map[SRCeilingCrushAndRaise] = {Ceiling_CrushAndRaiseDist, {0, 8, 8, 10, 0}, PlayerUses | Repeatable};
+   map[SRCeilingCrushStop] = {Ceiling_CrushStop, {0, 0, 0, 0, 0}, PlayerUses | Repeatable};
+   map[SRCeilingLowerAndCrush] = {Ceiling_LowerToFloor, {0, 8, 0, 0, 8}, PlayerUses | Repeatable};
+   map[SRCeilingLowerToFloor] = {Ceiling_LowerToFloor, {0, 8, 0, 0, 0}, PlayerUses | Repeatable};
+   map[SRCeilingLowerToLowest] = {Ceiling_LowerToLowest, {0, 8, 0, 0, 0}, PlayerUses | Repeatable};
+   map[SRCeilingLowerToMaxFloor] = {Ceiling_LowerToHighestFloor, {0, 8, 0, 0, 0}, PlayerUses | Repeatable};
+   map[SRChangeOnlyNumeric] = {Floor_TransferNumeric, {0, 0, 0, 0, 0}, PlayerUses | Repeatable};
+   map[SRChangeOnly] = {Floor_TransferTrigger, {0, 0, 0, 0, 0}, PlayerUses | Repeatable};
+   map[SRCloseDoor30] = {Door_CloseWaitOpen, {0, 16, 240, 0, 0}, PlayerUses | Repeatable};
+   map[SRCloseDoor] = {Door_Close, {0, 16, 0, 0, 0}, PlayerUses | Repeatable};
+   map[SRDoDonut] = {Floor_Donut, {0, 4, 4, 0, 0}, PlayerUses | Repeatable};
+   map[SRDoorBlazeClose] = {Door_Close, {0, 64, 0, 0, 0}, PlayerUses | Repeatable};
+   map[SRDoorBlazeOpenBlue] = {Door_LockedRaise, {0, 64, 0, EV_LOCKDEF_BLUE, 0}, PlayerUses | Repeatable};
+   map[SRDoorBlazeOpenRed] = {Door_LockedRaise, {0, 64, 0, EV_LOCKDEF_REDGREEN, 0}, PlayerUses | Repeatable};
+   map[SRDoorBlazeOpenYellow] = {Door_LockedRaise, {0, 64, 0, EV_LOCKDEF_YELLOW, 0}, PlayerUses | Repeatable};
+   map[SRDoorBlazeOpen] = {Door_Open, {0, 64, 0, 0, 0}, PlayerUses | Repeatable};
+   map[SRDoorBlazeRaise] = {Door_Raise, {0, 64, 150, 0, 0}, PlayerUses | Repeatable};
+   map[SRElevatorCurrent] = {Elevator_MoveToFloor, {0, 32, 0, 0, 0}, PlayerUses | Repeatable};
+   map[SRElevatorDown] = {Elevator_LowerToNearest, {0, 32, 0, 0, 0}, PlayerUses | Repeatable};
+   map[SRElevatorUp] = {Elevator_RaiseToNearest, {0, 32, 0, 0, 0}, PlayerUses | Repeatable};
+   map[SRFastCeilCrushRaise] = {Ceiling_CrushAndRaiseDist, {0, 8, 16, 10, 0}, PlayerUses | Repeatable};
+   map[SRFloorLowerAndChange] = {Floor_LowerToLowest, {0, 8, 6, 0, 0}, PlayerUses | Repeatable};
+   map[SRFloorLowerToLowest] = {Floor_LowerToLowest, {0, 8, 0, 0, 0}, PlayerUses | Repeatable};
+   map[SRFloorLowerToNearest] = {Floor_LowerToNearest, {0, 8, 0, 0, 0}, PlayerUses | Repeatable};
+   map[SRFloorRaiseCrush] = {Floor_RaiseToLowestCeiling, {0, 8, 0, 10, 8}, PlayerUses | Repeatable};
+   map[SRFloorRaiseToNearest] = {Floor_RaiseToNearest, {0, 8, 0, 0, 0}, PlayerUses | Repeatable};
+   map[SRFloorRaiseToTexture] = {Floor_RaiseByTexture, {0, 8, 0, 0, 0}, PlayerUses | Repeatable};
+   map[SRLightTurnOn255] = {Light_ChangeToValue, {0, 255, 0, 0, 0}, PlayerUses | Repeatable};
+   map[SRLightTurnOn] = {Light_MaxNeighbor, {0, 0, 0, 0, 0}, PlayerUses | Repeatable};
+   map[SRLightsVeryDark] = {Light_ChangeToValue, {0, 35, 0, 0, 0}, PlayerUses | Repeatable};
+   map[SRLowerFloorTurbo] = {Floor_LowerToHighest, {0, 32, 136, 0, 0}, PlayerUses | Repeatable};
+   map[SRLowerFloor] = {Floor_LowerToHighestEE, {0, 8, 0, 0, 0}, PlayerUses | Repeatable};
+   map[SROpenDoor] = {Door_Open, {0, 16, 0, 0, 0}, PlayerUses | Repeatable};
+   map[SRPlatBlazeDWUS] = {Plat_DownWaitUpStayLip, {0, 64, 105, 0, 0}, PlayerUses | Repeatable};
+   map[SRPlatDownWaitUpStay] = {Plat_DownWaitUpStayLip, {0, 32, 105, 0, 0}, PlayerUses | Repeatable};
+   map[SRPlatPerpetualRaise] = {Plat_PerpetualRaiseLip, {0, 8, 105, 0, 0}, PlayerUses | Repeatable};
+   map[SRPlatRaise24Change] = {Floor_RaiseByValue, {0, 8, 24, 5, 0}, PlayerUses | Repeatable};
+   map[SRPlatRaise32Change] = {Floor_RaiseByValue, {0, 8, 32, 5, 0}, PlayerUses | Repeatable};
+   map[SRPlatRaiseNearestChange] = {Plat_RaiseAndStayTx0, {0, 4, 0, 0, 0}, PlayerUses | Repeatable};
+   map[SRPlatStop] = {Plat_Stop, {0, 0, 0, 0, 0}, PlayerUses | Repeatable};
+   map[SRPlatToggleUpDown] = {Plat_ToggleCeiling, {0, 0, 0, 0, 0}, PlayerUses | Repeatable};
+   map[SRRaiseDoor] = {Door_Raise, {0, 16, 150, 0, 0}, PlayerUses | Repeatable};
+   map[SRRaiseFloor24Change] = {Floor_RaiseByValue, {0, 8, 24, 5, 0}, PlayerUses | Repeatable};
+   map[SRRaiseFloor24] = {Floor_RaiseByValue, {0, 8, 24, 0, 0}, PlayerUses | Repeatable};
+   map[SRRaiseFloor512] = {Floor_RaiseByValue, {0, 8, 512, 0, 0}, PlayerUses | Repeatable};
+   map[SRRaiseFloorTurbo] = {Floor_RaiseToNearest, {0, 32, 0, 0, 0}, PlayerUses | Repeatable};
+   map[SRRaiseFloor] = {Floor_RaiseToLowestCeiling, {0, 8, 0, 0, 0}, PlayerUses | Repeatable};
+   map[SRSilentCrushAndRaise] = {Ceiling_CrushAndRaiseSilentDist, {0, 8, 8, 10, 0}, PlayerUses | Repeatable};
+   map[SRSilentTeleport] = {Teleport_NoFog, {0, 2, 0, 1, 0}, PlayerUses | MonsterUses | Repeatable | TagThird};
+   map[SRStartLightStrobing] = {Light_StrobeDoom, {0, 5, 35, 0, 0}, PlayerUses | Repeatable};
+   map[SRStartLineScript] = {ACS_Execute, {0, 0, 0, 0, 0}, PlayerUses | Repeatable};
+   map[SRTeleport] = {Teleport, {0, 0, 0, 0, 0}, PlayerUses | MonsterUses | Repeatable | TagSecond};
+   map[SRTurnTagLightsOff] = {Light_MinNeighbor, {0, 0, 0, 0, 0}, PlayerUses | Repeatable};
+   map[W1BuildStairsTurbo16] = {Stairs_BuildUpDoom, {0, 32, 16, 0, 0}, PlayerCrosses};
+   map[W1BuildStairsUp8] = {Stairs_BuildUpDoom, {0, 2, 8, 0, 0}, PlayerCrosses};
+   map[W1CeilingCrushAndRaise] = {Ceiling_CrushAndRaiseDist, {0, 8, 8, 10, 0}, PlayerCrosses};
+   map[W1CeilingCrushStop] = {Ceiling_CrushStop, {0, 0, 0, 0, 0}, PlayerCrosses};
+   map[W1CeilingLowerAndCrush] = {Ceiling_LowerToFloor, {0, 8, 0, 0, 8}, PlayerCrosses};
+   map[W1CeilingLowerToFloor] = {Ceiling_LowerToFloor, {0, 8, 0, 0, 0}, PlayerCrosses};
+   map[W1CeilingLowerToLowest] = {Ceiling_LowerToLowest, {0, 8, 0, 0, 0}, PlayerCrosses};
+   map[W1CeilingLowerToMaxFloor] = {Ceiling_LowerToHighestFloor, {0, 8, 0, 0, 0}, PlayerCrosses};
+   map[W1ChangeOnlyNumeric] = {Floor_TransferNumeric, {0, 0, 0, 0, 0}, PlayerCrosses};
+   map[W1ChangeOnly] = {Floor_TransferTrigger, {0, 0, 0, 0, 0}, PlayerCrosses};
+   map[W1CloseDoor30] = {Door_CloseWaitOpen, {0, 16, 240, 0, 0}, PlayerCrosses};
+   map[W1CloseDoor] = {Door_Close, {0, 16, 0, 0, 0}, PlayerCrosses};
+   map[W1DoDonut] = {Floor_Donut, {0, 4, 4, 0, 0}, PlayerCrosses};
+   map[W1DoorBlazeClose] = {Door_Close, {0, 64, 0, 0, 0}, PlayerCrosses};
+   map[W1DoorBlazeOpen] = {Door_Open, {0, 64, 0, 0, 0}, PlayerCrosses};
+   map[W1DoorBlazeRaise] = {Door_Raise, {0, 64, 150, 0, 0}, PlayerCrosses};
+   map[W1ElevatorCurrent] = {Elevator_MoveToFloor, {0, 32, 0, 0, 0}, PlayerCrosses};
+   map[W1ElevatorDown] = {Elevator_LowerToNearest, {0, 32, 0, 0, 0}, PlayerCrosses};
+   map[W1ElevatorUp] = {Elevator_RaiseToNearest, {0, 32, 0, 0, 0}, PlayerCrosses};
+   map[W1FastCeilCrushRaise] = {Ceiling_CrushAndRaiseDist, {0, 8, 16, 10, 0}, PlayerCrosses};
+   map[W1FloorLowerAndChange] = {Floor_LowerToLowest, {0, 8, 6, 0, 0}, PlayerCrosses};
+   map[W1FloorLowerToLowest] = {Floor_LowerToLowest, {0, 8, 0, 0, 0}, PlayerCrosses};
+   map[W1FloorLowerToNearest] = {Floor_LowerToNearest, {0, 8, 0, 0, 0}, PlayerCrosses};
+   map[W1FloorRaiseCrush] = {Floor_RaiseToLowestCeiling, {0, 8, 0, 10, 8}, PlayerCrosses};
+   map[W1FloorRaiseToNearest] = {Floor_RaiseToNearest, {0, 8, 0, 0, 0}, PlayerCrosses};
+   map[W1FloorRaiseToTexture] = {Floor_RaiseByTexture, {0, 8, 0, 0, 0}, PlayerCrosses};
+   map[W1LightTurnOn255] = {Light_ChangeToValue, {0, 255, 0, 0, 0}, PlayerCrosses};
+   map[W1LightTurnOn] = {Light_MaxNeighbor, {0, 0, 0, 0, 0}, PlayerCrosses};
+   map[W1LightsVeryDark] = {Light_ChangeToValue, {0, 35, 0, 0, 0}, PlayerCrosses};
+   map[W1LowerFloorTurbo] = {Floor_LowerToHighest, {0, 32, 136, 0, 0}, PlayerCrosses};
+   map[W1LowerFloor] = {Floor_LowerToHighestEE, {0, 8, 0, 0, 0}, PlayerCrosses};
+   map[W1OpenDoor] = {Door_Open, {0, 16, 0, 0, 0}, PlayerCrosses};
+   map[W1PlatBlazeDWUS] = {Plat_DownWaitUpStayLip, {0, 64, 105, 0, 0}, PlayerCrosses};
+   map[W1PlatDownWaitUpStay] = {Plat_DownWaitUpStayLip, {0, 32, 105, 0, 0}, PlayerCrosses | MonsterCrosses};
+   map[W1PlatPerpetualRaise] = {Plat_PerpetualRaiseLip, {0, 8, 105, 0, 0}, PlayerCrosses};
+   map[W1PlatRaise24Change] = {Plat_UpByValueStayTx, {0, 4, 3, 0, 0}, PlayerCrosses};
+   map[W1PlatRaise32Change] = {Plat_UpByValueStayTx, {0, 4, 4, 0, 0}, PlayerCrosses};
+   map[W1PlatRaiseNearestChange] = {Plat_RaiseAndStayTx0, {0, 4, 0, 0, 0}, PlayerCrosses};
+   map[W1PlatStop] = {Plat_Stop, {0, 0, 0, 0, 0}, PlayerCrosses};
+   map[W1RaiseCeilingLowerFloor] = {Ceiling_RaiseToHighest, {0, 8, 0, 0, 0}, PlayerCrosses};
+   map[W1RaiseDoor] = {Door_Raise, {0, 16, 150, 0, 0}, PlayerCrosses | MonsterCrosses};
+   map[W1RaiseFloor24Change] = {Floor_RaiseByValue, {0, 8, 24, 5, 0}, PlayerCrosses};
+   map[W1RaiseFloor24] = {Floor_RaiseByValue, {0, 8, 24, 0, 0}, PlayerCrosses};
+   map[W1RaiseFloor512] = {Floor_RaiseByValue, {0, 8, 512, 0, 0}, PlayerCrosses};
+   map[W1RaiseFloorTurbo] = {Floor_RaiseToNearest, {0, 32, 0, 0, 0}, PlayerCrosses};
+   map[W1RaiseFloor] = {Floor_RaiseToLowestCeiling, {0, 8, 0, 0, 0}, PlayerCrosses};
+   map[W1SilentCrushAndRaise] = {Ceiling_CrushAndRaiseSilentDist, {0, 8, 8, 10, 0}, PlayerCrosses};
+   map[W1SilentLineTRMonsters] = {Teleport_Line, {0, 0, 1, 0, 0}, MonsterCrosses | TagSecond};
+   map[W1SilentLineTeleMonsters] = {Teleport_Line, {0, 0, 0, 0, 0}, MonsterCrosses | TagSecond};
+   map[W1SilentLineTeleportReverse] = {Teleport_Line, {0, 0, 1, 0, 0}, PlayerCrosses | MonsterCrosses | TagSecond};
+   map[W1SilentLineTeleport] = {Teleport_Line, {0, 0, 0, 0, 0}, PlayerCrosses | MonsterCrosses | TagSecond};
+   map[W1SilentTeleportMonsters] = {Teleport_NoFog, {0, 2, 0, 1, 0}, MonsterCrosses | TagThird};
+   map[W1SilentTeleport] = {Teleport_NoFog, {0, 2, 0, 1, 0}, PlayerCrosses | MonsterCrosses | TagThird};
+   map[W1StartLightStrobing] = {Light_StrobeDoom, {0, 5, 35, 0, 0}, PlayerCrosses};
+   map[W1StartLineScript1S] = {ACS_Execute, {0, 0, 0, 0, 0}, PlayerCrosses | FirstSide};
+   map[W1StartLineScript] = {ACS_Execute, {0, 0, 0, 0, 0}, PlayerCrosses};
+   map[W1TeleportMonsters] = {Teleport, {0, 0, 0, 0, 0}, MonsterCrosses | TagSecond};
+   map[W1Teleport] = {Teleport, {0, 0, 0, 0, 0}, PlayerCrosses | MonsterCrosses | TagSecond};
+   map[W1TurnTagLightsOff] = {Light_MinNeighbor, {0, 0, 0, 0, 0}, PlayerCrosses};
+   map[WRBuildStairsTurbo16] = {Stairs_BuildUpDoom, {0, 32, 16, 0, 0}, PlayerCrosses | Repeatable};
+   map[WRBuildStairsUp8] = {Stairs_BuildUpDoom, {0, 2, 8, 0, 0}, PlayerCrosses | Repeatable};
+   map[WRCeilingCrushAndRaise] = {Ceiling_CrushAndRaiseDist, {0, 8, 8, 10, 0}, PlayerCrosses | Repeatable};
+   map[WRCeilingCrushStop] = {Ceiling_CrushStop, {0, 0, 0, 0, 0}, PlayerCrosses | Repeatable};
+   map[WRCeilingLowerAndCrush] = {Ceiling_LowerToFloor, {0, 8, 0, 0, 8}, PlayerCrosses | Repeatable};
+   map[WRCeilingLowerToFloor] = {Ceiling_LowerToFloor, {0, 8, 0, 0, 0}, PlayerCrosses | Repeatable};
+   map[WRCeilingLowerToLowest] = {Ceiling_LowerToLowest, {0, 8, 0, 0, 0}, PlayerCrosses | Repeatable};
+   map[WRCeilingLowerToMaxFloor] = {Ceiling_LowerToHighestFloor, {0, 8, 0, 0, 0}, PlayerCrosses | Repeatable};
+   map[WRChangeOnlyNumeric] = {Floor_TransferNumeric, {0, 0, 0, 0, 0}, PlayerCrosses | Repeatable};
+   map[WRChangeOnly] = {Floor_TransferTrigger, {0, 0, 0, 0, 0}, PlayerCrosses | Repeatable};
+   map[WRCloseDoor30] = {Door_CloseWaitOpen, {0, 16, 240, 0, 0}, PlayerCrosses | Repeatable};
+   map[WRCloseDoor] = {Door_Close, {0, 16, 0, 0, 0}, PlayerCrosses | Repeatable};
+   map[WRDoDonut] = {Floor_Donut, {0, 4, 4, 0, 0}, PlayerCrosses | Repeatable};
+   map[WRDoorBlazeClose] = {Door_Close, {0, 64, 0, 0, 0}, PlayerCrosses | Repeatable};
+   map[WRDoorBlazeOpen] = {Door_Open, {0, 64, 0, 0, 0}, PlayerCrosses | Repeatable};
+   map[WRDoorBlazeRaise] = {Door_Raise, {0, 64, 150, 0, 0}, PlayerCrosses | Repeatable};
+   map[WRElevatorCurrent] = {Elevator_MoveToFloor, {0, 32, 0, 0, 0}, PlayerCrosses | Repeatable};
+   map[WRElevatorDown] = {Elevator_LowerToNearest, {0, 32, 0, 0, 0}, PlayerCrosses | Repeatable};
+   map[WRElevatorUp] = {Elevator_RaiseToNearest, {0, 32, 0, 0, 0}, PlayerCrosses | Repeatable};
+   map[WRExitLevel] = {Exit_Normal, {0, 0, 0, 0, 0}, PlayerCrosses | NoTag};
+   map[WRFastCeilCrushRaise] = {Ceiling_CrushAndRaiseDist, {0, 8, 16, 10, 0}, PlayerCrosses | Repeatable};
+   map[WRFloorLowerAndChange] = {Floor_LowerToLowest, {0, 8, 6, 0, 0}, PlayerCrosses | Repeatable};
+   map[WRFloorLowerToLowest] = {Floor_LowerToLowest, {0, 8, 0, 0, 0}, PlayerCrosses | Repeatable};
+   map[WRFloorLowerToNearest] = {Floor_LowerToNearest, {0, 8, 0, 0, 0}, PlayerCrosses | Repeatable};
+   map[WRFloorRaiseCrush] = {Floor_RaiseToLowestCeiling, {0, 8, 0, 10, 8}, PlayerCrosses | Repeatable};
+   map[WRFloorRaiseToNearest] = {Floor_RaiseToNearest, {0, 8, 0, 0, 0}, PlayerCrosses | Repeatable};
+   map[WRFloorRaiseToTexture] = {Floor_RaiseByTexture, {0, 8, 0, 0, 0}, PlayerCrosses | Repeatable};
+   map[WRLightTurnOn255] = {Light_ChangeToValue, {0, 255, 0, 0, 0}, PlayerCrosses | Repeatable};
+   map[WRLightTurnOn] = {Light_MaxNeighbor, {0, 0, 0, 0, 0}, PlayerCrosses | Repeatable};
+   map[WRLightsVeryDark] = {Light_ChangeToValue, {0, 35, 0, 0, 0}, PlayerCrosses | Repeatable};
+   map[WRLowerFloorTurbo] = {Floor_LowerToHighest, {0, 32, 136, 0, 0}, PlayerCrosses | Repeatable};
+   map[WRLowerFloor] = {Floor_LowerToHighestEE, {0, 8, 0, 0, 0}, PlayerCrosses | Repeatable};
+   map[WROpenDoor] = {Door_Open, {0, 16, 0, 0, 0}, PlayerCrosses | Repeatable};
+   map[WRPlatBlazeDWUS] = {Plat_DownWaitUpStayLip, {0, 64, 105, 0, 0}, PlayerCrosses | Repeatable};
+   map[WRPlatDownWaitUpStay] = {Plat_DownWaitUpStayLip, {0, 32, 105, 0, 0}, PlayerCrosses | MonsterCrosses | Repeatable};
+   map[WRPlatPerpetualRaise] = {Plat_PerpetualRaiseLip, {0, 8, 105, 0, 0}, PlayerCrosses | Repeatable};
+   map[WRPlatRaise24Change] = {Plat_UpByValueStayTx, {0, 4, 3, 0, 0}, PlayerCrosses | Repeatable};
+   map[WRPlatRaise32Change] = {Plat_UpByValueStayTx, {0, 4, 3, 0, 0}, PlayerCrosses | Repeatable};
+   map[WRPlatRaiseNearestChange] = {Plat_RaiseAndStayTx0, {0, 4, 0, 0, 0}, PlayerCrosses | Repeatable};
+   map[WRPlatStop] = {Plat_Stop, {0, 0, 0, 0, 0}, PlayerCrosses | Repeatable};
+   map[WRPlatToggleUpDown] = {Plat_ToggleCeiling, {0, 0, 0, 0, 0}, PlayerCrosses | Repeatable};
+   map[WRRaiseCeilingLowerFloor] = {Ceiling_RaiseToHighest, {0, 8, 0, 0, 0}, PlayerCrosses | Repeatable};
+   map[WRRaiseDoor] = {Door_Raise, {0, 16, 150, 0, 0}, PlayerCrosses | Repeatable};
+   map[WRRaiseFloor24Change] = {Floor_RaiseByValue, {0, 8, 24, 5, 0}, PlayerCrosses | Repeatable};
+   map[WRRaiseFloor24] = {Floor_RaiseByValue, {0, 8, 24, 0, 0}, PlayerCrosses | Repeatable};
+   map[WRRaiseFloor512] = {Floor_RaiseByValue, {0, 8, 512, 0, 0}, PlayerCrosses | Repeatable};
+   map[WRRaiseFloorTurbo] = {Floor_RaiseToNearest, {0, 32, 0, 0, 0}, PlayerCrosses | Repeatable};
+   map[WRRaiseFloor] = {Floor_RaiseToLowestCeiling, {0, 8, 0, 0, 0}, PlayerCrosses | Repeatable};
+   map[WRSecretExit] = {Exit_Secret, {0, 0, 0, 0, 0}, PlayerCrosses | NoTag};
+   map[WRSilentCrushAndRaise] = {Ceiling_CrushAndRaiseSilentDist, {0, 8, 8, 10, 0}, PlayerCrosses | Repeatable};
+   map[WRSilentLineTRMonsters] = {Teleport_Line, {0, 0, 1, 0, 0}, MonsterCrosses | Repeatable | TagSecond};
+   map[WRSilentLineTeleMonsters] = {Teleport_Line, {0, 0, 0, 0, 0}, MonsterCrosses | Repeatable | TagSecond};
+   map[WRSilentLineTeleportReverse] = {Teleport_Line, {0, 0, 1, 0, 0}, PlayerCrosses | MonsterCrosses | Repeatable | TagSecond};
+   map[WRSilentLineTeleport] = {Teleport_Line, {0, 0, 0, 0, 0}, PlayerCrosses | MonsterCrosses | Repeatable | TagSecond};
+   map[WRSilentTeleportMonsters] = {Teleport_NoFog, {0, 2, 0, 1, 0}, MonsterCrosses | Repeatable | TagThird};
+   map[WRSilentTeleport] = {Teleport_NoFog, {0, 2, 0, 1, 0}, PlayerCrosses | MonsterCrosses | Repeatable | TagThird};
+   map[WRStartLightStrobing] = {Light_StrobeDoom, {0, 5, 35, 0, 0}, PlayerCrosses | Repeatable};
+   map[WRStartLineScript1S] = {ACS_Execute, {0, 0, 0, 0, 0}, PlayerCrosses | Repeatable | FirstSide};
+   map[WRStartLineScript] = {ACS_Execute, {0, 0, 0, 0, 0}, PlayerCrosses | Repeatable};
+   map[WRTeleportMonsters] = {Teleport, {0, 0, 0, 0, 0}, MonsterCrosses | Repeatable | TagSecond};
+   map[WRTeleport] = {Teleport, {0, 0, 0, 0, 0}, PlayerCrosses | MonsterCrosses | Repeatable | TagSecond};
+   map[WRTurnTagLightsOff] = {Light_MinNeighbor, {0, 0, 0, 0, 0}, PlayerCrosses | Repeatable};
+   map[EV_STATIC_3DMIDTEX_ATTACH_CEILING] = {Sector_Attach3dMidtex, {0, 0, 1, 0, 0}};
+   map[EV_STATIC_3DMIDTEX_ATTACH_FLOOR] = {Sector_Attach3dMidtex, {0, 0, 0, 0, 0}};
+   map[EV_STATIC_ATTACH_CEILING_TO_CONTROL] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::AttachToControl};
+   map[EV_STATIC_ATTACH_FLOOR_TO_CONTROL] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::AttachToControl};
+   map[EV_STATIC_ATTACH_MIRROR_CEILING] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::AttachToControl};
+   map[EV_STATIC_ATTACH_MIRROR_FLOOR] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::AttachToControl};
+   map[EV_STATIC_ATTACH_SET_CEILING_CONTROL] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::SetSurfaceControl};
+   map[EV_STATIC_ATTACH_SET_FLOOR_CONTROL] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::SetSurfaceControl};
+   map[EV_STATIC_CARRY_ACCEL_FLOOR] = {Scroll_Floor, {0, 5, 1, 0, 0}};
+   map[EV_STATIC_CARRY_DISPLACE_FLOOR] = {Scroll_Floor, {0, 6, 1, 0, 0}};
+   map[EV_STATIC_CARRY_FLOOR] = {Scroll_Floor, {0, 4, 1, 0, 0}};
+   map[EV_STATIC_CURRENT_CONTROL] = {Sector_SetCurrent, {0, 0, 0, 1, 0}};
+   map[EV_STATIC_EXTRADATA_LINEDEF] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::ResolveLineExtraData};
+   map[EV_STATIC_EXTRADATA_SECTOR] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::ResolveSectorExtraData};
+   map[EV_STATIC_FRICTION_TRANSFER] = {Sector_SetFriction};
+   map[EV_STATIC_HERETIC_CURRENT] = {Sector_SetCurrent, {0, 0, 0, 3, 0}};
+   map[EV_STATIC_HERETIC_WIND] = {Sector_SetWind, {0, 0, 0, 3, 0}};
+   map[EV_STATIC_LIGHT_TRANSFER_CEILING] = {Transfer_CeilingLight};
+   map[EV_STATIC_LIGHT_TRANSFER_FLOOR] = {Transfer_FloorLight};
+   map[EV_STATIC_LINE_SET_IDENTIFICATION] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::SetLineID};
+   map[EV_STATIC_PORTAL_ANCHORED_CEILING] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::PortalDefine};
+   map[EV_STATIC_PORTAL_ANCHORED_CEILING_FLOOR] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::PortalDefine};
+   map[EV_STATIC_PORTAL_ANCHORED_FLOOR] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::PortalDefine};
+   map[EV_STATIC_PORTAL_ANCHOR] = {};
+   map[EV_STATIC_PORTAL_ANCHOR_FLOOR] = {};
+   map[EV_STATIC_PORTAL_APPLY_FRONTSECTOR] = {};
+   map[EV_STATIC_PORTAL_HORIZON_CEILING] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::PortalDefine};
+   map[EV_STATIC_PORTAL_HORIZON_CEILING_FLOOR] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::PortalDefine};
+   map[EV_STATIC_PORTAL_HORIZON_FLOOR] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::PortalDefine};
+   map[EV_STATIC_PORTAL_HORIZON_LINE] = {Line_Horizon};
+   map[EV_STATIC_PORTAL_LINE] = {};
+   map[EV_STATIC_PORTAL_LINKED_ANCHOR] = {};
+   map[EV_STATIC_PORTAL_LINKED_ANCHOR_FLOOR] = {};
+   map[EV_STATIC_PORTAL_LINKED_CEILING] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::PortalDefine};
+   map[EV_STATIC_PORTAL_LINKED_FLOOR] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::PortalDefine};
+   map[EV_STATIC_PORTAL_LINKED_L2L_ANCHOR] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::QuickLinePortal};
+   map[EV_STATIC_PORTAL_LINKED_LINE2LINE] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::QuickLinePortal};
+   map[EV_STATIC_PORTAL_PLANE_CEILING] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::PortalDefine};
+   map[EV_STATIC_PORTAL_PLANE_CEILING_FLOOR] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::PortalDefine};
+   map[EV_STATIC_PORTAL_PLANE_FLOOR] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::PortalDefine};
+   map[EV_STATIC_PORTAL_SKYBOX_CEILING] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::PortalDefine};
+   map[EV_STATIC_PORTAL_SKYBOX_CEILING_FLOOR] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::PortalDefine};
+   map[EV_STATIC_PORTAL_SKYBOX_FLOOR] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::PortalDefine};
+   map[EV_STATIC_PORTAL_TWOWAY_CEILING] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::PortalDefine};
+   map[EV_STATIC_PORTAL_TWOWAY_FLOOR] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::PortalDefine};
+   map[EV_STATIC_PUSHPULL_CONTROL] = {PointPush_SetForce, {0, 0, 0, 1, 0}};
+   map[EV_STATIC_SCROLL_ACCEL_CEILING] = {Scroll_Ceiling, {0, 5, 0, 0, 0}};
+   map[EV_STATIC_SCROLL_ACCEL_FLOOR] = {Scroll_Floor, {0, 5, 0, 0, 0}};
+   map[EV_STATIC_SCROLL_ACCEL_WALL] = {Scroll_Texture_Model, {0, 1, 0, 0, 0}};
+   map[EV_STATIC_SCROLL_BY_OFFSETS] = {Scroll_Texture_Offsets};
+   map[EV_STATIC_SCROLL_CARRY_ACCEL_FLOOR] = {Scroll_Floor, {0, 5, 2, 0, 0}};
+   map[EV_STATIC_SCROLL_CARRY_DISPLACE_FLOOR] = {Scroll_Floor, {0, 6, 2, 0, 0}};
+   map[EV_STATIC_SCROLL_CARRY_FLOOR] = {Scroll_Floor, {0, 4, 2, 0, 0}};
+   map[EV_STATIC_SCROLL_CEILING] = {Scroll_Ceiling, {0, 4, 0, 0, 0}};
+   map[EV_STATIC_SCROLL_DISPLACE_CEILING] = {Scroll_Ceiling, {0, 6, 0, 0, 0}};
+   map[EV_STATIC_SCROLL_DISPLACE_FLOOR] = {Scroll_Floor, {0, 6, 0, 0, 0}};
+   map[EV_STATIC_SCROLL_DISPLACE_WALL] = {Scroll_Texture_Model, {0, 2, 0, 0, 0}};
+   map[EV_STATIC_SCROLL_FLOOR] = {Scroll_Floor, {0, 4, 0, 0, 0}};
+   map[EV_STATIC_SCROLL_LINE_DOWN] = {Scroll_Texture_Down, {64, 0, 0, 0, 0}, NoTag};
+   map[EV_STATIC_SCROLL_LINE_DOWN_FAST] = {Scroll_Texture_Down, {192, 0, 0, 0, 0}, NoTag};
+   map[EV_STATIC_SCROLL_LINE_LEFT] = {Scroll_Texture_Left, {64, 0, 0, 0, 0}, NoTag};
+   map[EV_STATIC_SCROLL_LINE_RIGHT] = {Scroll_Texture_Right, {64, 0, 0, 0, 0}, NoTag};
+   map[EV_STATIC_SCROLL_LINE_UP] = {Scroll_Texture_Up, {64, 0, 0, 0, 0}, NoTag};
+   map[EV_STATIC_SCROLL_WALL_WITH] = {Scroll_Texture_Model, {0, 0, 0, 0, 0}};
+   map[EV_STATIC_SKY_TRANSFER] = {Static_Init, {0, 255, 0, 0, 0}};
+   map[EV_STATIC_SKY_TRANSFER_FLIPPED] = {Static_Init, {0, 255, 1, 0, 0}};
+   map[EV_STATIC_SLOPE_BACKFLOOR_FRONTCEILING] = {Plane_Align, {2, 1, 0, 0, 0}, NoTag};
+   map[EV_STATIC_SLOPE_BSEC_CEILING] = {Plane_Align, {0, 2, 0, 0, 0}, NoTag};
+   map[EV_STATIC_SLOPE_BSEC_FLOOR] = {Plane_Align, {2, 0, 0, 0, 0}, NoTag};
+   map[EV_STATIC_SLOPE_BSEC_FLOOR_CEILING] = {Plane_Align, {2, 2, 0, 0, 0}, NoTag};
+   map[EV_STATIC_SLOPE_FRONTCEILING_TAG] = {Plane_Copy, {0, 0, 0, 0, 0}, TagSecond};
+   map[EV_STATIC_SLOPE_FRONTFLOORCEILING_TAG] = {Plane_Copy, {0, 0, 0, 0, 0}, TagFirstSecond};
+   map[EV_STATIC_SLOPE_FRONTFLOOR_BACKCEILING] = {Plane_Align, {1, 2, 0, 0, 0}, NoTag};
+   map[EV_STATIC_SLOPE_FRONTFLOOR_TAG] = {Plane_Copy, {0, 0, 0, 0, 0}};
+   map[EV_STATIC_SLOPE_FSEC_CEILING] = {Plane_Align, {0, 1, 0, 0, 0}, NoTag};
+   map[EV_STATIC_SLOPE_FSEC_FLOOR] = {Plane_Align, {1, 0, 0, 0, 0}, NoTag};
+   map[EV_STATIC_SLOPE_FSEC_FLOOR_CEILING] = {Plane_Align, {1, 1, 0, 0, 0}, NoTag};
+   map[EV_STATIC_TRANSFER_HEIGHTS] = {Transfer_Heights};
+   map[EV_STATIC_TRANSLUCENT] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::TranslucentLine};
+   map[EV_STATIC_WIND_CONTROL] = {Sector_SetWind, {0, 0, 0, 1, 0}};
+}
+
+static constexpr LineMappingTable gMapping;
+
+//
+// ExtraData special name entry
+//
+struct EDSpecialName
+{
+   const char *name;
+   UdmfSpecial special;
+};
+
+static constexpr EDSpecialName gEDNames[] =
+{
+   { "acs_execute", ACS_Execute },
+   { "acs_executealways", ACS_ExecuteAlways },
+   { "acs_executewithresult", ACS_ExecuteWithResult },
+   { "acs_lockedexecute", ACS_LockedExecute },
+   { "acs_lockedexecutedoor", ACS_LockedExecuteDoor },
+   { "acs_suspend", ACS_Suspend },
+   { "acs_terminate", ACS_Terminate },
+   { "ceiling_crushandraise", Ceiling_CrushAndRaise },
+   { "ceiling_crushandraisea", Ceiling_CrushAndRaiseA },
+   { "ceiling_crushandraisedist", Ceiling_CrushAndRaiseDist },
+   { "ceiling_crushandraisesilenta", Ceiling_CrushAndRaiseSilentA },
+   { "ceiling_crushandraisesilentdist", Ceiling_CrushAndRaiseSilentDist },
+   { "ceiling_crushraiseandstay", Ceiling_CrushRaiseAndStay },
+   { "ceiling_crushraiseandstaya", Ceiling_CrushRaiseAndStayA },
+   { "ceiling_crushraiseandstaysila", Ceiling_CrushRaiseAndStaySilA },
+   { "ceiling_crushstop", Ceiling_CrushStop },
+   { "ceiling_lowerandcrush", Ceiling_LowerAndCrush },
+   { "ceiling_lowerandcrushdist", Ceiling_LowerAndCrushDist },
+   { "ceiling_lowerbytexture", Ceiling_LowerByTexture },
+   { "ceiling_lowerbyvalue", Ceiling_LowerByValue },
+   { "ceiling_lowerinstant", Ceiling_LowerInstant },
+   { "ceiling_lowertofloor", Ceiling_LowerToFloor },
+   { "ceiling_lowertohighestfloor", Ceiling_LowerToHighestFloor },
+   { "ceiling_lowertolowest", Ceiling_LowerToLowest },
+   { "ceiling_lowertonearest", Ceiling_LowerToNearest },
+   { "ceiling_movetovalue", Ceiling_MoveToValue },
+   { "ceiling_raisebytexture", Ceiling_RaiseByTexture },
+   { "ceiling_raisebyvalue", Ceiling_RaiseByValue },
+   { "ceiling_raiseinstant", Ceiling_RaiseInstant },
+   { "ceiling_raisetohighest", Ceiling_RaiseToHighest },
+   { "ceiling_raisetohighestfloor", Ceiling_RaiseToHighestFloor },
+   { "ceiling_raisetolowest", Ceiling_RaiseToLowest },
+   { "ceiling_raisetonearest", Ceiling_RaiseToNearest },
+   { "ceiling_tofloorinstant", Ceiling_ToFloorInstant },
+   { "ceiling_tohighestinstant", Ceiling_ToHighestInstant },
+   { "ceiling_waggle", Ceiling_Waggle },
+   { "changeskill", ChangeSkill },
+   { "damagething", DamageThing },
+   { "door_close", Door_Close },
+   { "door_closewaitopen", Door_CloseWaitOpen },
+   { "door_lockedraise", Door_LockedRaise },
+   { "door_open", Door_Open },
+   { "door_raise", Door_Raise },
+   { "door_waitclose", Door_WaitClose },
+   { "door_waitraise", Door_WaitRaise },
+   { "elevator_lowertonearest", Elevator_LowerToNearest },
+   { "elevator_movetofloor", Elevator_MoveToFloor },
+   { "elevator_raisetonearest", Elevator_RaiseToNearest },
+   { "exit_normal", Exit_Normal },
+   { "exit_secret", Exit_Secret },
+   { "floor_crushstop", Floor_CrushStop },
+   { "floor_donut", Floor_Donut },
+   { "floor_lowerbytexture", Floor_LowerByTexture },
+   { "floor_lowerbyvalue", Floor_LowerByValue },
+   { "floor_lowerinstant", Floor_LowerInstant },
+   { "floor_lowertohighest", Floor_LowerToHighest },
+   { "floor_lowertohighestee", Floor_LowerToHighestEE },
+   { "floor_lowertolowest", Floor_LowerToLowest },
+   { "floor_lowertolowestceiling", Floor_LowerToLowestCeiling },
+   { "floor_lowertonearest", Floor_LowerToNearest },
+   { "floor_movetovalue", Floor_MoveToValue },
+   { "floor_raiseandcrush", Floor_RaiseAndCrush },
+   { "floor_raisebytexture", Floor_RaiseByTexture },
+   { "floor_raisebyvalue", Floor_RaiseByValue },
+   { "floor_raiseinstant", Floor_RaiseInstant },
+   { "floor_raisetoceiling", Floor_RaiseToCeiling },
+   { "floor_raisetohighest", Floor_RaiseToHighest },
+   { "floor_raisetolowest", Floor_RaiseToLowest },
+   { "floor_raisetolowestceiling", Floor_RaiseToLowestCeiling },
+   { "floor_raisetonearest", Floor_RaiseToNearest },
+   { "floor_toceilinginstant", Floor_ToCeilingInstant },
+   { "floor_transfernumeric", Floor_TransferNumeric },
+   { "floor_transfertrigger", Floor_TransferTrigger },
+   { "floor_waggle", Floor_Waggle },
+   { "floorandceiling_lowerbyvalue", FloorAndCeiling_LowerByValue },
+   { "floorandceiling_lowerraise", FloorAndCeiling_LowerRaise },
+   { "floorandceiling_raisebyvalue", FloorAndCeiling_RaiseByValue },
+   { "generic_ceiling", Generic_Ceiling },
+   { "generic_crusher", Generic_Crusher },
+   { "generic_door", Generic_Door },
+   { "generic_floor", Generic_Floor },
+   { "generic_lift", Generic_Lift },
+   { "generic_stairs", Generic_Stairs },
+   { "healthing", HealThing },
+   { "light_changetovalue", Light_ChangeToValue },
+   { "light_fade", Light_Fade },
+   { "light_flicker", Light_Flicker },
+   { "light_glow", Light_Glow },
+   { "light_lowerbyvalue", Light_LowerByValue },
+   { "light_maxneighbor", Light_MaxNeighbor },
+   { "light_minneighbor", Light_MinNeighbor },
+   { "light_raisebyvalue", Light_RaiseByValue },
+   { "light_strobe", Light_Strobe },
+   { "light_strobedoom", Light_StrobeDoom },
+   { "line_horizon", Line_Horizon },
+   { "line_quickportal", Line_QuickPortal },
+   { "line_setidentification", Line_SetIdentification },
+   { "line_setportal", Line_SetPortal },
+   { "pillar_build", Pillar_Build },
+   { "pillar_buildandcrush", Pillar_BuildAndCrush },
+   { "pillar_open", Pillar_Open },
+   { "plane_align", Plane_Align },
+   { "plane_copy", Plane_Copy },
+   { "plat_downbyvalue", Plat_DownByValue },
+   { "plat_downwaitupstay", Plat_DownWaitUpStay },
+   { "plat_downwaitupstaylip", Plat_DownWaitUpStayLip },
+   { "plat_perpetualraise", Plat_PerpetualRaise },
+   { "plat_perpetualraiselip", Plat_PerpetualRaiseLip },
+   { "plat_raiseandstaytx0", Plat_RaiseAndStayTx0 },
+   { "plat_stop", Plat_Stop },
+   { "plat_toggleceiling", Plat_ToggleCeiling },
+   { "plat_upbyvalue", Plat_UpByValue },
+   { "plat_upbyvaluestaytx", Plat_UpByValueStayTx },
+   { "plat_upwaitdownstay", Plat_UpWaitDownStay },
+   { "pointpush_setforce", PointPush_SetForce },
+   { "polyobj_doorslide", Polyobj_DoorSlide },
+   { "polyobj_doorswing", Polyobj_DoorSwing },
+   { "polyobj_explicitline", Polyobj_ExplicitLine },
+   { "polyobj_move", Polyobj_Move },
+   { "polyobj_moveto", Polyobj_MoveTo },
+   { "polyobj_movetospot", Polyobj_MoveToSpot },
+   { "polyobj_or_move", Polyobj_OR_Move },
+   { "polyobj_or_moveto", Polyobj_OR_MoveTo },
+   { "polyobj_or_movetospot", Polyobj_OR_MoveToSpot },
+   { "polyobj_or_rotateleft", Polyobj_OR_RotateLeft },
+   { "polyobj_or_rotateright", Polyobj_OR_RotateRight },
+   { "polyobj_rotateleft", Polyobj_RotateLeft },
+   { "polyobj_rotateright", Polyobj_RotateRight },
+   { "polyobj_startline", Polyobj_StartLine },
+   { "polyobj_stop", Polyobj_Stop },
+   { "portal_define", Portal_Define },
+   { "radius_quake", Radius_Quake },
+   { "scroll_ceiling", Scroll_Ceiling },
+   { "scroll_floor", Scroll_Floor },
+   { "scroll_texture_down", Scroll_Texture_Down },
+   { "scroll_texture_left", Scroll_Texture_Left },
+   { "scroll_texture_model", Scroll_Texture_Model },
+   { "scroll_texture_offsets", Scroll_Texture_Offsets },
+   { "scroll_texture_right", Scroll_Texture_Right },
+   { "scroll_texture_up", Scroll_Texture_Up },
+   { "sector_attach3dmidtex", Sector_Attach3dMidtex },
+   { "sector_changesound", Sector_ChangeSound },
+   { "sector_setceilingpanning", Sector_SetCeilingPanning },
+   { "sector_setcurrent", Sector_SetCurrent },
+   { "sector_setfloorpanning", Sector_SetFloorPanning },
+   { "sector_setfriction", Sector_SetFriction },
+   { "sector_setportal", Sector_SetPortal },
+   { "sector_setrotation", Sector_SetRotation },
+   { "sector_setwind", Sector_SetWind },
+   { "stairs_builddowndoom", Stairs_BuildDownDoom },
+   { "stairs_builddowndoomsync", Stairs_BuildDownDoomSync },
+   { "stairs_buildupdoom", Stairs_BuildUpDoom },
+   { "stairs_buildupdoomcrush", Stairs_BuildUpDoomCrush },
+   { "stairs_buildupdoomsync", Stairs_BuildUpDoomSync },
+   { "static_init", Static_Init },
+   { "teleport", Teleport },
+   { "teleport_endgame", Teleport_EndGame },
+   { "teleport_line", Teleport_Line },
+   { "teleport_newmap", Teleport_NewMap },
+   { "teleport_nofog", Teleport_NoFog },
+   { "thing_activate", Thing_Activate },
+   { "thing_changetid", Thing_ChangeTID },
+   { "thing_damage", Thing_Damage },
+   { "thing_deactivate", Thing_Deactivate },
+   { "thing_destroy", Thing_Destroy },
+   { "thing_projectile", Thing_Projectile },
+   { "thing_projectilegravity", Thing_ProjectileGravity },
+   { "thing_raise", Thing_Raise },
+   { "thing_remove", Thing_Remove },
+   { "thing_spawn", Thing_Spawn },
+   { "thing_spawnnofog", Thing_SpawnNoFog },
+   { "thing_stop", Thing_Stop },
+   { "thrustthing", ThrustThing },
+   { "thrustthingz", ThrustThingZ },
+   { "transfer_ceilinglight", Transfer_CeilingLight },
+   { "transfer_floorlight", Transfer_FloorLight },
+   { "transfer_heights", Transfer_Heights },
+};
+
+//
+// ASCII lowercase, usable at compile time
+//
+constexpr static char ED_lowerCase(char c)
+{
+   return c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c;
+}
+
+//
+// Case-insensitive FNV-1a hash of a special name
+//
+constexpr static uint64_t ED_hashName(const char *name)
 {
-   gMapping[D1DoorBlazeOpen] = {Door_Open, {0, 64, 0, 0, 0}, PlayerUses | NoTag, &LinedefConversion::SetLightTag};
-   gMapping[D1OpenDoorBlue] = {Door_LockedRaise, {0, 16, 0, EV_LOCKDEF_BLUE, 0}, PlayerUses | NoTag, &LinedefConversion::SetLightTag};
-   gMapping[D1OpenDoorRed] = {Door_LockedRaise, {0, 16, 0, EV_LOCKDEF_REDGREEN, 0}, PlayerUses | NoTag, &LinedefConversion::SetLightTag};
-   gMapping[D1OpenDoorYellow] = {Door_LockedRaise, {0, 16, 0, EV_LOCKDEF_YELLOW, 0}, PlayerUses | NoTag, &LinedefConversion::SetLightTag};
-   gMapping[D1OpenDoor] = {Door_Open, {0, 16, 0, 0, 0}, PlayerUses | NoTag, &LinedefConversion::SetLightTag};
-   gMapping[DRDoorBlazeRaise] = {Door_Raise, {0, 64, 150, 0, 0}, PlayerUses | Repeatable | NoTag, &LinedefConversion::SetLightTag};
-   gMapping[DRRaiseDoorBlue] = {Door_LockedRaise, {0, 16, 150, EV_LOCKDEF_BLUE, 0}, PlayerUses | Repeatable | NoTag, &LinedefConversion::SetLightTag};
-   gMapping[DRRaiseDoorRed] = {Door_LockedRaise, {0, 16, 150, EV_LOCKDEF_REDGREEN, 0}, PlayerUses | Repeatable | NoTag, &LinedefConversion::SetLightTag};
-   gMapping[DRRaiseDoorYellow] = {Door_LockedRaise, {0, 16, 150, EV_LOCKDEF_YELLOW, 0}, PlayerUses | Repeatable | NoTag, &LinedefConversion::SetLightTag};
-   gMapping[DRRaiseDoor] = {Door_Raise, {0, 16, 150, 0, 0}, PlayerUses | MonsterUses | Repeatable | NoTag, &LinedefConversion::SetLightTag};
-   gMapping[G1ExitLevel] = {Exit_Normal, {0, 0, 0, 0, 0}, PlayerShoots | NoTag};
-   gMapping[G1PlatRaiseNearestChange] = {Plat_RaiseAndStayTx0, {0, 4, 0, 0, 0}, PlayerShoots};
-   gMapping[G1RaiseFloor] = {Floor_RaiseToLowestCeiling, {0, 8, 0, 0, 0}, PlayerShoots};
-   gMapping[G1SecretExit] = {Exit_Secret, {0, 0, 0, 0, 0}, PlayerShoots | NoTag};
-   gMapping[G1StartLineScript] = {ACS_Execute, {0, 0, 0, 0, 0}, PlayerShoots};
-   gMapping[GROpenDoor] = {Door_Open, {0, 16, 0, 0, 0}, PlayerShoots | MonsterShoots | Repeatable};
-   gMapping[GRStartLineScript] = {ACS_Execute, {0, 0, 0, 0, 0}, PlayerShoots | Repeatable};
-   gMapping[S1BOOMRaiseCeilingOrLowerFloor] = {FloorAndCeiling_LowerRaise, {0, 8, 8, 1998, 0}, PlayerUses};
-   gMapping[S1BuildStairsTurbo16] = {Stairs_BuildUpDoom, {0, 32, 16, 0, 0}, PlayerUses};
-   gMapping[S1BuildStairsUp8] = {Stairs_BuildUpDoom, {0, 2, 8, 0, 0}, PlayerUses};
-   gMapping[S1CeilingCrushAndRaise] = {Ceiling_CrushAndRaiseDist, {0, 8, 8, 10, 0}, PlayerUses};
-   gMapping[S1CeilingCrushStop] = {Ceiling_CrushStop, {0, 0, 0, 0, 0}, PlayerUses};
-   gMapping[S1CeilingLowerAndCrush] = {Ceiling_LowerToFloor, {0, 8, 0, 0, 8}, PlayerUses};
-   gMapping[S1CeilingLowerToFloor] = {Ceiling_LowerToFloor, {0, 8, 0, 0, 0}, PlayerUses};
-   gMapping[S1CeilingLowerToLowest] = {Ceiling_LowerToLowest, {0, 8, 0, 0, 0}, PlayerUses};
-   gMapping[S1CeilingLowerToMaxFloor] = {Ceiling_LowerToHighestFloor, {0, 8, 0, 0, 0}, PlayerUses};
-   gMapping[S1ChangeOnlyNumeric] = {Floor_TransferNumeric, {0, 0, 0, 0, 0}, PlayerUses};
-   gMapping[S1ChangeOnly] = {Floor_TransferTrigger, {0, 0, 0, 0, 0}, PlayerUses};
-   gMapping[S1CloseDoor30] = {Door_CloseWaitOpen, {0, 16, 240, 0, 0}, PlayerUses};
-   gMapping[S1CloseDoor] = {Door_Close, {0, 16, 0, 0, 0}, PlayerUses};
-   gMapping[S1DoDonut] = {Floor_Donut, {0, 4, 4, 0, 0}, PlayerUses};
-   gMapping[S1DoorBlazeClose] = {Door_Close, {0, 64, 0, 0, 0}, PlayerUses};
-   gMapping[S1DoorBlazeOpenBlue] = {Door_LockedRaise, {0, 64, 0, EV_LOCKDEF_BLUE, 0}, PlayerUses};
-   gMapping[S1DoorBlazeOpenRed] = {Door_LockedRaise, {0, 64, 0, EV_LOCKDEF_REDGREEN, 0}, PlayerUses};
-   gMapping[S1DoorBlazeOpenYellow] = {Door_LockedRaise, {0, 64, 0, EV_LOCKDEF_YELLOW, 0}, PlayerUses};
-   gMapping[S1DoorBlazeOpen] = {Door_Open, {0, 64, 0, 0, 0}, PlayerUses};
-   gMapping[S1DoorBlazeRaise] = {Door_Raise, {0, 64, 150, 0, 0}, PlayerUses};
-   gMapping[S1ElevatorCurrent] = {Elevator_MoveToFloor, {0, 32, 0, 0, 0}, PlayerUses};
-   gMapping[S1ElevatorDown] = {Elevator_LowerToNearest, {0, 32, 0, 0, 0}, PlayerUses};
-   gMapping[S1ElevatorUp] = {Elevator_RaiseToNearest, {0, 32, 0, 0, 0}, PlayerUses};
-   gMapping[S1ExitLevel] = {Exit_Normal, {0, 0, 0, 0, 0}, PlayerUses | NoTag};
-   gMapping[S1FastCeilCrushRaise] = {Ceiling_CrushAndRaiseDist, {0, 8, 16, 10, 0}, PlayerUses};
-   gMapping[S1FloorLowerAndChange] = {Floor_LowerToLowest, {0, 8, 6, 0, 0}, PlayerUses};
-   gMapping[S1FloorLowerToLowest] = {Floor_LowerToLowest, {0, 8, 0, 0, 0}, PlayerUses};
-   gMapping[S1FloorLowerToNearest] = {Floor_LowerToNearest, {0, 8, 0, 0, 0}, PlayerUses};
-   gMapping[S1FloorRaiseCrush] = {Floor_RaiseToLowestCeiling, {0, 8, 0, 10, 8}, PlayerUses};
-   gMapping[S1FloorRaiseToNearest] = {Floor_RaiseToNearest, {0, 8, 0, 0, 0}, PlayerUses};
-   gMapping[S1FloorRaiseToTexture] = {Floor_RaiseByTexture, {0, 8, 0, 0, 0}, PlayerUses};
-   gMapping[S1LightTurnOn255] = {Light_ChangeToValue, {0, 255, 0, 0, 0}, PlayerUses};
-   gMapping[S1LightTurnOn] = {Light_MaxNeighbor, {0, 0, 0, 0, 0}, PlayerUses};
-   gMapping[S1LightsVeryDark] = {Light_ChangeToValue, {0, 35, 0, 0, 0}, PlayerUses};
-   gMapping[S1LowerFloorTurbo] = {Floor_LowerToHighest, {0, 32, 136, 0, 0}, PlayerUses};
-   gMapping[S1LowerFloor] = {Floor_LowerToHighestEE, {0, 8, 0, 0, 0}, PlayerUses};
-   gMapping[S1OpenDoor] = {Door_Open, {0, 16, 0, 0, 0}, PlayerUses};
-   gMapping[S1PlatBlazeDWUS] = {Plat_DownWaitUpStayLip, {0, 64, 105, 0, 0}, PlayerUses};
-   gMapping[S1PlatDownWaitUpStay] = {Plat_DownWaitUpStayLip, {0, 32, 105, 0, 0}, PlayerUses};
-   gMapping[S1PlatPerpetualRaise] = {Plat_PerpetualRaiseLip, {0, 8, 105, 0, 0}, PlayerUses};
-   gMapping[S1PlatRaise24Change] = {Plat_UpByValueStayTx, {0, 4, 3, 0, 0}, PlayerUses};
-   gMapping[S1PlatRaise32Change] = {Plat_UpByValueStayTx, {0, 4, 4, 0, 0}, PlayerUses};
-   gMapping[S1PlatRaiseNearestChange] = {Plat_RaiseAndStayTx0, {0, 4, 0, 0, 0}, PlayerUses};
-   gMapping[S1PlatStop] = {Plat_Stop, {0, 0, 0, 0, 0}, PlayerUses};
-   gMapping[S1RaiseDoor] = {Door_Raise, {0, 16, 150, 0, 0}, PlayerUses};
-   gMapping[S1RaiseFloor24Change] = {Floor_RaiseByValue, {0, 8, 24, 5, 0}, PlayerUses};
-   gMapping[S1RaiseFloor24] = {Floor_RaiseByValue, {0, 8, 24, 0, 0}, PlayerUses};
-   gMapping[S1RaiseFloor512] = {Floor_RaiseByValue, {0, 8, 512, 0, 0}, PlayerUses};
-   gMapping[S1RaiseFloorTurbo] = {Floor_RaiseToNearest, {0, 32, 0, 0, 0}, PlayerUses};
-   gMapping[S1RaiseFloor] = {Floor_RaiseToLowestCeiling, {0, 8, 0, 0, 0}, PlayerUses};
-   gMapping[S1SecretExit] = {Exit_Secret, {0, 0, 0, 0, 0}, PlayerUses | NoTag};
-   gMapping[S1SilentCrushAndRaise] = {Ceiling_CrushAndRaiseSilentDist, {0, 8, 8, 10, 0}, PlayerUses};
-   gMapping[S1SilentTeleport] = {Teleport_NoFog, {0, 2, 0, 1, 0}, PlayerUses | MonsterUses | TagThird};
-   gMapping[S1StartLightStrobing] = {Light_StrobeDoom, {0, 5, 35, 0, 0}, PlayerUses};
-   gMapping[S1StartLineScript] = {ACS_Execute, {0, 0, 0, 0, 0}, PlayerUses};
-   gMapping[S1Teleport] = {Teleport, {0, 0, 0, 0, 0}, PlayerUses | MonsterUses | TagSecond};
-   gMapping[S1TurnTagLightsOff] = {Light_MinNeighbor, {0, 0, 0, 0, 0}, PlayerCrosses};
-   gMapping[SRBOOMRaiseCeilingOrLowerFloor] = {FloorAndCeiling_LowerRaise, {0, 8, 8, 1998, 0}, PlayerUses | Repeatable};
-   gMapping[SRBuildStairsTurbo16] = {Stairs_BuildUpDoom, {0, 32, 16, 0, 0}, PlayerUses | Repeatable};
-   gMapping[SRBuildStairsUp8] = {Stairs_BuildUpDoom, {0, 2, 8, 0, 0}, PlayerUses | Repeatable};
-   gMapping[SRCeilingCrushAndRaise] = {Ceiling_CrushAndRaiseDist, {0, 8, 8, 10, 0}, PlayerUses | Repeatable};
-   gMapping[SRCeilingCrushStop] = {Ceiling_CrushStop, {0, 0, 0, 0, 0}, PlayerUses | Repeatable};
-   gMapping[SRCeilingLowerAndCrush] = {Ceiling_LowerToFloor, {0, 8, 0, 0, 8}, PlayerUses | Repeatable};
-   gMapping[SRCeilingLowerToFloor] = {Ceiling_LowerToFloor, {0, 8, 0, 0, 0}, PlayerUses | Repeatable};
-   gMapping[SRCeilingLowerToLowest] = {Ceiling_LowerToLowest, {0, 8, 0, 0, 0}, PlayerUses | Repeatable};
-   gMapping[SRCeilingLowerToMaxFloor] = {Ceiling_LowerToHighestFloor, {0, 8, 0, 0, 0}, PlayerUses | Repeatable};
-   gMapping[SRChangeOnlyNumeric] = {Floor_TransferNumeric, {0, 0, 0, 0, 0}, PlayerUses | Repeatable};
-   gMapping[SRChangeOnly] = {Floor_TransferTrigger, {0, 0, 0, 0, 0}, PlayerUses | Repeatable};
-   gMapping[SRCloseDoor30] = {Door_CloseWaitOpen, {0, 16, 240, 0, 0}, PlayerUses | Repeatable};
-   gMapping[SRCloseDoor] = {Door_Close, {0, 16, 0, 0, 0}, PlayerUses | Repeatable};
-   gMapping[SRDoDonut] = {Floor_Donut, {0, 4, 4, 0, 0}, PlayerUses | Repeatable};
-   gMapping[SRDoorBlazeClose] = {Door_Close, {0, 64, 0, 0, 0}, PlayerUses | Repeatable};
-   gMapping[SRDoorBlazeOpenBlue] = {Door_LockedRaise, {0, 64, 0, EV_LOCKDEF_BLUE, 0}, PlayerUses | Repeatable};
-   gMapping[SRDoorBlazeOpenRed] = {Door_LockedRaise, {0, 64, 0, EV_LOCKDEF_REDGREEN, 0}, PlayerUses | Repeatable};
-   gMapping[SRDoorBlazeOpenYellow] = {Door_LockedRaise, {0, 64, 0, EV_LOCKDEF_YELLOW, 0}, PlayerUses | Repeatable};
-   gMapping[SRDoorBlazeOpen] = {Door_Open, {0, 64, 0, 0, 0}, PlayerUses | Repeatable};
-   gMapping[SRDoorBlazeRaise] = {Door_Raise, {0, 64, 150, 0, 0}, PlayerUses | Repeatable};
-   gMapping[SRElevatorCurrent] = {Elevator_MoveToFloor, {0, 32, 0, 0, 0}, PlayerUses | Repeatable};
-   gMapping[SRElevatorDown] = {Elevator_LowerToNearest, {0, 32, 0, 0, 0}, PlayerUses | Repeatable};
-   gMapping[SRElevatorUp] = {Elevator_RaiseToNearest, {0, 32, 0, 0, 0}, PlayerUses | Repeatable};
-   gMapping[SRFastCeilCrushRaise] = {Ceiling_CrushAndRaiseDist, {0, 8, 16, 10, 0}, PlayerUses | Repeatable};
-   gMapping[SRFloorLowerAndChange] = {Floor_LowerToLowest, {0, 8, 6, 0, 0}, PlayerUses | Repeatable};
-   gMapping[SRFloorLowerToLowest] = {Floor_LowerToLowest, {0, 8, 0, 0, 0}, PlayerUses | Repeatable};
-   gMapping[SRFloorLowerToNearest] = {Floor_LowerToNearest, {0, 8, 0, 0, 0}, PlayerUses | Repeatable};
-   gMapping[SRFloorRaiseCrush] = {Floor_RaiseToLowestCeiling, {0, 8, 0, 10, 8}, PlayerUses | Repeatable};
-   gMapping[SRFloorRaiseToNearest] = {Floor_RaiseToNearest, {0, 8, 0, 0, 0}, PlayerUses | Repeatable};
-   gMapping[SRFloorRaiseToTexture] = {Floor_RaiseByTexture, {0, 8, 0, 0, 0}, PlayerUses | Repeatable};
-   gMapping[SRLightTurnOn255] = {Light_ChangeToValue, {0, 255, 0, 0, 0}, PlayerUses | Repeatable};
-   gMapping[SRLightTurnOn] = {Light_MaxNeighbor, {0, 0, 0, 0, 0}, PlayerUses | Repeatable};
-   gMapping[SRLightsVeryDark] = {Light_ChangeToValue, {0, 35, 0, 0, 0}, PlayerUses | Repeatable};
-   gMapping[SRLowerFloorTurbo] = {Floor_LowerToHighest, {0, 32, 136, 0, 0}, PlayerUses | Repeatable};
-   gMapping[SRLowerFloor] = {Floor_LowerToHighestEE, {0, 8, 0, 0, 0}, PlayerUses | Repeatable};
-   gMapping[SROpenDoor] = {Door_Open, {0, 16, 0, 0, 0}, PlayerUses | Repeatable};
-   gMapping[SRPlatBlazeDWUS] = {Plat_DownWaitUpStayLip, {0, 64, 105, 0, 0}, PlayerUses | Repeatable};
-   gMapping[SRPlatDownWaitUpStay] = {Plat_DownWaitUpStayLip, {0, 32, 105, 0, 0}, PlayerUses | Repeatable};
-   gMapping[SRPlatPerpetualRaise] = {Plat_PerpetualRaiseLip, {0, 8, 105, 0, 0}, PlayerUses | Repeatable};
-   gMapping[SRPlatRaise24Change] = {Floor_RaiseByValue, {0, 8, 24, 5, 0}, PlayerUses | Repeatable};
-   gMapping[SRPlatRaise32Change] = {Floor_RaiseByValue, {0, 8, 32, 5, 0}, PlayerUses | Repeatable};
-   gMapping[SRPlatRaiseNearestChange] = {Plat_RaiseAndStayTx0, {0, 4, 0, 0, 0}, PlayerUses | Repeatable};
-   gMapping[SRPlatStop] = {Plat_Stop, {0, 0, 0, 0, 0}, PlayerUses | Repeatable};
-   gMapping[SRPlatToggleUpDown] = {Plat_ToggleCeiling, {0, 0, 0, 0, 0}, PlayerUses | Repeatable};
-   gMapping[SRRaiseDoor] = {Door_Raise, {0, 16, 150, 0, 0}, PlayerUses | Repeatable};
-   gMapping[SRRaiseFloor24Change] = {Floor_RaiseByValue, {0, 8, 24, 5, 0}, PlayerUses | Repeatable};
-   gMapping[SRRaiseFloor24] = {Floor_RaiseByValue, {0, 8, 24, 0, 0}, PlayerUses | Repeatable};
-   gMapping[SRRaiseFloor512] = {Floor_RaiseByValue, {0, 8, 512, 0, 0}, PlayerUses | Repeatable};
-   gMapping[SRRaiseFloorTurbo] = {Floor_RaiseToNearest, {0, 32, 0, 0, 0}, PlayerUses | Repeatable};
-   gMapping[SRRaiseFloor] = {Floor_RaiseToLowestCeiling, {0, 8, 0, 0, 0}, PlayerUses | Repeatable};
-   gMapping[SRSilentCrushAndRaise] = {Ceiling_CrushAndRaiseSilentDist, {0, 8, 8, 10, 0}, PlayerUses | Repeatable};
-   gMapping[SRSilentTeleport] = {Teleport_NoFog, {0, 2, 0, 1, 0}, PlayerUses | MonsterUses | Repeatable | TagThird};
-   gMapping[SRStartLightStrobing] = {Light_StrobeDoom, {0, 5, 35, 0, 0}, PlayerUses | Repeatable};
-   gMapping[SRStartLineScript] = {ACS_Execute, {0, 0, 0, 0, 0}, PlayerUses | Repeatable};
-   gMapping[SRTeleport] = {Teleport, {0, 0, 0, 0, 0}, PlayerUses | MonsterUses | Repeatable | TagSecond};
-   gMapping[SRTurnTagLightsOff] = {Light_MinNeighbor, {0, 0, 0, 0, 0}, PlayerUses | Repeatable};
-   gMapping[W1BuildStairsTurbo16] = {Stairs_BuildUpDoom, {0, 32, 16, 0, 0}, PlayerCrosses};
-   gMapping[W1BuildStairsUp8] = {Stairs_BuildUpDoom, {0, 2, 8, 0, 0}, PlayerCrosses};
-   gMapping[W1CeilingCrushAndRaise] = {Ceiling_CrushAndRaiseDist, {0, 8, 8, 10, 0}, PlayerCrosses};
-   gMapping[W1CeilingCrushStop] = {Ceiling_CrushStop, {0, 0, 0, 0, 0}, PlayerCrosses};
-   gMapping[W1CeilingLowerAndCrush] = {Ceiling_LowerToFloor, {0, 8, 0, 0, 8}, PlayerCrosses};
-   gMapping[W1CeilingLowerToFloor] = {Ceiling_LowerToFloor, {0, 8, 0, 0, 0}, PlayerCrosses};
-   gMapping[W1CeilingLowerToLowest] = {Ceiling_LowerToLowest, {0, 8, 0, 0, 0}, PlayerCrosses};
-   gMapping[W1CeilingLowerToMaxFloor] = {Ceiling_LowerToHighestFloor, {0, 8, 0, 0, 0}, PlayerCrosses};
-   gMapping[W1ChangeOnlyNumeric] = {Floor_TransferNumeric, {0, 0, 0, 0, 0}, PlayerCrosses};
-   gMapping[W1ChangeOnly] = {Floor_TransferTrigger, {0, 0, 0, 0, 0}, PlayerCrosses};
-   gMapping[W1CloseDoor30] = {Door_CloseWaitOpen, {0, 16, 240, 0, 0}, PlayerCrosses};
-   gMapping[W1CloseDoor] = {Door_Close, {0, 16, 0, 0, 0}, PlayerCrosses};
-   gMapping[W1DoDonut] = {Floor_Donut, {0, 4, 4, 0, 0}, PlayerCrosses};
-   gMapping[W1DoorBlazeClose] = {Door_Close, {0, 64, 0, 0, 0}, PlayerCrosses};
-   gMapping[W1DoorBlazeOpen] = {Door_Open, {0, 64, 0, 0, 0}, PlayerCrosses};
-   gMapping[W1DoorBlazeRaise] = {Door_Raise, {0, 64, 150, 0, 0}, PlayerCrosses};
-   gMapping[W1ElevatorCurrent] = {Elevator_MoveToFloor, {0, 32, 0, 0, 0}, PlayerCrosses};
-   gMapping[W1ElevatorDown] = {Elevator_LowerToNearest, {0, 32, 0, 0, 0}, PlayerCrosses};
-   gMapping[W1ElevatorUp] = {Elevator_RaiseToNearest, {0, 32, 0, 0, 0}, PlayerCrosses};
-   gMapping[W1FastCeilCrushRaise] = {Ceiling_CrushAndRaiseDist, {0, 8, 16, 10, 0}, PlayerCrosses};
-   gMapping[W1FloorLowerAndChange] = {Floor_LowerToLowest, {0, 8, 6, 0, 0}, PlayerCrosses};
-   gMapping[W1FloorLowerToLowest] = {Floor_LowerToLowest, {0, 8, 0, 0, 0}, PlayerCrosses};
-   gMapping[W1FloorLowerToNearest] = {Floor_LowerToNearest, {0, 8, 0, 0, 0}, PlayerCrosses};
-   gMapping[W1FloorRaiseCrush] = {Floor_RaiseToLowestCeiling, {0, 8, 0, 10, 8}, PlayerCrosses};
-   gMapping[W1FloorRaiseToNearest] = {Floor_RaiseToNearest, {0, 8, 0, 0, 0}, PlayerCrosses};
-   gMapping[W1FloorRaiseToTexture] = {Floor_RaiseByTexture, {0, 8, 0, 0, 0}, PlayerCrosses};
-   gMapping[W1LightTurnOn255] = {Light_ChangeToValue, {0, 255, 0, 0, 0}, PlayerCrosses};
-   gMapping[W1LightTurnOn] = {Light_MaxNeighbor, {0, 0, 0, 0, 0}, PlayerCrosses};
-   gMapping[W1LightsVeryDark] = {Light_ChangeToValue, {0, 35, 0, 0, 0}, PlayerCrosses};
-   gMapping[W1LowerFloorTurbo] = {Floor_LowerToHighest, {0, 32, 136, 0, 0}, PlayerCrosses};
-   gMapping[W1LowerFloor] = {Floor_LowerToHighestEE, {0, 8, 0, 0, 0}, PlayerCrosses};
-   gMapping[W1OpenDoor] = {Door_Open, {0, 16, 0, 0, 0}, PlayerCrosses};
-   gMapping[W1PlatBlazeDWUS] = {Plat_DownWaitUpStayLip, {0, 64, 105, 0, 0}, PlayerCrosses};
-   gMapping[W1PlatDownWaitUpStay] = {Plat_DownWaitUpStayLip, {0, 32, 105, 0, 0}, PlayerCrosses | MonsterCrosses};
-   gMapping[W1PlatPerpetualRaise] = {Plat_PerpetualRaiseLip, {0, 8, 105, 0, 0}, PlayerCrosses};
-   gMapping[W1PlatRaise24Change] = {Plat_UpByValueStayTx, {0, 4, 3, 0, 0}, PlayerCrosses};
-   gMapping[W1PlatRaise32Change] = {Plat_UpByValueStayTx, {0, 4, 4, 0, 0}, PlayerCrosses};
-   gMapping[W1PlatRaiseNearestChange] = {Plat_RaiseAndStayTx0, {0, 4, 0, 0, 0}, PlayerCrosses};
-   gMapping[W1PlatStop] = {Plat_Stop, {0, 0, 0, 0, 0}, PlayerCrosses};
-   gMapping[W1RaiseCeilingLowerFloor] = {Ceiling_RaiseToHighest, {0, 8, 0, 0, 0}, PlayerCrosses};
-   gMapping[W1RaiseDoor] = {Door_Raise, {0, 16, 150, 0, 0}, PlayerCrosses | MonsterCrosses};
-   gMapping[W1RaiseFloor24Change] = {Floor_RaiseByValue, {0, 8, 24, 5, 0}, PlayerCrosses};
-   gMapping[W1RaiseFloor24] = {Floor_RaiseByValue, {0, 8, 24, 0, 0}, PlayerCrosses};
-   gMapping[W1RaiseFloor512] = {Floor_RaiseByValue, {0, 8, 512, 0, 0}, PlayerCrosses};
-   gMapping[W1RaiseFloorTurbo] = {Floor_RaiseToNearest, {0, 32, 0, 0, 0}, PlayerCrosses};
-   gMapping[W1RaiseFloor] = {Floor_RaiseToLowestCeiling, {0, 8, 0, 0, 0}, PlayerCrosses};
-   gMapping[W1SilentCrushAndRaise] = {Ceiling_CrushAndRaiseSilentDist, {0, 8, 8, 10, 0}, PlayerCrosses};
-   gMapping[W1SilentLineTRMonsters] = {Teleport_Line, {0, 0, 1, 0, 0}, MonsterCrosses | TagSecond};
-   gMapping[W1SilentLineTeleMonsters] = {Teleport_Line, {0, 0, 0, 0, 0}, MonsterCrosses | TagSecond};
-   gMapping[W1SilentLineTeleportReverse] = {Teleport_Line, {0, 0, 1, 0, 0}, PlayerCrosses | MonsterCrosses | TagSecond};
-   gMapping[W1SilentLineTeleport] = {Teleport_Line, {0, 0, 0, 0, 0}, PlayerCrosses | MonsterCrosses | TagSecond};
-   gMapping[W1SilentTeleportMonsters] = {Teleport_NoFog, {0, 2, 0, 1, 0}, MonsterCrosses | TagThird};
-   gMapping[W1SilentTeleport] = {Teleport_NoFog, {0, 2, 0, 1, 0}, PlayerCrosses | MonsterCrosses | TagThird};
-   gMapping[W1StartLightStrobing] = {Light_StrobeDoom, {0, 5, 35, 0, 0}, PlayerCrosses};
-   gMapping[W1StartLineScript1S] = {ACS_Execute, {0, 0, 0, 0, 0}, PlayerCrosses | FirstSide};
-   gMapping[W1StartLineScript] = {ACS_Execute, {0, 0, 0, 0, 0}, PlayerCrosses};
-   gMapping[W1TeleportMonsters] = {Teleport, {0, 0, 0, 0, 0}, MonsterCrosses | TagSecond};
-   gMapping[W1Teleport] = {Teleport, {0, 0, 0, 0, 0}, PlayerCrosses | MonsterCrosses | TagSecond};
-   gMapping[W1TurnTagLightsOff] = {Light_MinNeighbor, {0, 0, 0, 0, 0}, PlayerCrosses};
-   gMapping[WRBuildStairsTurbo16] = {Stairs_BuildUpDoom, {0, 32, 16, 0, 0}, PlayerCrosses | Repeatable};
-   gMapping[WRBuildStairsUp8] = {Stairs_BuildUpDoom, {0, 2, 8, 0, 0}, PlayerCrosses | Repeatable};
-   gMapping[WRCeilingCrushAndRaise] = {Ceiling_CrushAndRaiseDist, {0, 8, 8, 10, 0}, PlayerCrosses | Repeatable};
-   gMapping[WRCeilingCrushStop] = {Ceiling_CrushStop, {0, 0, 0, 0, 0}, PlayerCrosses | Repeatable};
-   gMapping[WRCeilingLowerAndCrush] = {Ceiling_LowerToFloor, {0, 8, 0, 0, 8}, PlayerCrosses | Repeatable};
-   gMapping[WRCeilingLowerToFloor] = {Ceiling_LowerToFloor, {0, 8, 0, 0, 0}, PlayerCrosses | Repeatable};
-   gMapping[WRCeilingLowerToLowest] = {Ceiling_LowerToLowest, {0, 8, 0, 0, 0}, PlayerCrosses | Repeatable};
-   gMapping[WRCeilingLowerToMaxFloor] = {Ceiling_LowerToHighestFloor, {0, 8, 0, 0, 0}, PlayerCrosses | Repeatable};
-   gMapping[WRChangeOnlyNumeric] = {Floor_TransferNumeric, {0, 0, 0, 0, 0}, PlayerCrosses | Repeatable};
-   gMapping[WRChangeOnly] = {Floor_TransferTrigger, {0, 0, 0, 0, 0}, PlayerCrosses | Repeatable};
-   gMapping[WRCloseDoor30] = {Door_CloseWaitOpen, {0, 16, 240, 0, 0}, PlayerCrosses | Repeatable};
-   gMapping[WRCloseDoor] = {Door_Close, {0, 16, 0, 0, 0}, PlayerCrosses | Repeatable};
-   gMapping[WRDoDonut] = {Floor_Donut, {0, 4, 4, 0, 0}, PlayerCrosses | Repeatable};
-   gMapping[WRDoorBlazeClose] = {Door_Close, {0, 64, 0, 0, 0}, PlayerCrosses | Repeatable};
-   gMapping[WRDoorBlazeOpen] = {Door_Open, {0, 64, 0, 0, 0}, PlayerCrosses | Repeatable};
-   gMapping[WRDoorBlazeRaise] = {Door_Raise, {0, 64, 150, 0, 0}, PlayerCrosses | Repeatable};
-   gMapping[WRElevatorCurrent] = {Elevator_MoveToFloor, {0, 32, 0, 0, 0}, PlayerCrosses | Repeatable};
-   gMapping[WRElevatorDown] = {Elevator_LowerToNearest, {0, 32, 0, 0, 0}, PlayerCrosses | Repeatable};
-   gMapping[WRElevatorUp] = {Elevator_RaiseToNearest, {0, 32, 0, 0, 0}, PlayerCrosses | Repeatable};
-   gMapping[WRExitLevel] = {Exit_Normal, {0, 0, 0, 0, 0}, PlayerCrosses | NoTag};
-   gMapping[WRFastCeilCrushRaise] = {Ceiling_CrushAndRaiseDist, {0, 8, 16, 10, 0}, PlayerCrosses | Repeatable};
-   gMapping[WRFloorLowerAndChange] = {Floor_LowerToLowest, {0, 8, 6, 0, 0}, PlayerCrosses | Repeatable};
-   gMapping[WRFloorLowerToLowest] = {Floor_LowerToLowest, {0, 8, 0, 0, 0}, PlayerCrosses | Repeatable};
-   gMapping[WRFloorLowerToNearest] = {Floor_LowerToNearest, {0, 8, 0, 0, 0}, PlayerCrosses | Repeatable};
-   gMapping[WRFloorRaiseCrush] = {Floor_RaiseToLowestCeiling, {0, 8, 0, 10, 8}, PlayerCrosses | Repeatable};
-   gMapping[WRFloorRaiseToNearest] = {Floor_RaiseToNearest, {0, 8, 0, 0, 0}, PlayerCrosses | Repeatable};
-   gMapping[WRFloorRaiseToTexture] = {Floor_RaiseByTexture, {0, 8, 0, 0, 0}, PlayerCrosses | Repeatable};
-   gMapping[WRLightTurnOn255] = {Light_ChangeToValue, {0, 255, 0, 0, 0}, PlayerCrosses | Repeatable};
-   gMapping[WRLightTurnOn] = {Light_MaxNeighbor, {0, 0, 0, 0, 0}, PlayerCrosses | Repeatable};
-   gMapping[WRLightsVeryDark] = {Light_ChangeToValue, {0, 35, 0, 0, 0}, PlayerCrosses | Repeatable};
-   gMapping[WRLowerFloorTurbo] = {Floor_LowerToHighest, {0, 32, 136, 0, 0}, PlayerCrosses | Repeatable};
-   gMapping[WRLowerFloor] = {Floor_LowerToHighestEE, {0, 8, 0, 0, 0}, PlayerCrosses | Repeatable};
-   gMapping[WROpenDoor] = {Door_Open, {0, 16, 0, 0, 0}, PlayerCrosses | Repeatable};
-   gMapping[WRPlatBlazeDWUS] = {Plat_DownWaitUpStayLip, {0, 64, 105, 0, 0}, PlayerCrosses | Repeatable};
-   gMapping[WRPlatDownWaitUpStay] = {Plat_DownWaitUpStayLip, {0, 32, 105, 0, 0}, PlayerCrosses | MonsterCrosses | Repeatable};
-   gMapping[WRPlatPerpetualRaise] = {Plat_PerpetualRaiseLip, {0, 8, 105, 0, 0}, PlayerCrosses | Repeatable};
-   gMapping[WRPlatRaise24Change] = {Plat_UpByValueStayTx, {0, 4, 3, 0, 0}, PlayerCrosses | Repeatable};
-   gMapping[WRPlatRaise32Change] = {Plat_UpByValueStayTx, {0, 4, 3, 0, 0}, PlayerCrosses | Repeatable};
-   gMapping[WRPlatRaiseNearestChange] = {Plat_RaiseAndStayTx0, {0, 4, 0, 0, 0}, PlayerCrosses | Repeatable};
-   gMapping[WRPlatStop] = {Plat_Stop, {0, 0, 0, 0, 0}, PlayerCrosses | Repeatable};
-   gMapping[WRPlatToggleUpDown] = {Plat_ToggleCeiling, {0, 0, 0, 0, 0}, PlayerCrosses | Repeatable};
-   gMapping[WRRaiseCeilingLowerFloor] = {Ceiling_RaiseToHighest, {0, 8, 0, 0, 0}, PlayerCrosses | Repeatable};
-   gMapping[WRRaiseDoor] = {Door_Raise, {0, 16, 150, 0, 0}, PlayerCrosses | Repeatable};
-   gMapping[WRRaiseFloor24Change] = {Floor_RaiseByValue, {0, 8, 24, 5, 0}, PlayerCrosses | Repeatable};
-   gMapping[WRRaiseFloor24] = {Floor_RaiseByValue, {0, 8, 24, 0, 0}, PlayerCrosses | Repeatable};
-   gMapping[WRRaiseFloor512] = {Floor_RaiseByValue, {0, 8, 512, 0, 0}, PlayerCrosses | Repeatable};
-   gMapping[WRRaiseFloorTurbo] = {Floor_RaiseToNearest, {0, 32, 0, 0, 0}, PlayerCrosses | Repeatable};
-   gMapping[WRRaiseFloor] = {Floor_RaiseToLowestCeiling, {0, 8, 0, 0, 0}, PlayerCrosses | Repeatable};
-   gMapping[WRSecretExit] = {Exit_Secret, {0, 0, 0, 0, 0}, PlayerCrosses | NoTag};
-   gMapping[WRSilentCrushAndRaise] = {Ceiling_CrushAndRaiseSilentDist, {0, 8, 8, 10, 0}, PlayerCrosses | Repeatable};
-   gMapping[WRSilentLineTRMonsters] = {Teleport_Line, {0, 0, 1, 0, 0}, MonsterCrosses | Repeatable | TagSecond};
-   gMapping[WRSilentLineTeleMonsters] = {Teleport_Line, {0, 0, 0, 0, 0}, MonsterCrosses | Repeatable | TagSecond};
-   gMapping[WRSilentLineTeleportReverse] = {Teleport_Line, {0, 0, 1, 0, 0}, PlayerCrosses | MonsterCrosses | Repeatable | TagSecond};
-   gMapping[WRSilentLineTeleport] = {Teleport_Line, {0, 0, 0, 0, 0}, PlayerCrosses | MonsterCrosses | Repeatable | TagSecond};
-   gMapping[WRSilentTeleportMonsters] = {Teleport_NoFog, {0, 2, 0, 1, 0}, MonsterCrosses | Repeatable | TagThird};
-   gMapping[WRSilentTeleport] = {Teleport_NoFog, {0, 2, 0, 1, 0}, PlayerCrosses | MonsterCrosses | Repeatable | TagThird};
-   gMapping[WRStartLightStrobing] = {Light_StrobeDoom, {0, 5, 35, 0, 0}, PlayerCrosses | Repeatable};
-   gMapping[WRStartLineScript1S] = {ACS_Execute, {0, 0, 0, 0, 0}, PlayerCrosses | Repeatable | FirstSide};
-   gMapping[WRStartLineScript] = {ACS_Execute, {0, 0, 0, 0, 0}, PlayerCrosses | Repeatable};
-   gMapping[WRTeleportMonsters] = {Teleport, {0, 0, 0, 0, 0}, MonsterCrosses | Repeatable | TagSecond};
-   gMapping[WRTeleport] = {Teleport, {0, 0, 0, 0, 0}, PlayerCrosses | MonsterCrosses | Repeatable | TagSecond};
-   gMapping[WRTurnTagLightsOff] = {Light_MinNeighbor, {0, 0, 0, 0, 0}, PlayerCrosses | Repeatable};
-
-   gMapping[EV_STATIC_3DMIDTEX_ATTACH_CEILING] = {Sector_Attach3dMidtex, {0, 0, 1, 0, 0}};
-   gMapping[EV_STATIC_3DMIDTEX_ATTACH_FLOOR] = {Sector_Attach3dMidtex, {0, 0, 0, 0, 0}};
-   gMapping[EV_STATIC_ATTACH_CEILING_TO_CONTROL] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::AttachToControl};
-   gMapping[EV_STATIC_ATTACH_FLOOR_TO_CONTROL] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::AttachToControl};
-   gMapping[EV_STATIC_ATTACH_MIRROR_CEILING] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::AttachToControl};
-   gMapping[EV_STATIC_ATTACH_MIRROR_FLOOR] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::AttachToControl};
-   gMapping[EV_STATIC_ATTACH_SET_CEILING_CONTROL] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::SetSurfaceControl};
-   gMapping[EV_STATIC_ATTACH_SET_FLOOR_CONTROL] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::SetSurfaceControl};
-   gMapping[EV_STATIC_CARRY_ACCEL_FLOOR] = {Scroll_Floor, {0, 5, 1, 0, 0}};
-   gMapping[EV_STATIC_CARRY_DISPLACE_FLOOR] = {Scroll_Floor, {0, 6, 1, 0, 0}};
-   gMapping[EV_STATIC_CARRY_FLOOR] = {Scroll_Floor, {0, 4, 1, 0, 0}};
-   gMapping[EV_STATIC_CURRENT_CONTROL] = {Sector_SetCurrent, {0, 0, 0, 1, 0}};
-   gMapping[EV_STATIC_EXTRADATA_LINEDEF] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::ResolveLineExtraData};
-   gMapping[EV_STATIC_EXTRADATA_SECTOR] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::ResolveSectorExtraData};
-   gMapping[EV_STATIC_FRICTION_TRANSFER] = {Sector_SetFriction};
-   gMapping[EV_STATIC_HERETIC_CURRENT] = {Sector_SetCurrent, {0, 0, 0, 3, 0}};
-   gMapping[EV_STATIC_HERETIC_WIND] = {Sector_SetWind, {0, 0, 0, 3, 0}};
-   gMapping[EV_STATIC_LIGHT_TRANSFER_CEILING] = {Transfer_CeilingLight};
-   gMapping[EV_STATIC_LIGHT_TRANSFER_FLOOR] = {Transfer_FloorLight};
-   gMapping[EV_STATIC_LINE_SET_IDENTIFICATION] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::SetLineID};
-   gMapping[EV_STATIC_PORTAL_ANCHORED_CEILING] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::PortalDefine};
-   gMapping[EV_STATIC_PORTAL_ANCHORED_CEILING_FLOOR] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::PortalDefine};
-   gMapping[EV_STATIC_PORTAL_ANCHORED_FLOOR] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::PortalDefine};
-   gMapping[EV_STATIC_PORTAL_ANCHOR] = {};
-   gMapping[EV_STATIC_PORTAL_ANCHOR_FLOOR] = {};
-   gMapping[EV_STATIC_PORTAL_APPLY_FRONTSECTOR] = {};
-   gMapping[EV_STATIC_PORTAL_HORIZON_CEILING] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::PortalDefine};
-   gMapping[EV_STATIC_PORTAL_HORIZON_CEILING_FLOOR] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::PortalDefine};
-   gMapping[EV_STATIC_PORTAL_HORIZON_FLOOR] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::PortalDefine};
-   gMapping[EV_STATIC_PORTAL_HORIZON_LINE] = {Line_Horizon};
-   gMapping[EV_STATIC_PORTAL_LINE] = {};
-   gMapping[EV_STATIC_PORTAL_LINKED_ANCHOR] = {};
-   gMapping[EV_STATIC_PORTAL_LINKED_ANCHOR_FLOOR] = {};
-   gMapping[EV_STATIC_PORTAL_LINKED_CEILING] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::PortalDefine};
-   gMapping[EV_STATIC_PORTAL_LINKED_FLOOR] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::PortalDefine};
-   gMapping[EV_STATIC_PORTAL_LINKED_L2L_ANCHOR] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::QuickLinePortal};
-   gMapping[EV_STATIC_PORTAL_LINKED_LINE2LINE] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::QuickLinePortal};
-   gMapping[EV_STATIC_PORTAL_PLANE_CEILING] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::PortalDefine};
-   gMapping[EV_STATIC_PORTAL_PLANE_CEILING_FLOOR] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::PortalDefine};
-   gMapping[EV_STATIC_PORTAL_PLANE_FLOOR] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::PortalDefine};
-   gMapping[EV_STATIC_PORTAL_SKYBOX_CEILING] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::PortalDefine};
-   gMapping[EV_STATIC_PORTAL_SKYBOX_CEILING_FLOOR] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::PortalDefine};
-   gMapping[EV_STATIC_PORTAL_SKYBOX_FLOOR] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::PortalDefine};
-   gMapping[EV_STATIC_PORTAL_TWOWAY_CEILING] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::PortalDefine};
-   gMapping[EV_STATIC_PORTAL_TWOWAY_FLOOR] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::PortalDefine};
-   gMapping[EV_STATIC_PUSHPULL_CONTROL] = {PointPush_SetForce, {0, 0, 0, 1, 0}};
-   gMapping[EV_STATIC_SCROLL_ACCEL_CEILING] = {Scroll_Ceiling, {0, 5, 0, 0, 0}};
-   gMapping[EV_STATIC_SCROLL_ACCEL_FLOOR] = {Scroll_Floor, {0, 5, 0, 0, 0}};
-   gMapping[EV_STATIC_SCROLL_ACCEL_WALL] = {Scroll_Texture_Model, {0, 1, 0, 0, 0}};
-   gMapping[EV_STATIC_SCROLL_BY_OFFSETS] = {Scroll_Texture_Offsets};
-   gMapping[EV_STATIC_SCROLL_CARRY_ACCEL_FLOOR] = {Scroll_Floor, {0, 5, 2, 0, 0}};
-   gMapping[EV_STATIC_SCROLL_CARRY_DISPLACE_FLOOR] = {Scroll_Floor, {0, 6, 2, 0, 0}};
-   gMapping[EV_STATIC_SCROLL_CARRY_FLOOR] = {Scroll_Floor, {0, 4, 2, 0, 0}};
-   gMapping[EV_STATIC_SCROLL_CEILING] = {Scroll_Ceiling, {0, 4, 0, 0, 0}};
-   gMapping[EV_STATIC_SCROLL_DISPLACE_CEILING] = {Scroll_Ceiling, {0, 6, 0, 0, 0}};
-   gMapping[EV_STATIC_SCROLL_DISPLACE_FLOOR] = {Scroll_Floor, {0, 6, 0, 0, 0}};
-   gMapping[EV_STATIC_SCROLL_DISPLACE_WALL] = {Scroll_Texture_Model, {0, 2, 0, 0, 0}};
-   gMapping[EV_STATIC_SCROLL_FLOOR] = {Scroll_Floor, {0, 4, 0, 0, 0}};
-   gMapping[EV_STATIC_SCROLL_LINE_DOWN] = {Scroll_Texture_Down, {64, 0, 0, 0, 0}, NoTag};
-   gMapping[EV_STATIC_SCROLL_LINE_DOWN_FAST] = {Scroll_Texture_Down, {192, 0, 0, 0, 0}, NoTag};
-   gMapping[EV_STATIC_SCROLL_LINE_LEFT] = {Scroll_Texture_Left, {64, 0, 0, 0, 0}, NoTag};
-   gMapping[EV_STATIC_SCROLL_LINE_RIGHT] = {Scroll_Texture_Right, {64, 0, 0, 0, 0}, NoTag};
-   gMapping[EV_STATIC_SCROLL_LINE_UP] = {Scroll_Texture_Up, {64, 0, 0, 0, 0}, NoTag};
-   gMapping[EV_STATIC_SCROLL_WALL_WITH] = {Scroll_Texture_Model, {0, 0, 0, 0, 0}};
-   gMapping[EV_STATIC_SKY_TRANSFER] = {Static_Init, {0, 255, 0, 0, 0}};
-   gMapping[EV_STATIC_SKY_TRANSFER_FLIPPED] = {Static_Init, {0, 255, 1, 0, 0}};
-   gMapping[EV_STATIC_SLOPE_BACKFLOOR_FRONTCEILING] = {Plane_Align, {2, 1, 0, 0, 0}, NoTag};
-   gMapping[EV_STATIC_SLOPE_BSEC_CEILING] = {Plane_Align, {0, 2, 0, 0, 0}, NoTag};
-   gMapping[EV_STATIC_SLOPE_BSEC_FLOOR] = {Plane_Align, {2, 0, 0, 0, 0}, NoTag};
-   gMapping[EV_STATIC_SLOPE_BSEC_FLOOR_CEILING] = {Plane_Align, {2, 2, 0, 0, 0}, NoTag};
-   gMapping[EV_STATIC_SLOPE_FRONTCEILING_TAG] = {Plane_Copy, {0, 0, 0, 0, 0}, TagSecond};
-   gMapping[EV_STATIC_SLOPE_FRONTFLOORCEILING_TAG] = {Plane_Copy, {0, 0, 0, 0, 0}, TagFirstSecond};
-   gMapping[EV_STATIC_SLOPE_FRONTFLOOR_BACKCEILING] = {Plane_Align, {1, 2, 0, 0, 0}, NoTag};
-   gMapping[EV_STATIC_SLOPE_FRONTFLOOR_TAG] = {Plane_Copy, {0, 0, 0, 0, 0}};
-   gMapping[EV_STATIC_SLOPE_FSEC_CEILING] = {Plane_Align, {0, 1, 0, 0, 0}, NoTag};
-   gMapping[EV_STATIC_SLOPE_FSEC_FLOOR] = {Plane_Align, {1, 0, 0, 0, 0}, NoTag};
-   gMapping[EV_STATIC_SLOPE_FSEC_FLOOR_CEILING] = {Plane_Align, {1, 1, 0, 0, 0}, NoTag};
-   gMapping[EV_STATIC_TRANSFER_HEIGHTS] = {Transfer_Heights};
-   gMapping[EV_STATIC_TRANSLUCENT] = {0, {0, 0, 0, 0, 0}, 0, &LinedefConversion::TranslucentLine};
-   gMapping[EV_STATIC_WIND_CONTROL] = {Sector_SetWind, {0, 0, 0, 1, 0}};
+   uint64_t hash = 14695981039346656037ull;
+   for(; *name; ++name)
+   {
+      hash ^= static_cast<uint8_t>(ED_lowerCase(*name));
+      hash *= 1099511628211ull;
+   }
+   return hash;
 }
 
-void InitExtraDataMappings()
+//
+// Perfect hash of the ExtraData special names, built at compile time by hash
+// and displace: names are split into buckets, and each bucket gets the first
+// displacement which sends all its names to free slots.
+//
+class EDNameHash
+{
+public:
+   constexpr EDNameHash();
+
+   UdmfSpecial Get(const char *name) const
+   {
+      int index = mSlots[Slot(ED_hashName(name))];
+      if(index < 0)
+         return static_cast<UdmfSpecial>(0);
+      const char *entry = gEDNames[index].name;
+      for(; *name; ++name, ++entry)
+         if(ED_lowerCase(*name) != *entry)
+            return static_cast<UdmfSpecial>(0);
+      return *entry ? static_cast<UdmfSpecial>(0) : gEDNames[index].special;
+   }
+
+private:
+   static const int NumNames = lengthof(gEDNames);
+   static const int NumBuckets = 64;
+   static const int NumSlots = 256;
+
+   static constexpr int Bucket(uint64_t hash)
+   {
+      return static_cast<int>(hash % NumBuckets);
+   }
+
+   static constexpr int Slot(uint64_t hash, int displacement)
+   {
+      // odd step, so every displacement gives a different slot
+      uint64_t step = (hash >> 40) % NumSlots | 1;
+      return static_cast<int>(((hash >> 20) + displacement * step) % NumSlots);
+   }
+
+   constexpr int Slot(uint64_t hash) const
+   {
+      return Slot(hash, mDisplacements[Bucket(hash)]);
+   }
+
+   int mDisplacements[NumBuckets] = {};
+   int mSlots[NumSlots] = {};
+};
+
+constexpr EDNameHash::EDNameHash()
+{
+   uint64_t hashes[NumNames] = {};
+   int bucketSizes[NumBuckets] = {};
+   for(int i = 0; i < NumNames; ++i)
+   {
+      hashes[i] = ED_hashName(gEDNames[i].name);
+      ++bucketSizes[Bucket(hashes[i])];
+   }
+   for(int &slot : mSlots)
+      slot = -1;
+
+   // Place the largest buckets first, while there's most room
+   bool placed[NumBuckets] = {};
+   for(int round = 0; round < NumBuckets; ++round)
+   {
+      int bucket = -1;
+      for(int i = 0; i < NumBuckets; ++i)
+         if(!placed[i] && (bucket < 0 || bucketSizes[i] > bucketSizes[bucket]))
+            bucket = i;
+      placed[bucket] = true;
+      if(!bucketSizes[bucket])
+         continue;
+
+      for(int displacement = 0; ; ++displacement)
+      {
+         if(displacement == NumSlots)
+            throw "ExtraData special names have no perfect hash";
+         int slots[NumNames] = {};
+         int count = 0;
+         bool fits = true;
+         for(int i = 0; i < NumNames && fits; ++i)
+         {
+            if(Bucket(hashes[i]) != bucket)
+               continue;
+            int slot = Slot(hashes[i], displacement);
+            if(mSlots[slot] >= 0)
+               fits = false;
+            for(int j = 0; j < count && fits; ++j)
+               if(slots[j] == slot)
+                  fits = false;
+            slots[count++] = slot;
+         }
+         if(!fits)
+            continue;
+         mDisplacements[bucket] = displacement;
+         for(int i = 0; i < NumNames; ++i)
+            if(Bucket(hashes[i]) == bucket)
+               mSlots[Slot(hashes[i], displacement)] = i;
+         break;
+      }
+   }
+}
+
+static constexpr EDNameHash gEDMapping;
+
+//
+// Boom generalized specials, translated to the UDMF Generic_* specials. The
+// speeds are in UDMF units of 1/8 map unit per tic and the door and lift
+// delays in 1/8 seconds.
+//
+static const int gGenFloorSpeeds[] = { 8, 16, 32, 64 };
+static const int gGenDoorSpeeds[] = { 16, 32, 64, 128 };
+static const int gGenDoorDelays[] = { 8, 32, 72, 240 };
+static const int gGenLiftSpeeds[] = { 16, 32, 64, 128 };
+static const int gGenLiftDelays[] = { 8, 24, 40, 80 };
+static const int gGenStairSpeeds[] = { 2, 4, 16, 32 };
+static const int gGenStairSteps[] = { 4, 8, 16, 24 };
+static const int gGenLockedDoorDelay = 34;   // 150 tics, like the classic doors
+
+// Locks for the key field of locked doors, by whether skulls and cards are
+// told apart
+static const int gGenLocks[2][8] =
+{
+   { EV_LOCKDEF_ANYKEY, EV_LOCKDEF_REDGREEN, EV_LOCKDEF_BLUE, EV_LOCKDEF_YELLOW,
+      EV_LOCKDEF_REDGREEN, EV_LOCKDEF_BLUE, EV_LOCKDEF_YELLOW, EV_LOCKDEF_ALL3 },
+   { EV_LOCKDEF_ANYKEY, EV_LOCKDEF_REDCARD, EV_LOCKDEF_BLUECARD,
+      EV_LOCKDEF_YELLOWCARD, EV_LOCKDEF_REDSKULL, EV_LOCKDEF_BLUESKULL,
+      EV_LOCKDEF_YELLOWSKULL, EV_LOCKDEF_ALL6 },
+};
+
+//
+// Activation flags from the trigger field of a generalized special
+//
+static unsigned GenTriggerFlags(int special, bool monsters)
+{
+   int trigger = (special & TriggerType) >> TriggerTypeShift;
+   unsigned flags;
+   switch(trigger >> 1)
+   {
+      case 0:  // W1, WR
+         flags = PlayerCrosses | (monsters ? MonsterCrosses : 0);
+         break;
+      case 1:  // S1, SR
+         flags = PlayerUses | (monsters ? MonsterUses : 0);
+         break;
+      case 2:  // G1, GR
+         flags = PlayerShoots | (monsters ? MonsterShoots : 0);
+         break;
+      default: // D1, DR: manual, acting on the back sector
+         flags = PlayerUses | (monsters ? MonsterUses : 0) | NoTag;
+         break;
+   }
+   if(trigger & 1)
+      flags |= Repeatable;
+   return flags;
+}
+
+//
+// Floors and ceilings share the field layout and the Generic_* arguments. The
+// model bit means monster activation when nothing changes.
+//
+static void GenDecodePlane(int special, UdmfSpecial udmfSpecial,
+                           UdmfSpecialTarget &target)
+{
+   int change = (special & FloorChange) >> FloorChangeShift;
+   bool model = !!(special & FloorModel);
+   int floorTarget = (special & FloorTarget) >> FloorTargetShift;
+   int flags = change;
+   if(change && model)
+      flags |= 4;
+   if(special & FloorDirection)
+      flags |= 8;
+   if(special & FloorCrush)
+      flags |= 16;
+
+   target.special = udmfSpecial;
+   target.args[1] = gGenFloorSpeeds[(special & FloorSpeed) >> FloorSpeedShift];
+   // the last two targets are by 24 and by 32 units
+   target.args[2] = floorTarget == 6 ? 24 : floorTarget == 7 ? 32 : 0;
+   target.args[3] = floorTarget < 6 ? floorTarget + 1 : 0;
+   target.args[4] = flags;
+   target.flags = GenTriggerFlags(special, !change && model);
+}
+
+static void GenDecodeDoor(int special, UdmfSpecialTarget &target)
+{
+   target.special = Generic_Door;
+   target.args[1] = gGenDoorSpeeds[(special & DoorSpeed) >> DoorSpeedShift];
+   target.args[2] = (special & DoorKind) >> DoorKindShift;
+   target.args[3] = gGenDoorDelays[(special & DoorDelay) >> DoorDelayShift];
+   target.flags = GenTriggerFlags(special, !!(special & DoorMonster));
+}
+
+static void GenDecodeLockedDoor(int special, UdmfSpecialTarget &target)
+{
+   target.special = Generic_Door;
+   target.args[1] = gGenDoorSpeeds[(special & LockedSpeed) >> LockedSpeedShift];
+   // open-wait-close or open-stay
+   target.args[2] = (special & LockedKind) >> LockedKindShift;
+   target.args[3] = gGenLockedDoorDelay;
+   target.args[4] = gGenLocks[(special & LockedNKeys) >> LockedNKeysShift]
+                             [(special & LockedKey) >> LockedKeyShift];
+   target.flags = GenTriggerFlags(special, false);
+}
+
+static void GenDecodeLift(int special, UdmfSpecialTarget &target)
+{
+   target.special = Generic_Lift;
+   target.args[1] = gGenLiftSpeeds[(special & LiftSpeed) >> LiftSpeedShift];
+   target.args[2] = gGenLiftDelays[(special & LiftDelay) >> LiftDelayShift];
+   target.args[3] = ((special & LiftTarget) >> LiftTargetShift) + 1;
+   target.flags = GenTriggerFlags(special, !!(special & LiftMonster));
+}
+
+static void GenDecodeStairs(int special, UdmfSpecialTarget &target)
+{
+   target.special = Generic_Stairs;
+   target.args[1] = gGenStairSpeeds[(special & StairSpeed) >> StairSpeedShift];
+   target.args[2] = gGenStairSteps[(special & StairStep) >> StairStepShift];
+   target.args[3] = (special & StairDirection ? 1 : 0) |
+   (special & StairIgnore ? 2 : 0);
+   target.flags = GenTriggerFlags(special, !!(special & StairMonster));
+}
+
+static void GenDecodeCrusher(int special, UdmfSpecialTarget &target)
+{
+   target.special = Generic_Crusher;
+   target.args[1] = target.args[2] =
+   gGenFloorSpeeds[(special & CrusherSpeed) >> CrusherSpeedShift];
+   target.args[3] = (special & CrusherSilent) >> CrusherSilentShift;
+   target.args[4] = 10; // damage
+   target.flags = GenTriggerFlags(special, !!(special & CrusherMonster));
+}
+
+//
+// Table of all the generalized specials, decoded once on first use
+//
+class GeneralizedMappingTable
+{
+public:
+   GeneralizedMappingTable();
+
+   const UdmfSpecialTarget *Get(int special) const
+   {
+      return &mTargets[special - GenCrusherBase];
+   }
+
+private:
+   UdmfSpecialTarget mTargets[GenEnd - GenCrusherBase] = {};
+};
+
+GeneralizedMappingTable::GeneralizedMappingTable()
 {
-   gEDMapping["acs_execute"] = ACS_Execute;
-   gEDMapping["acs_executealways"] = ACS_ExecuteAlways;
-   gEDMapping["acs_executewithresult"] = ACS_ExecuteWithResult;
-   gEDMapping["acs_lockedexecute"] = ACS_LockedExecute;
-   gEDMapping["acs_lockedexecutedoor"] = ACS_LockedExecuteDoor;
-   gEDMapping["acs_suspend"] = ACS_Suspend;
-   gEDMapping["acs_terminate"] = ACS_Terminate;
-   gEDMapping["ceiling_crushandraise"] = Ceiling_CrushAndRaise;
-   gEDMapping["ceiling_crushandraisea"] = Ceiling_CrushAndRaiseA;
-   gEDMapping["ceiling_crushandraisedist"] = Ceiling_CrushAndRaiseDist;
-   gEDMapping["ceiling_crushandraisesilenta"] = Ceiling_CrushAndRaiseSilentA;
-   gEDMapping["ceiling_crushandraisesilentdist"] = Ceiling_CrushAndRaiseSilentDist;
-   gEDMapping["ceiling_crushraiseandstay"] = Ceiling_CrushRaiseAndStay;
-   gEDMapping["ceiling_crushraiseandstaya"] = Ceiling_CrushRaiseAndStayA;
-   gEDMapping["ceiling_crushraiseandstaysila"] = Ceiling_CrushRaiseAndStaySilA;
-   gEDMapping["ceiling_crushstop"] = Ceiling_CrushStop;
-   gEDMapping["ceiling_lowerandcrush"] = Ceiling_LowerAndCrush;
-   gEDMapping["ceiling_lowerandcrushdist"] = Ceiling_LowerAndCrushDist;
-   gEDMapping["ceiling_lowerbytexture"] = Ceiling_LowerByTexture;
-   gEDMapping["ceiling_lowerbyvalue"] = Ceiling_LowerByValue;
-   gEDMapping["ceiling_lowerinstant"] = Ceiling_LowerInstant;
-   gEDMapping["ceiling_lowertofloor"] = Ceiling_LowerToFloor;
-   gEDMapping["ceiling_lowertohighestfloor"] = Ceiling_LowerToHighestFloor;
-   gEDMapping["ceiling_lowertolowest"] = Ceiling_LowerToLowest;
-   gEDMapping["ceiling_lowertonearest"] = Ceiling_LowerToNearest;
-   gEDMapping["ceiling_movetovalue"] = Ceiling_MoveToValue;
-   gEDMapping["ceiling_raisebytexture"] = Ceiling_RaiseByTexture;
-   gEDMapping["ceiling_raisebyvalue"] = Ceiling_RaiseByValue;
-   gEDMapping["ceiling_raiseinstant"] = Ceiling_RaiseInstant;
-   gEDMapping["ceiling_raisetohighest"] = Ceiling_RaiseToHighest;
-   gEDMapping["ceiling_raisetohighestfloor"] = Ceiling_RaiseToHighestFloor;
-   gEDMapping["ceiling_raisetolowest"] = Ceiling_RaiseToLowest;
-   gEDMapping["ceiling_raisetonearest"] = Ceiling_RaiseToNearest;
-   gEDMapping["ceiling_tofloorinstant"] = Ceiling_ToFloorInstant;
-   gEDMapping["ceiling_tohighestinstant"] = Ceiling_ToHighestInstant;
-   gEDMapping["ceiling_waggle"] = Ceiling_Waggle;
-   gEDMapping["changeskill"] = ChangeSkill;
-   gEDMapping["damagething"] = DamageThing;
-   gEDMapping["door_close"] = Door_Close;
-   gEDMapping["door_closewaitopen"] = Door_CloseWaitOpen;
-   gEDMapping["door_lockedraise"] = Door_LockedRaise;
-   gEDMapping["door_open"] = Door_Open;
-   gEDMapping["door_raise"] = Door_Raise;
-   gEDMapping["door_waitclose"] = Door_WaitClose;
-   gEDMapping["door_waitraise"] = Door_WaitRaise;
-   gEDMapping["elevator_lowertonearest"] = Elevator_LowerToNearest;
-   gEDMapping["elevator_movetofloor"] = Elevator_MoveToFloor;
-   gEDMapping["elevator_raisetonearest"] = Elevator_RaiseToNearest;
-   gEDMapping["exit_normal"] = Exit_Normal;
-   gEDMapping["exit_secret"] = Exit_Secret;
-   gEDMapping["floor_crushstop"] = Floor_CrushStop;
-   gEDMapping["floor_donut"] = Floor_Donut;
-   gEDMapping["floor_lowerbytexture"] = Floor_LowerByTexture;
-   gEDMapping["floor_lowerbyvalue"] = Floor_LowerByValue;
-   gEDMapping["floor_lowerinstant"] = Floor_LowerInstant;
-   gEDMapping["floor_lowertohighest"] = Floor_LowerToHighest;
-   gEDMapping["floor_lowertohighestee"] = Floor_LowerToHighestEE;
-   gEDMapping["floor_lowertolowest"] = Floor_LowerToLowest;
-   gEDMapping["floor_lowertolowestceiling"] = Floor_LowerToLowestCeiling;
-   gEDMapping["floor_lowertonearest"] = Floor_LowerToNearest;
-   gEDMapping["floor_movetovalue"] = Floor_MoveToValue;
-   gEDMapping["floor_raiseandcrush"] = Floor_RaiseAndCrush;
-   gEDMapping["floor_raisebytexture"] = Floor_RaiseByTexture;
-   gEDMapping["floor_raisebyvalue"] = Floor_RaiseByValue;
-   gEDMapping["floor_raiseinstant"] = Floor_RaiseInstant;
-   gEDMapping["floor_raisetoceiling"] = Floor_RaiseToCeiling;
-   gEDMapping["floor_raisetohighest"] = Floor_RaiseToHighest;
-   gEDMapping["floor_raisetolowest"] = Floor_RaiseToLowest;
-   gEDMapping["floor_raisetolowestceiling"] = Floor_RaiseToLowestCeiling;
-   gEDMapping["floor_raisetonearest"] = Floor_RaiseToNearest;
-   gEDMapping["floor_toceilinginstant"] = Floor_ToCeilingInstant;
-   gEDMapping["floor_transfernumeric"] = Floor_TransferNumeric;
-   gEDMapping["floor_transfertrigger"] = Floor_TransferTrigger;
-   gEDMapping["floor_waggle"] = Floor_Waggle;
-   gEDMapping["floorandceiling_lowerbyvalue"] = FloorAndCeiling_LowerByValue;
-   gEDMapping["floorandceiling_lowerraise"] = FloorAndCeiling_LowerRaise;
-   gEDMapping["floorandceiling_raisebyvalue"] = FloorAndCeiling_RaiseByValue;
-   gEDMapping["generic_ceiling"] = Generic_Ceiling;
-   gEDMapping["generic_crusher"] = Generic_Crusher;
-   gEDMapping["generic_floor"] = Generic_Floor;
-   gEDMapping["healthing"] = HealThing;
-   gEDMapping["light_changetovalue"] = Light_ChangeToValue;
-   gEDMapping["light_fade"] = Light_Fade;
-   gEDMapping["light_flicker"] = Light_Flicker;
-   gEDMapping["light_glow"] = Light_Glow;
-   gEDMapping["light_lowerbyvalue"] = Light_LowerByValue;
-   gEDMapping["light_maxneighbor"] = Light_MaxNeighbor;
-   gEDMapping["light_minneighbor"] = Light_MinNeighbor;
-   gEDMapping["light_raisebyvalue"] = Light_RaiseByValue;
-   gEDMapping["light_strobe"] = Light_Strobe;
-   gEDMapping["light_strobedoom"] = Light_StrobeDoom;
-   gEDMapping["line_horizon"] = Line_Horizon;
-   gEDMapping["line_quickportal"] = Line_QuickPortal;
-   gEDMapping["line_setidentification"] = Line_SetIdentification;
-   gEDMapping["line_setportal"] = Line_SetPortal;
-   gEDMapping["pillar_build"] = Pillar_Build;
-   gEDMapping["pillar_buildandcrush"] = Pillar_BuildAndCrush;
-   gEDMapping["pillar_open"] = Pillar_Open;
-   gEDMapping["plane_align"] = Plane_Align;
-   gEDMapping["plane_copy"] = Plane_Copy;
-   gEDMapping["plat_downbyvalue"] = Plat_DownByValue;
-   gEDMapping["plat_downwaitupstay"] = Plat_DownWaitUpStay;
-   gEDMapping["plat_downwaitupstaylip"] = Plat_DownWaitUpStayLip;
-   gEDMapping["plat_perpetualraise"] = Plat_PerpetualRaise;
-   gEDMapping["plat_perpetualraiselip"] = Plat_PerpetualRaiseLip;
-   gEDMapping["plat_raiseandstaytx0"] = Plat_RaiseAndStayTx0;
-   gEDMapping["plat_stop"] = Plat_Stop;
-   gEDMapping["plat_toggleceiling"] = Plat_ToggleCeiling;
-   gEDMapping["plat_upbyvalue"] = Plat_UpByValue;
-   gEDMapping["plat_upbyvaluestaytx"] = Plat_UpByValueStayTx;
-   gEDMapping["plat_upwaitdownstay"] = Plat_UpWaitDownStay;
-   gEDMapping["pointpush_setforce"] = PointPush_SetForce;
-   gEDMapping["polyobj_doorslide"] = Polyobj_DoorSlide;
-   gEDMapping["polyobj_doorswing"] = Polyobj_DoorSwing;
-   gEDMapping["polyobj_explicitline"] = Polyobj_ExplicitLine;
-   gEDMapping["polyobj_move"] = Polyobj_Move;
-   gEDMapping["polyobj_moveto"] = Polyobj_MoveTo;
-   gEDMapping["polyobj_movetospot"] = Polyobj_MoveToSpot;
-   gEDMapping["polyobj_or_move"] = Polyobj_OR_Move;
-   gEDMapping["polyobj_or_moveto"] = Polyobj_OR_MoveTo;
-   gEDMapping["polyobj_or_movetospot"] = Polyobj_OR_MoveToSpot;
-   gEDMapping["polyobj_or_rotateleft"] = Polyobj_OR_RotateLeft;
-   gEDMapping["polyobj_or_rotateright"] = Polyobj_OR_RotateRight;
-   gEDMapping["polyobj_rotateleft"] = Polyobj_RotateLeft;
-   gEDMapping["polyobj_rotateright"] = Polyobj_RotateRight;
-   gEDMapping["polyobj_startline"] = Polyobj_StartLine;
-   gEDMapping["polyobj_stop"] = Polyobj_Stop;
-   gEDMapping["portal_define"] = Portal_Define;
-   gEDMapping["radius_quake"] = Radius_Quake;
-   gEDMapping["scroll_ceiling"] = Scroll_Ceiling;
-   gEDMapping["scroll_floor"] = Scroll_Floor;
-   gEDMapping["scroll_texture_down"] = Scroll_Texture_Down;
-   gEDMapping["scroll_texture_left"] = Scroll_Texture_Left;
-   gEDMapping["scroll_texture_model"] = Scroll_Texture_Model;
-   gEDMapping["scroll_texture_offsets"] = Scroll_Texture_Offsets;
-   gEDMapping["scroll_texture_right"] = Scroll_Texture_Right;
-   gEDMapping["scroll_texture_up"] = Scroll_Texture_Up;
-   gEDMapping["sector_attach3dmidtex"] = Sector_Attach3dMidtex;
-   gEDMapping["sector_changesound"] = Sector_ChangeSound;
-   gEDMapping["sector_setceilingpanning"] = Sector_SetCeilingPanning;
-   gEDMapping["sector_setcurrent"] = Sector_SetCurrent;
-   gEDMapping["sector_setfloorpanning"] = Sector_SetFloorPanning;
-   gEDMapping["sector_setfriction"] = Sector_SetFriction;
-   gEDMapping["sector_setportal"] = Sector_SetPortal;
-   gEDMapping["sector_setrotation"] = Sector_SetRotation;
-   gEDMapping["sector_setwind"] = Sector_SetWind;
-   gEDMapping["stairs_builddowndoom"] = Stairs_BuildDownDoom;
-   gEDMapping["stairs_builddowndoomsync"] = Stairs_BuildDownDoomSync;
-   gEDMapping["stairs_buildupdoom"] = Stairs_BuildUpDoom;
-   gEDMapping["stairs_buildupdoomcrush"] = Stairs_BuildUpDoomCrush;
-   gEDMapping["stairs_buildupdoomsync"] = Stairs_BuildUpDoomSync;
-   gEDMapping["static_init"] = Static_Init;
-   gEDMapping["teleport"] = Teleport;
-   gEDMapping["teleport_endgame"] = Teleport_EndGame;
-   gEDMapping["teleport_line"] = Teleport_Line;
-   gEDMapping["teleport_newmap"] = Teleport_NewMap;
-   gEDMapping["teleport_nofog"] = Teleport_NoFog;
-   gEDMapping["thing_activate"] = Thing_Activate;
-   gEDMapping["thing_changetid"] = Thing_ChangeTID;
-   gEDMapping["thing_damage"] = Thing_Damage;
-   gEDMapping["thing_deactivate"] = Thing_Deactivate;
-   gEDMapping["thing_destroy"] = Thing_Destroy;
-   gEDMapping["thing_projectile"] = Thing_Projectile;
-   gEDMapping["thing_projectilegravity"] = Thing_ProjectileGravity;
-   gEDMapping["thing_raise"] = Thing_Raise;
-   gEDMapping["thing_remove"] = Thing_Remove;
-   gEDMapping["thing_spawn"] = Thing_Spawn;
-   gEDMapping["thing_spawnnofog"] = Thing_SpawnNoFog;
-   gEDMapping["thing_stop"] = Thing_Stop;
-   gEDMapping["thrustthing"] = ThrustThing;
-   gEDMapping["thrustthingz"] = ThrustThingZ;
-   gEDMapping["transfer_ceilinglight"] = Transfer_CeilingLight;
-   gEDMapping["transfer_floorlight"] = Transfer_FloorLight;
-   gEDMapping["transfer_heights"] = Transfer_Heights;
+   for(int special = GenCrusherBase; special < GenEnd; ++special)
+   {
+      UdmfSpecialTarget &target = mTargets[special - GenCrusherBase];
+      if(special >= GenFloorBase)
+         GenDecodePlane(special - GenFloorBase, Generic_Floor, target);
+      else if(special >= GenCeilingBase)
+         GenDecodePlane(special - GenCeilingBase, Generic_Ceiling, target);
+      else if(special >= GenDoorBase)
+         GenDecodeDoor(special - GenDoorBase, target);
+      else if(special >= GenLockedBase)
+         GenDecodeLockedDoor(special - GenLockedBase, target);
+      else if(special >= GenLiftBase)
+         GenDecodeLift(special - GenLiftBase, target);
+      else if(special >= GenStairsBase)
+         GenDecodeStairs(special - GenStairsBase, target);
+      else
+         GenDecodeCrusher(special - GenCrusherBase, target);
+   }
 }
 
 //
@@ -821,8 +1155,7 @@ void InitExtraDataMappings()
 //
 UdmfSpecial GetSpecialByName(const char *name)
 {
-   std::string lowerName = LowerCase(name);
-   return gEDMapping[lowerName];
+   return gEDMapping.Get(name);
 }
 
 //
@@ -830,8 +1163,10 @@ UdmfSpecial GetSpecialByName(const char *name)
 //
 const UdmfSpecialTarget *GetUDMFSpecial(int special)
 {
-   auto it = gMapping.find(special);
-   if(it == gMapping.end())
-      return nullptr;
-   return &it->second;
+   if(special >= GenCrusherBase && special < GenEnd)
+   {
+      static const GeneralizedMappingTable generalized;
+      return generalized.Get(special);
+   }
+   return gMapping.Get(special);
 }
@@ -150,6 +150,9 @@ enum UdmfSpecial
    Ceiling_LowerByValueTimes8 = 199,
    Generic_Floor = 200,
    Generic_Ceiling = 201,
+   Generic_Door = 202,
+   Generic_Lift = 203,
+   Generic_Stairs = 204,
    Generic_Crusher = 205,
    Plat_DownWaitUpStayLip = 206,
    Plat_PerpetualRaiseLip = 207,
@@ -326,8 +329,6 @@ struct UdmfSpecialTarget
    void (LinedefConversion::*additional)(int special, int tag, UDMFLine &line);
 };
 
-void InitLineMapping();
-void InitExtraDataMappings();
 UdmfSpecial GetSpecialByName(const char *name);
 const UdmfSpecialTarget *GetUDMFSpecial(int special);
 
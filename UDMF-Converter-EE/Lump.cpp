@@ -22,7 +22,9 @@
 // Authors: Ioan Chera
 //
 
+#include <algorithm>
 #include "Lump.hpp"
+#include "MappedFile.hpp"
 
 Lump::Lump(const char name[LumpNameLength + 1], const std::string &text)
 {
@@ -32,16 +34,58 @@ Lump::Lump(const char name[LumpNameLength + 1], const std::string &text)
 }
 
 //
-// Tries loading lump from a stream
+// Makes a lump which only views data owned by someone else, such as a mapped
+// wad file. The data must outlive the lump. Offset is only kept to know the
+// file order.
 //
-Result Lump::Load(std::istream &is, size_t size)
+Lump::Lump(const char name[LumpNameLength + 1], const uint8_t *data, size_t size,
+           size_t offset) :
+mView(data),
+mOffset(offset),
+mSize(size)
 {
-   std::vector<uint8_t> data;
-   data.resize(size);
+   strcpy(mName, name);
+}
 
-   if(!is.read(reinterpret_cast<char *>(data.data()), size))
-      return Result::BadFile;
+//
+// Makes a lump whose content only gets read from source when first needed
+//
+Lump::Lump(const char name[LumpNameLength + 1], const std::shared_ptr<LumpSource> &source,
+           size_t offset, size_t size) :
+mSource(source),
+mOffset(offset),
+mSize(size)
+{
+   strcpy(mName, name);
+}
+
+//
+// Makes sure the content is available. Lazy lumps get read from their file,
+// while mapped ones get paged in ahead of use. Returns false if reading failed,
+// which is left to the users to report, since it may happen on any thread.
+//
+bool Lump::Fetch() const
+{
+   if(mView)
+   {
+      MappedFile::WillNeed(mView, mSize);
+      return true;
+   }
+   if(!mSource)
+      return true;
 
-   mData = std::move(data);
-   return Result::OK;
+   std::lock_guard<std::mutex> lock(mSource->mMutex);
+   if(mFetched.value.load(std::memory_order_relaxed))
+      return !mFailed;
+   // Keep the full size even on failure, since users may have already got it
+   mData.resize(mSize);
+   std::ifstream &is = mSource->mStream;
+   is.clear();
+   if(!is.seekg(mOffset) || !is.read(reinterpret_cast<char *>(mData.data()), mSize))
+   {
+      std::fill(mData.begin(), mData.end(), 0);
+      mFailed = true;
+   }
+   mFetched.value.store(true, std::memory_order_release);
+   return !mFailed;
 }
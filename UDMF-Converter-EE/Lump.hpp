@@ -28,7 +28,10 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
-#include <istream>
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <mutex>
 #include <vector>
 #include "Result.hpp"
 
@@ -37,6 +40,45 @@ enum
    LumpNameLength = 8,  // lump name size is limited
 };
 
+//
+// Open wad file from which lumps get read on first use
+//
+class LumpSource
+{
+public:
+   explicit LumpSource(const char *path) : mStream(path, std::ios::in | std::ios::binary)
+   {
+   }
+   bool IsOpen() const
+   {
+      return mStream.is_open();
+   }
+private:
+   friend class Lump;
+
+   std::ifstream mStream;
+   std::mutex mMutex;   // lumps may be fetched from several threads
+};
+
+//
+// Flag which can be checked without locking. Copies take its current value, so
+// lumps holding it can still be moved around.
+//
+struct LumpFlag
+{
+   LumpFlag() = default;
+   LumpFlag(const LumpFlag &other) noexcept : value(other.value.load())
+   {
+   }
+   LumpFlag &operator = (const LumpFlag &other) noexcept
+   {
+      value = other.value.load();
+      return *this;
+   }
+
+   std::atomic<bool> value{false};
+};
+
 //
 // Lump class
 //
@@ -52,6 +94,14 @@ public:
       strcpy(mName, name);
    }
    Lump(const char name[LumpNameLength + 1], const std::string &text);
+   Lump(const char name[LumpNameLength + 1], std::vector<uint8_t> &&data) : mData(std::move(data))
+   {
+      strcpy(mName, name);
+   }
+   Lump(const char name[LumpNameLength + 1], const uint8_t *data, size_t size,
+        size_t offset = 0);
+   Lump(const char name[LumpNameLength + 1], const std::shared_ptr<LumpSource> &source,
+        size_t offset, size_t size);
 
    template<typename T>
    Lump(const char name[LumpNameLength + 1], const std::vector<T> &data)
@@ -61,19 +111,50 @@ public:
       memcpy(mData.data(), data.data(), data.size() * sizeof(T));
    }
 
-   Result Load(std::istream &is, size_t size);
    const char *Name() const
    {
       return mName;
    }
 
-   const std::vector<uint8_t> &Data() const
+   const uint8_t *Data() const
    {
-      return mData;
+      if(mView)
+         return mView;
+      if(mSource && !mFetched.value.load(std::memory_order_acquire))
+         Fetch();
+      return mData.data();
    }
+   size_t Size() const
+   {
+      return mView || mSource ? mSize : mData.size();
+   }
+
+   size_t Offset() const
+   {
+      return mOffset;
+   }
+
+   //
+   // Whether the content couldn't be read from the file. It then reads as
+   // zeroes, so check this before trusting it.
+   //
+   bool Failed() const
+   {
+      if(mSource && !mFetched.value.load(std::memory_order_acquire))
+         Fetch();
+      return mFailed;
+   }
+
+   bool Fetch() const;
 private:
    char mName[LumpNameLength + 1];  // lump name
-   std::vector<uint8_t> mData;      // lump content
+   mutable std::vector<uint8_t> mData;    // lump content, if owned
+   const uint8_t *mView = nullptr;        // lump content, if viewing a mapped file
+   std::shared_ptr<LumpSource> mSource;   // file to read content from, if lazy
+   size_t mOffset = 0;                    // content position in its file
+   size_t mSize = 0;                      // content size, if viewed or lazy
+   mutable LumpFlag mFetched;             // whether content was read from mSource
+   mutable bool mFailed = false;          // whether reading it failed
 };
 
 #endif /* Lump_hpp */
@@ -34,6 +34,14 @@
 #define GenLiftBase           0x3400
 #define GenStairsBase         0x3000
 #define GenCrusherBase        0x2F80
+#define GenEnd                0x8000
+
+#define FloorCrush            0x1000
+#define FloorChange           0x0c00
+#define FloorTarget           0x0380
+#define FloorDirection        0x0040
+#define FloorModel            0x0020
+#define FloorSpeed            0x0018
 
 #define FloorCrushShift           12
 #define FloorChangeShift          10
@@ -42,27 +50,52 @@
 #define FloorModelShift            5
 #define FloorSpeedShift            3
 
+#define DoorDelay             0x0300
+#define DoorMonster           0x0080
+#define DoorKind              0x0060
+#define DoorSpeed             0x0018
+
 #define DoorDelayShift             8
 #define DoorMonsterShift           7
 #define DoorKindShift              5
 #define DoorSpeedShift             3
 
+#define LockedNKeys           0x0200
+#define LockedKey             0x01c0
+#define LockedKind            0x0020
+#define LockedSpeed           0x0018
+
 #define LockedNKeysShift           9
 #define LockedKeyShift             6
 #define LockedKindShift            5
 #define LockedSpeedShift           3
 
+#define LiftTarget            0x0300
+#define LiftDelay             0x00c0
+#define LiftMonster           0x0020
+#define LiftSpeed             0x0018
+
 #define LiftTargetShift            8
 #define LiftDelayShift             6
 #define LiftMonsterShift           5
 #define LiftSpeedShift             3
 
+#define StairIgnore           0x0200
+#define StairDirection        0x0100
+#define StairStep             0x00c0
+#define StairMonster          0x0020
+#define StairSpeed            0x0018
+
 #define StairIgnoreShift           9
 #define StairDirectionShift        8
 #define StairStepShift             6
 #define StairMonsterShift          5
 #define StairSpeedShift            3
 
+#define CrusherSilent         0x0040
+#define CrusherMonster        0x0020
+#define CrusherSpeed          0x0018
+
 #define CrusherSilentShift         6
 #define CrusherMonsterShift        5
 #define CrusherSpeedShift          3
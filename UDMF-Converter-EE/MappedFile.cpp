@@ -0,0 +1,126 @@
+//
+// UDMF Converter EE
+// Copyright (C) 2019 Ioan Chera
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/
+//
+// Additional terms and conditions compatible with the GPLv3 apply. See the
+// file COPYING-EE for details.
+//
+// Purpose: Read-only memory-mapped file
+// Authors: Ioan Chera
+//
+
+#include "MappedFile.hpp"
+
+#if EE_CURRENT_PLATFORM == EE_PLATFORM_WINDOWS
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//
+// Maps the file at path. Fails with CannotOpen if the file can't be opened or
+// mapped (e.g. it's empty or not a regular file), so the caller can fall back
+// to reading it.
+//
+Result MappedFile::Open(const char *path)
+{
+   Close();
+#if EE_CURRENT_PLATFORM == EE_PLATFORM_WINDOWS
+   HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                             FILE_ATTRIBUTE_NORMAL, nullptr);
+   if(file == INVALID_HANDLE_VALUE)
+      return Result::CannotOpen;
+   LARGE_INTEGER size;
+   if(!GetFileSizeEx(file, &size) || size.QuadPart <= 0)
+   {
+      CloseHandle(file);
+      return Result::CannotOpen;
+   }
+   HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+   if(!mapping)
+   {
+      CloseHandle(file);
+      return Result::CannotOpen;
+   }
+   void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+   if(!data)
+   {
+      CloseHandle(mapping);
+      CloseHandle(file);
+      return Result::CannotOpen;
+   }
+   mFile = file;
+   mMapping = mapping;
+   mData = static_cast<const uint8_t *>(data);
+   mSize = static_cast<size_t>(size.QuadPart);
+#else
+   int fd = open(path, O_RDONLY);
+   if(fd == -1)
+      return Result::CannotOpen;
+   struct stat st;
+   if(fstat(fd, &st) == -1 || !S_ISREG(st.st_mode) || st.st_size <= 0)
+   {
+      close(fd);
+      return Result::CannotOpen;
+   }
+   void *data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+   close(fd);  // the mapping keeps its own reference
+   if(data == MAP_FAILED)
+      return Result::CannotOpen;
+   mData = static_cast<const uint8_t *>(data);
+   mSize = static_cast<size_t>(st.st_size);
+#endif
+   return Result::OK;
+}
+
+//
+// Releases the mapping
+//
+void MappedFile::Close()
+{
+   if(!mData)
+      return;
+#if EE_CURRENT_PLATFORM == EE_PLATFORM_WINDOWS
+   UnmapViewOfFile(mData);
+   CloseHandle(static_cast<HANDLE>(mMapping));
+   CloseHandle(static_cast<HANDLE>(mFile));
+   mMapping = mFile = nullptr;
+#else
+   munmap(const_cast<uint8_t *>(mData), mSize);
+#endif
+   mData = nullptr;
+   mSize = 0;
+}
+
+//
+// Hints that a mapped range will soon be read, so it gets paged in ahead
+//
+void MappedFile::WillNeed(const uint8_t *data, size_t size)
+{
+#if EE_CURRENT_PLATFORM != EE_PLATFORM_WINDOWS
+   if(!size)
+      return;
+   // madvise wants a page aligned start
+   uintptr_t pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+   uintptr_t start = reinterpret_cast<uintptr_t>(data) & ~(pageSize - 1);
+   size += reinterpret_cast<uintptr_t>(data) - start;
+   posix_madvise(reinterpret_cast<void *>(start), size, POSIX_MADV_WILLNEED);
+#endif
+}
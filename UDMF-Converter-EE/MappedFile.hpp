@@ -0,0 +1,72 @@
+//
+// UDMF Converter EE
+// Copyright (C) 2019 Ioan Chera
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/
+//
+// Additional terms and conditions compatible with the GPLv3 apply. See the
+// file COPYING-EE for details.
+//
+// Purpose: Read-only memory-mapped file
+// Authors: Ioan Chera
+//
+
+#ifndef MappedFile_hpp
+#define MappedFile_hpp
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Result.hpp"
+#include "hal/i_platform.h"
+
+//
+// Read-only view of a whole file mapped into memory. Lumps loaded from it
+// point directly into the mapping, so it must outlive them.
+//
+class MappedFile
+{
+public:
+   MappedFile()
+   {
+   }
+   ~MappedFile()
+   {
+      Close();
+   }
+   MappedFile(const MappedFile &other) = delete;
+   MappedFile &operator = (const MappedFile &other) = delete;
+
+   Result Open(const char *path);
+   void Close();
+
+   static void WillNeed(const uint8_t *data, size_t size);
+
+   const uint8_t *Data() const
+   {
+      return mData;
+   }
+   size_t Size() const
+   {
+      return mSize;
+   }
+private:
+   const uint8_t *mData = nullptr;  // start of mapping
+   size_t mSize = 0;                // file size
+#if EE_CURRENT_PLATFORM == EE_PLATFORM_WINDOWS
+   void *mFile = nullptr;           // file handle
+   void *mMapping = nullptr;        // file mapping handle
+#endif
+};
+
+#endif /* MappedFile_hpp */
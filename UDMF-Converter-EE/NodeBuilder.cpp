@@ -0,0 +1,677 @@
+//
+// UDMF Converter EE
+// Copyright (C) 2019 Ioan Chera
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/
+//
+// Additional terms and conditions compatible with the GPLv3 apply. See the
+// file COPYING-EE for details.
+//
+// Purpose: GL node builder
+// Authors: Ioan Chera
+//
+
+#include <math.h>
+#include <stdint.h>
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+#include "DoomLevel.hpp"
+#include "NodeBuilder.hpp"
+#include "ThreadPool.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BSP_SSE2
+#include <emmintrin.h>
+#endif
+
+enum
+{
+   SplitCost = 8,             // seg imbalance worth as much as one split
+   MaxCandidates = 128,       // partitions tried per node, at most
+   ParallelThreshold = 1024,  // segs needed to build a subtree on the pool
+   BoundsMargin = 8,          // space around the map for the outer region
+};
+
+// Node bounding box order
+enum
+{
+   BOXTOP,
+   BOXBOTTOM,
+   BOXLEFT,
+   BOXRIGHT
+};
+
+// Distance under which a point counts as being on a line, in map units
+static const double gOnLineEpsilon = 1.0 / 256;
+// Distance allowed between segs and the subsector edges they lie on
+static const double gEdgeEpsilon = 1.0 / 64;
+
+struct BSPPoint
+{
+   double x, y;
+};
+
+typedef std::vector<BSPPoint> BSPPolygon;   // convex, clockwise
+
+//
+// Segs of a node being built, stored by component so the partition cost loop
+// can load several segs at once
+//
+struct BSPSegSet
+{
+   std::vector<double> x1, y1, x2, y2;
+   std::vector<int> linedef, side;
+
+   size_t Size() const
+   {
+      return x1.size();
+   }
+   void Reserve(size_t count)
+   {
+      x1.reserve(count);
+      y1.reserve(count);
+      x2.reserve(count);
+      y2.reserve(count);
+      linedef.reserve(count);
+      side.reserve(count);
+   }
+   void Add(double ax, double ay, double bx, double by, int line, int lineSide)
+   {
+      x1.push_back(ax);
+      y1.push_back(ay);
+      x2.push_back(bx);
+      y2.push_back(by);
+      linedef.push_back(line);
+      side.push_back(lineSide);
+   }
+};
+
+//
+// Element of a subsector's closed seg loop. Its end is the next one's start.
+//
+struct BSPLoopSeg
+{
+   BSPPoint start;
+   int linedef;   // -1 for minisegs
+   int side;
+};
+
+//
+// Node tree as built, before being numbered into the output
+//
+struct BSPTree
+{
+   BSPPoint start, direction;          // partition, for nodes
+   std::unique_ptr<BSPTree> child[2];  // right, left
+   std::vector<BSPLoopSeg> loop;       // for subsectors
+};
+
+//
+// Builds the node tree and numbers it into GLNodes
+//
+class NodeBuilder
+{
+public:
+   NodeBuilder(const DoomLevel &level, ThreadPool *pool) : mLevel(level), mPool(pool)
+   {
+   }
+
+   bool Build(GLNodes &nodes);
+
+private:
+   std::unique_ptr<BSPTree> BuildTree(BSPSegSet &&segs, BSPPolygon &&region);
+   int Number(const BSPTree &tree, GLNodes &nodes, double box[4]);
+   int VertexIndex(const BSPPoint &point, GLNodes &nodes);
+   void FindPartners(GLNodes &nodes) const;
+
+   const DoomLevel &mLevel;
+   ThreadPool *const mPool;
+   std::unordered_map<uint64_t, int> mVertexIndex;  // by packed fixed point coordinates
+};
+
+//
+// Side of a point relative to a line, scaled by the line direction length.
+// Positive is on the right.
+//
+static inline double BSP_side(const BSPPoint &start, const BSPPoint &direction,
+                              double x, double y)
+{
+   return direction.y * (x - start.x) - direction.x * (y - start.y);
+}
+
+//
+// Keeps the part of a convex polygon on one side of a line
+//
+static BSPPolygon BSP_clip(const BSPPolygon &polygon, const BSPPoint &start,
+                           const BSPPoint &direction, bool keepRight)
+{
+   BSPPolygon result;
+   size_t count = polygon.size();
+   if(!count)
+      return result;
+   const double limit = gOnLineEpsilon * hypot(direction.x, direction.y);
+   const double sign = keepRight ? 1 : -1;
+   result.reserve(count + 1);
+   for(size_t i = 0; i < count; ++i)
+   {
+      const BSPPoint &a = polygon[i];
+      const BSPPoint &b = polygon[(i + 1) % count];
+      double da = sign * BSP_side(start, direction, a.x, a.y);
+      double db = sign * BSP_side(start, direction, b.x, b.y);
+      if(da >= -limit)
+         result.push_back(a);
+      if((da > limit && db < -limit) || (da < -limit && db > limit))
+      {
+         double t = da / (da - db);
+         result.push_back({ a.x + t * (b.x - a.x), a.y + t * (b.y - a.y) });
+      }
+   }
+
+   // Drop points made redundant by the tolerance
+   BSPPolygon unique;
+   unique.reserve(result.size());
+   for(const BSPPoint &point : result)
+   {
+      if(unique.empty() || fabs(point.x - unique.back().x) > gOnLineEpsilon ||
+         fabs(point.y - unique.back().y) > gOnLineEpsilon)
+      {
+         unique.push_back(point);
+      }
+   }
+   while(unique.size() > 1 && fabs(unique.front().x - unique.back().x) <= gOnLineEpsilon &&
+         fabs(unique.front().y - unique.back().y) <= gOnLineEpsilon)
+   {
+      unique.pop_back();
+   }
+   return unique;
+}
+
+//
+// Counts how the segs fall relative to the line of a candidate seg. Segs on
+// the line go right if they point the same way, left otherwise. This is the
+// inner loop of the builder, so it does two segs at a time where SSE2 is
+// available.
+//
+static void BSP_evaluate(const BSPSegSet &segs, size_t candidate, int &right, int &left,
+                         int &splits)
+{
+   const double px = segs.x1[candidate], py = segs.y1[candidate];
+   const double dx = segs.x2[candidate] - px, dy = segs.y2[candidate] - py;
+   const double limit = gOnLineEpsilon * sqrt(dx * dx + dy * dy);
+   const double *x1 = segs.x1.data(), *y1 = segs.y1.data();
+   const double *x2 = segs.x2.data(), *y2 = segs.y2.data();
+   const size_t count = segs.Size();
+
+   size_t i = 0;
+   int r = 0, l = 0, s = 0;
+#ifdef BSP_SSE2
+   // Lanes of the comparison masks are all ones when true, so subtracting
+   // them counts
+   const __m128d vpx = _mm_set1_pd(px), vpy = _mm_set1_pd(py);
+   const __m128d vdx = _mm_set1_pd(dx), vdy = _mm_set1_pd(dy);
+   const __m128d vlimit = _mm_set1_pd(limit), vnegLimit = _mm_set1_pd(-limit);
+   const __m128d zero = _mm_setzero_pd();
+   __m128i vr = _mm_setzero_si128(), vl = _mm_setzero_si128(), vs = _mm_setzero_si128();
+   for(; i + 2 <= count; i += 2)
+   {
+      __m128d ax = _mm_loadu_pd(x1 + i), ay = _mm_loadu_pd(y1 + i);
+      __m128d bx = _mm_loadu_pd(x2 + i), by = _mm_loadu_pd(y2 + i);
+      __m128d a = _mm_sub_pd(_mm_mul_pd(vdy, _mm_sub_pd(ax, vpx)),
+                             _mm_mul_pd(vdx, _mm_sub_pd(ay, vpy)));
+      __m128d b = _mm_sub_pd(_mm_mul_pd(vdy, _mm_sub_pd(bx, vpx)),
+                             _mm_mul_pd(vdx, _mm_sub_pd(by, vpy)));
+      __m128d ahead = _mm_cmpgt_pd(_mm_add_pd(_mm_mul_pd(vdx, _mm_sub_pd(bx, ax)),
+                                              _mm_mul_pd(vdy, _mm_sub_pd(by, ay))), zero);
+      __m128d onRight = _mm_or_pd(_mm_cmpgt_pd(a, vlimit), _mm_cmpgt_pd(b, vlimit));
+      __m128d onLeft = _mm_or_pd(_mm_cmplt_pd(a, vnegLimit), _mm_cmplt_pd(b, vnegLimit));
+      __m128d onLine = _mm_andnot_pd(_mm_or_pd(onRight, onLeft),
+                                     _mm_castsi128_pd(_mm_set1_epi32(-1)));
+      __m128d split = _mm_and_pd(onRight, onLeft);
+      __m128d toRight = _mm_or_pd(_mm_andnot_pd(onLeft, onRight), _mm_and_pd(onLine, ahead));
+      __m128d toLeft = _mm_or_pd(_mm_andnot_pd(onRight, onLeft), _mm_andnot_pd(ahead, onLine));
+      vr = _mm_sub_epi64(vr, _mm_castpd_si128(toRight));
+      vl = _mm_sub_epi64(vl, _mm_castpd_si128(toLeft));
+      vs = _mm_sub_epi64(vs, _mm_castpd_si128(split));
+   }
+   int64_t lanes[2];
+   _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), vr);
+   r = static_cast<int>(lanes[0] + lanes[1]);
+   _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), vl);
+   l = static_cast<int>(lanes[0] + lanes[1]);
+   _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), vs);
+   s = static_cast<int>(lanes[0] + lanes[1]);
+#endif
+   for(; i < count; ++i)
+   {
+      double a = dy * (x1[i] - px) - dx * (y1[i] - py);
+      double b = dy * (x2[i] - px) - dx * (y2[i] - py);
+      bool onRight = a > limit || b > limit;
+      bool onLeft = a < -limit || b < -limit;
+      bool ahead = dx * (x2[i] - x1[i]) + dy * (y2[i] - y1[i]) > 0;
+      if(onRight && onLeft)
+         ++s;
+      else if(onRight || (!onLeft && ahead))
+         ++r;
+      else
+         ++l;
+   }
+   right = r;
+   left = l;
+   splits = s;
+}
+
+//
+// Picks the seg whose line divides the others best. Fails if they form a
+// convex subsector already. Large sets only get a spread sample of segs tried,
+// unless none of those divide them.
+//
+static bool BSP_choosePartition(const BSPSegSet &segs, size_t &best)
+{
+   const size_t count = segs.Size();
+   const size_t step = count > MaxCandidates ? count / MaxCandidates : 1;
+   long bestCost = -1;
+   for(size_t pass = 0; pass < 2 && bestCost < 0; ++pass)
+   {
+      size_t stride = pass ? 1 : step;
+      if(pass && step == 1)
+         break;
+      for(size_t i = 0; i < count; i += stride)
+      {
+         int right, left, splits;
+         BSP_evaluate(segs, i, right, left, splits);
+         if(!left && !splits)
+            continue;   // nothing behind it
+         long cost = static_cast<long>(splits) * SplitCost + labs(right - left);
+         if(bestCost < 0 || cost < bestCost)
+         {
+            bestCost = cost;
+            best = i;
+         }
+      }
+   }
+   return bestCost >= 0;
+}
+
+//
+// Sorts the segs to the sides of the partition, splitting the ones crossing it
+//
+static void BSP_divide(const BSPSegSet &segs, size_t partition, BSPSegSet &right,
+                       BSPSegSet &left)
+{
+   const double px = segs.x1[partition], py = segs.y1[partition];
+   const double dx = segs.x2[partition] - px, dy = segs.y2[partition] - py;
+   const double limit = gOnLineEpsilon * sqrt(dx * dx + dy * dy);
+   const size_t count = segs.Size();
+   right.Reserve(count / 2 + 1);
+   left.Reserve(count / 2 + 1);
+   for(size_t i = 0; i < count; ++i)
+   {
+      double x1 = segs.x1[i], y1 = segs.y1[i], x2 = segs.x2[i], y2 = segs.y2[i];
+      double a = dy * (x1 - px) - dx * (y1 - py);
+      double b = dy * (x2 - px) - dx * (y2 - py);
+      bool onRight = a > limit || b > limit;
+      bool onLeft = a < -limit || b < -limit;
+      int line = segs.linedef[i], side = segs.side[i];
+      if(onRight && onLeft)
+      {
+         double t = a / (a - b);
+         double mx = x1 + t * (x2 - x1), my = y1 + t * (y2 - y1);
+         BSPSegSet &first = a > 0 ? right : left;
+         BSPSegSet &second = a > 0 ? left : right;
+         first.Add(x1, y1, mx, my, line, side);
+         second.Add(mx, my, x2, y2, line, side);
+      }
+      else if(onRight || (!onLeft && dx * (x2 - x1) + dy * (y2 - y1) > 0))
+         right.Add(x1, y1, x2, y2, line, side);
+      else
+         left.Add(x1, y1, x2, y2, line, side);
+   }
+}
+
+//
+// Puts the segs of a convex subsector in a closed clockwise loop, adding
+// minisegs over the gaps. The subsector's shape is its region from the
+// partitions, cut by the lines of its segs, so each seg lies on one of its
+// edges.
+//
+static std::vector<BSPLoopSeg> BSP_buildLoop(const BSPSegSet &segs, BSPPolygon &&region)
+{
+   const size_t count = segs.Size();
+   BSPPolygon shape(std::move(region));
+   for(size_t i = 0; i < count && shape.size() >= 3; ++i)
+   {
+      BSPPoint start = { segs.x1[i], segs.y1[i] };
+      BSPPoint direction = { segs.x2[i] - segs.x1[i], segs.y2[i] - segs.y1[i] };
+      shape = BSP_clip(shape, start, direction, true);
+   }
+
+   std::vector<BSPLoopSeg> loop;
+   std::vector<bool> used(count);
+   size_t placed = 0;
+   if(shape.size() >= 3)
+   {
+      std::vector<std::pair<double, size_t>> onEdge;
+      for(size_t k = 0; k < shape.size(); ++k)
+      {
+         const BSPPoint &a = shape[k];
+         const BSPPoint &b = shape[(k + 1) % shape.size()];
+         BSPPoint edge = { b.x - a.x, b.y - a.y };
+         double length = hypot(edge.x, edge.y);
+         if(length <= gOnLineEpsilon)
+            continue;
+         const double limit = gEdgeEpsilon * length;
+         onEdge.clear();
+         for(size_t i = 0; i < count; ++i)
+         {
+            if(used[i] || (segs.x2[i] - segs.x1[i]) * edge.x +
+               (segs.y2[i] - segs.y1[i]) * edge.y <= 0 ||
+               fabs(BSP_side(a, edge, segs.x1[i], segs.y1[i])) > limit ||
+               fabs(BSP_side(a, edge, segs.x2[i], segs.y2[i])) > limit)
+            {
+               continue;
+            }
+            double t = ((segs.x1[i] - a.x) * edge.x + (segs.y1[i] - a.y) * edge.y) / length;
+            onEdge.emplace_back(t, i);
+         }
+         std::sort(onEdge.begin(), onEdge.end());
+
+         BSPPoint cursor = a;
+         double cursorT = 0;
+         for(const auto &item : onEdge)
+         {
+            size_t i = item.second;
+            if(item.first - cursorT > gEdgeEpsilon)
+               loop.push_back({ cursor, -1, 0 });
+            loop.push_back({ { segs.x1[i], segs.y1[i] }, segs.linedef[i], segs.side[i] });
+            cursor = { segs.x2[i], segs.y2[i] };
+            cursorT = ((cursor.x - a.x) * edge.x + (cursor.y - a.y) * edge.y) / length;
+            used[i] = true;
+            ++placed;
+         }
+         if(length - cursorT > gEdgeEpsilon)
+            loop.push_back({ cursor, -1, 0 });
+      }
+   }
+
+   if(placed < count)
+   {
+      // Numeric trouble: just chain the segs around their centre
+      loop.clear();
+      double cx = 0, cy = 0;
+      for(size_t i = 0; i < count; ++i)
+      {
+         cx += segs.x1[i] + segs.x2[i];
+         cy += segs.y1[i] + segs.y2[i];
+      }
+      cx /= 2 * count;
+      cy /= 2 * count;
+      std::vector<std::pair<double, size_t>> order;
+      for(size_t i = 0; i < count; ++i)
+      {
+         double mx = (segs.x1[i] + segs.x2[i]) / 2, my = (segs.y1[i] + segs.y2[i]) / 2;
+         order.emplace_back(-atan2(my - cy, mx - cx), i);
+      }
+      std::sort(order.begin(), order.end());
+      for(size_t n = 0; n < count; ++n)
+      {
+         size_t i = order[n].second, next = order[(n + 1) % count].second;
+         loop.push_back({ { segs.x1[i], segs.y1[i] }, segs.linedef[i], segs.side[i] });
+         if(fabs(segs.x2[i] - segs.x1[next]) > gEdgeEpsilon ||
+            fabs(segs.y2[i] - segs.y1[next]) > gEdgeEpsilon)
+         {
+            loop.push_back({ { segs.x2[i], segs.y2[i] }, -1, 0 });
+         }
+      }
+   }
+
+   // Ports take the subsector's sector from the first seg, so start with a
+   // real one
+   auto first = std::find_if(loop.begin(), loop.end(), [](const BSPLoopSeg &seg) {
+      return seg.linedef >= 0;
+   });
+   std::rotate(loop.begin(), first, loop.end());
+   return loop;
+}
+
+//
+// Builds the subtree of the given segs, inside the region left to them by the
+// partitions above
+//
+std::unique_ptr<BSPTree> NodeBuilder::BuildTree(BSPSegSet &&segs, BSPPolygon &&region)
+{
+   std::unique_ptr<BSPTree> tree(new BSPTree);
+   size_t partition;
+   if(!BSP_choosePartition(segs, partition))
+   {
+      tree->loop = BSP_buildLoop(segs, std::move(region));
+      return tree;
+   }
+
+   tree->start = { segs.x1[partition], segs.y1[partition] };
+   tree->direction = { segs.x2[partition] - segs.x1[partition],
+      segs.y2[partition] - segs.y1[partition] };
+   BSPSegSet right, left;
+   BSP_divide(segs, partition, right, left);
+   segs = BSPSegSet();
+   BSPPolygon rightRegion = BSP_clip(region, tree->start, tree->direction, true);
+   BSPPolygon leftRegion = BSP_clip(region, tree->start, tree->direction, false);
+   region = BSPPolygon();
+
+   if(mPool && right.Size() + left.Size() >= ParallelThreshold)
+   {
+      BSPTree *node = tree.get();
+      auto task = PoolTask::Start(*mPool, [this, node, &left, &leftRegion]() {
+         node->child[1] = BuildTree(std::move(left), std::move(leftRegion));
+      });
+      tree->child[0] = BuildTree(std::move(right), std::move(rightRegion));
+      task->Join();
+   }
+   else
+   {
+      tree->child[0] = BuildTree(std::move(right), std::move(rightRegion));
+      tree->child[1] = BuildTree(std::move(left), std::move(leftRegion));
+   }
+   return tree;
+}
+
+//
+// Gets the index of a vertex, adding it if new. Equal fixed point positions
+// share one vertex.
+//
+int NodeBuilder::VertexIndex(const BSPPoint &point, GLNodes &nodes)
+{
+   int32_t x = static_cast<int32_t>(lround(point.x * 65536));
+   int32_t y = static_cast<int32_t>(lround(point.y * 65536));
+   uint64_t key = static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32 |
+   static_cast<uint32_t>(y);
+   auto result = mVertexIndex.emplace(key, 0);
+   if(result.second)
+   {
+      result.first->second = static_cast<int>(nodes.numOriginalVertices +
+                                              nodes.newVertices.size());
+      nodes.newVertices.push_back({ x, y });
+   }
+   return result.first->second;
+}
+
+//
+// Adds a subtree to the output, children first, so the root node comes last.
+// Returns the reference to it for its parent, and gets its bounding box as
+// top, bottom, left, right.
+//
+int NodeBuilder::Number(const BSPTree &tree, GLNodes &nodes, double box[4])
+{
+   if(!tree.child[0])
+   {
+      box[BOXTOP] = box[BOXRIGHT] = -HUGE_VAL;
+      box[BOXBOTTOM] = box[BOXLEFT] = HUGE_VAL;
+      std::vector<int> vertices;
+      vertices.reserve(tree.loop.size());
+      for(const BSPLoopSeg &seg : tree.loop)
+      {
+         vertices.push_back(VertexIndex(seg.start, nodes));
+         box[BOXTOP] = std::max(box[BOXTOP], seg.start.y);
+         box[BOXBOTTOM] = std::min(box[BOXBOTTOM], seg.start.y);
+         box[BOXLEFT] = std::min(box[BOXLEFT], seg.start.x);
+         box[BOXRIGHT] = std::max(box[BOXRIGHT], seg.start.x);
+      }
+      Subsector subsector;
+      subsector.startseg = static_cast<int>(nodes.segs.size());
+      for(size_t i = 0; i < tree.loop.size(); ++i)
+      {
+         const BSPLoopSeg &seg = tree.loop[i];
+         // Minisegs which got no length once in fixed point can go
+         if(seg.linedef < 0 && vertices[i] == vertices[(i + 1) % vertices.size()])
+            continue;
+         nodes.segs.push_back({ vertices[i], -1, seg.linedef, seg.side });
+      }
+      subsector.segcount = static_cast<int>(nodes.segs.size()) - subsector.startseg;
+      nodes.subsectors.push_back(subsector);
+      return static_cast<int>(NF_SUBSECTOR | (nodes.subsectors.size() - 1));
+   }
+
+   double boxes[2][4];
+   Node node;
+   node.rightchild = Number(*tree.child[0], nodes, boxes[0]);
+   node.leftchild = Number(*tree.child[1], nodes, boxes[1]);
+   for(int i = 0; i < 4; ++i)
+   {
+      // Round outward, to still cover the fractional vertices
+      bool up = i == BOXTOP || i == BOXRIGHT;
+      node.rightbox[i] = static_cast<int>(up ? ceil(boxes[0][i]) : floor(boxes[0][i]));
+      node.leftbox[i] = static_cast<int>(up ? ceil(boxes[1][i]) : floor(boxes[1][i]));
+   }
+   box[BOXTOP] = std::max(boxes[0][BOXTOP], boxes[1][BOXTOP]);
+   box[BOXBOTTOM] = std::min(boxes[0][BOXBOTTOM], boxes[1][BOXBOTTOM]);
+   box[BOXLEFT] = std::min(boxes[0][BOXLEFT], boxes[1][BOXLEFT]);
+   box[BOXRIGHT] = std::max(boxes[0][BOXRIGHT], boxes[1][BOXRIGHT]);
+
+   // Long partitions don't fit in fixed point, so shorten their direction
+   double dx = tree.direction.x, dy = tree.direction.y;
+   while(fabs(dx) >= 32767 || fabs(dy) >= 32767)
+   {
+      dx /= 2;
+      dy /= 2;
+   }
+   node.partx = static_cast<int>(lround(tree.start.x * 65536));
+   node.party = static_cast<int>(lround(tree.start.y * 65536));
+   node.dx = static_cast<int>(lround(dx * 65536));
+   node.dy = static_cast<int>(lround(dy * 65536));
+   nodes.nodes.push_back(node);
+   return static_cast<int>(nodes.nodes.size() - 1);
+}
+
+//
+// Links each seg to the one running the other way between the same vertices
+//
+void NodeBuilder::FindPartners(GLNodes &nodes) const
+{
+   auto key = [](int v1, int v2) {
+      return static_cast<uint64_t>(static_cast<uint32_t>(v1)) << 32 |
+      static_cast<uint32_t>(v2);
+   };
+   std::vector<int> ends(nodes.segs.size());
+   for(const Subsector &subsector : nodes.subsectors)
+   {
+      for(int i = 0; i < subsector.segcount; ++i)
+      {
+         int next = subsector.startseg + (i + 1) % subsector.segcount;
+         ends[subsector.startseg + i] = nodes.segs[next].v1;
+      }
+   }
+   std::unordered_map<uint64_t, int> byVertices;
+   byVertices.reserve(nodes.segs.size());
+   for(size_t i = 0; i < nodes.segs.size(); ++i)
+      byVertices.emplace(key(nodes.segs[i].v1, ends[i]), static_cast<int>(i));
+   for(size_t i = 0; i < nodes.segs.size(); ++i)
+   {
+      GLSeg &seg = nodes.segs[i];
+      if(seg.v1 == ends[i])
+         continue;
+      auto it = byVertices.find(key(ends[i], seg.v1));
+      if(it != byVertices.end())
+         seg.partner = it->second;
+   }
+}
+
+bool NodeBuilder::Build(GLNodes &nodes)
+{
+   const std::vector<Vertex> &vertices = mLevel.GetVertices();
+   const std::vector<Linedef> &linedefs = mLevel.GetLinedefs();
+   const size_t numSides = mLevel.GetSidedefs().size();
+
+   BSPSegSet segs;
+   segs.Reserve(linedefs.size() * 2);
+   for(size_t i = 0; i < linedefs.size(); ++i)
+   {
+      const Linedef &linedef = linedefs[i];
+      if(linedef.v1 < 0 || static_cast<size_t>(linedef.v1) >= vertices.size() ||
+         linedef.v2 < 0 || static_cast<size_t>(linedef.v2) >= vertices.size())
+      {
+         continue;
+      }
+      const Vertex &v1 = vertices[linedef.v1];
+      const Vertex &v2 = vertices[linedef.v2];
+      if(v1.x == v2.x && v1.y == v2.y)
+         continue;
+      int line = static_cast<int>(i);
+      if(linedef.sidenum[0] >= 0 && static_cast<size_t>(linedef.sidenum[0]) < numSides)
+         segs.Add(v1.x, v1.y, v2.x, v2.y, line, 0);
+      if(linedef.sidenum[1] >= 0 && static_cast<size_t>(linedef.sidenum[1]) < numSides)
+         segs.Add(v2.x, v2.y, v1.x, v1.y, line, 1);
+   }
+   if(!segs.Size())
+      return false;
+
+   int left, bottom, right, top;
+   mLevel.GetBounds(left, bottom, right, top);
+   left -= BoundsMargin;
+   bottom -= BoundsMargin;
+   right += BoundsMargin;
+   top += BoundsMargin;
+   BSPPolygon region = {
+      { double(left), double(bottom) },
+      { double(left), double(top) },
+      { double(right), double(top) },
+      { double(right), double(bottom) }
+   };
+
+   std::unique_ptr<BSPTree> tree = BuildTree(std::move(segs), std::move(region));
+
+   nodes = GLNodes();
+   nodes.numOriginalVertices = vertices.size();
+   mVertexIndex.clear();
+   for(size_t i = 0; i < vertices.size(); ++i)
+   {
+      int32_t x = vertices[i].x * 65536, y = vertices[i].y * 65536;
+      mVertexIndex.emplace(static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32 |
+                           static_cast<uint32_t>(y), static_cast<int>(i));
+   }
+   double box[4];
+   Number(*tree, nodes, box);
+   FindPartners(nodes);
+   return true;
+}
+
+//
+// Builds GL nodes for the level from its linedefs, ignoring any nodes it came
+// with. Subtrees get built on the pool, if given. Fails if there's nothing to
+// build from.
+//
+bool BuildGLNodes(const DoomLevel &level, ThreadPool *pool, GLNodes &nodes)
+{
+   NodeBuilder builder(level, pool);
+   return builder.Build(nodes);
+}
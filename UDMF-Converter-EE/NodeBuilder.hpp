@@ -0,0 +1,62 @@
+//
+// UDMF Converter EE
+// Copyright (C) 2019 Ioan Chera
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/
+//
+// Additional terms and conditions compatible with the GPLv3 apply. See the
+// file COPYING-EE for details.
+//
+// Purpose: GL node builder
+// Authors: Ioan Chera
+//
+
+#ifndef NodeBuilder_hpp
+#define NodeBuilder_hpp
+
+#include <stddef.h>
+#include <vector>
+#include "MapItems.h"
+
+class DoomLevel;
+class ThreadPool;
+
+//
+// GL seg. The end vertex is the start of the next seg in the subsector.
+//
+struct GLSeg
+{
+   int v1;
+   int partner;   // seg on the other side, or -1
+   int linedef;   // -1 for minisegs
+   int side;
+};
+
+//
+// Built GL nodes, in the XGL3 layout. Vertices, node partitions and
+// directions are 16.16 fixed point. Node children referencing subsectors have
+// NF_SUBSECTOR set. Vertex indices start with the level's own vertices.
+//
+struct GLNodes
+{
+   size_t numOriginalVertices = 0;
+   std::vector<Vertex> newVertices;
+   std::vector<GLSeg> segs;
+   std::vector<Subsector> subsectors;
+   std::vector<Node> nodes;
+};
+
+bool BuildGLNodes(const DoomLevel &level, ThreadPool *pool, GLNodes &nodes);
+
+#endif /* NodeBuilder_hpp */
@@ -0,0 +1,521 @@
+//
+// UDMF Converter EE
+// Copyright (C) 2019 Ioan Chera
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/
+//
+// Additional terms and conditions compatible with the GPLv3 apply. See the
+// file COPYING-EE for details.
+//
+// Purpose: Readers of GL and extended nodes shipped with levels
+// Authors: Ioan Chera
+//
+
+#include <stdio.h>
+#include <string.h>
+#include <zlib.h>
+#include <algorithm>
+#include "DataStreamer.hpp"
+#include "DoomLevel.hpp"
+#include "Helpers.hpp"
+#include "NodeBuilder.hpp"
+#include "NodeReader.hpp"
+#include "Wad.hpp"
+
+static const uint32_t gNoIndex = 0xffffffff;
+
+//
+// Layout of ZDoom extended nodes, by signature
+//
+struct ZDoomNodeFormat
+{
+   char signature[5];
+   bool compressed;     // zlib data after the signature
+   bool gl;             // segs form closed subsectors and have partners
+   bool wideLinedefs;   // 32-bit seg linedefs
+   bool fixedNodes;     // 16.16 node partitions
+};
+
+static const ZDoomNodeFormat gZDoomFormats[] =
+{
+   { "XNOD", false, false, false, false },
+   { "ZNOD", true, false, false, false },
+   { "XGLN", false, true, false, false },
+   { "ZGLN", true, true, false, false },
+   { "XGL2", false, true, true, false },
+   { "ZGL2", true, true, true, false },
+   { "XGL3", false, true, true, true },
+   { "ZGL3", true, true, true, true },
+};
+
+//
+// Inflates zlib data of unknown uncompressed size
+//
+static bool NodeReader_inflate(const uint8_t *data, size_t size, std::vector<uint8_t> &out)
+{
+   z_stream stream = {};
+   if(inflateInit(&stream) != Z_OK)
+      return false;
+   stream.next_in = const_cast<Bytef *>(data);
+   stream.avail_in = static_cast<uInt>(size);
+   out.resize(size * 4 + 1024);
+   int status;
+   do
+   {
+      if(stream.total_out == out.size())
+         out.resize(out.size() * 2);
+      stream.next_out = out.data() + stream.total_out;
+      stream.avail_out = static_cast<uInt>(out.size() - stream.total_out);
+      status = inflate(&stream, Z_NO_FLUSH);
+   } while(status == Z_OK || (status == Z_BUF_ERROR && !stream.avail_out));
+   out.resize(stream.total_out);
+   inflateEnd(&stream);
+   return status == Z_STREAM_END;
+}
+
+//
+// Starts the vertices. The level's editor vertices are the original ones, and
+// the rest of VERTEXES come first among the new ones, so indices into VERTEXES
+// keep pointing to the same vertex. Returns the VERTEXES count.
+//
+static size_t NodeReader_startVertices(const DoomLevel &level, GLNodes &nodes)
+{
+   nodes = GLNodes();
+   nodes.numOriginalVertices = level.GetVertices().size();
+   for(const Vertex &vertex : level.GetNodeVertices())
+      nodes.newVertices.push_back({ vertex.x << 16, vertex.y << 16 });
+   return nodes.numOriginalVertices + nodes.newVertices.size();
+}
+
+//
+// Reads a node with a 16-bit or a 16.16 partition. Children are 16 or 32-bit,
+// with the subsector flag in their top bit.
+//
+static Node NodeReader_readNode(DataStreamer &stream, bool fixedPartition, bool wideChildren)
+{
+   Node node;
+   int *partition[4] = { &node.partx, &node.party, &node.dx, &node.dy };
+   for(int *value : partition)
+      *value = fixedPartition ? stream.ReadInt() : stream.ReadShort() << 16;
+   for(int i = 0; i < 4; ++i)
+      node.rightbox[i] = stream.ReadShort();
+   for(int i = 0; i < 4; ++i)
+      node.leftbox[i] = stream.ReadShort();
+   for(int *child : { &node.rightchild, &node.leftchild })
+   {
+      if(wideChildren)
+         *child = stream.ReadInt();
+      else
+      {
+         int value = static_cast<uint16_t>(stream.ReadShort());
+         *child = value & 0x8000 ? static_cast<int>(NF_SUBSECTOR | (value & 0x7fff)) : value;
+      }
+   }
+   return node;
+}
+
+//
+// Reads ZDoom extended nodes, compressed or not. Vanilla style ones get a
+// miniseg after each seg, to reach the next seg's start, as XGL3 segs only
+// store their start.
+//
+static bool NodeReader_readZDoom(const DoomLevel &level, const Lump &lump, GLNodes &nodes,
+                                 std::string &format)
+{
+   if(lump.Size() < 4)
+      return false;
+   const ZDoomNodeFormat *layout = nullptr;
+   for(const ZDoomNodeFormat &candidate : gZDoomFormats)
+      if(!memcmp(lump.Data(), candidate.signature, 4))
+         layout = &candidate;
+   if(!layout)
+      return false;
+   const uint8_t *data = lump.Data() + 4;
+   size_t size = lump.Size() - 4;
+   std::vector<uint8_t> inflated;
+   if(layout->compressed)
+   {
+      if(!NodeReader_inflate(data, size, inflated))
+         return false;
+      data = inflated.data();
+      size = inflated.size();
+   }
+   DataStreamer stream(data, size);
+
+   const size_t lumpVertices = NodeReader_startVertices(level, nodes);
+   uint32_t orgVerts = stream.ReadInt();
+   uint32_t newVerts = stream.ReadInt();
+   if(orgVerts > lumpVertices || stream.Remaining() / 8 < newVerts)
+      return false;
+   for(uint32_t i = 0; i < newVerts; ++i)
+   {
+      Vertex vertex;
+      vertex.x = stream.ReadInt();
+      vertex.y = stream.ReadInt();
+      nodes.newVertices.push_back(vertex);
+   }
+   const size_t numVertices = nodes.numOriginalVertices + nodes.newVertices.size();
+   auto mapVertex = [orgVerts, lumpVertices, numVertices](uint32_t index) {
+      size_t mapped = index < orgVerts ? index : lumpVertices + (index - orgVerts);
+      return mapped < numVertices ? static_cast<int>(mapped) : -1;
+   };
+
+   const int segsPerSeg = layout->gl ? 1 : 2;
+   uint32_t numSubsectors = stream.ReadInt();
+   if(stream.Remaining() / 4 < numSubsectors)
+      return false;
+   size_t numSegs = 0;
+   for(uint32_t i = 0; i < numSubsectors; ++i)
+   {
+      uint32_t count = stream.ReadInt();
+      if(count > stream.Remaining())
+         return false;
+      Subsector subsector;
+      subsector.startseg = static_cast<int>(numSegs * segsPerSeg);
+      subsector.segcount = static_cast<int>(count * segsPerSeg);
+      nodes.subsectors.push_back(subsector);
+      numSegs += count;
+   }
+
+   const size_t segSize = 8 + (layout->wideLinedefs ? 4 : 2) + 1;
+   if(stream.ReadInt() != static_cast<int32_t>(numSegs) || stream.Remaining() / segSize < numSegs)
+      return false;
+   nodes.segs.reserve(numSegs * segsPerSeg);
+   for(size_t i = 0; i < numSegs; ++i)
+   {
+      uint32_t v1 = stream.ReadInt();
+      uint32_t second = stream.ReadInt();   // partner, or end for vanilla style
+      uint32_t linedef = layout->wideLinedefs ? stream.ReadInt() :
+      static_cast<uint16_t>(stream.ReadShort());
+      if(!layout->wideLinedefs && linedef == 0xffff)
+         linedef = gNoIndex;
+      int side = stream.ReadByte();
+      GLSeg seg;
+      seg.v1 = mapVertex(v1);
+      seg.linedef = linedef == gNoIndex ? -1 : static_cast<int>(linedef);
+      seg.side = side;
+      if(layout->gl)
+      {
+         seg.partner = second == gNoIndex ? -1 : static_cast<int>(second);
+         nodes.segs.push_back(seg);
+         continue;
+      }
+      seg.partner = -1;
+      nodes.segs.push_back(seg);
+      nodes.segs.push_back({ mapVertex(second), -1, -1, 0 });
+      if(seg.linedef < 0)
+         return false;
+   }
+
+   const size_t nodeSize = layout->fixedNodes ? 40 : 32;
+   uint32_t numNodes = stream.ReadInt();
+   if(stream.Remaining() / nodeSize < numNodes)
+      return false;
+   for(uint32_t i = 0; i < numNodes; ++i)
+      nodes.nodes.push_back(NodeReader_readNode(stream, layout->fixedNodes, true));
+   format = layout->signature;
+   return true;
+}
+
+//
+// Checks whether a GL_LEVEL marker is for the given level. Its text has a
+// LEVEL= line with the name.
+//
+static bool NodeReader_markerNamesLevel(const Lump &marker, const char *levelName)
+{
+   const char *text = reinterpret_cast<const char *>(marker.Data());
+   const char *end = text + marker.Size();
+   const size_t nameLength = strlen(levelName);
+   while(text < end)
+   {
+      const char *lineEnd = static_cast<const char *>(memchr(text, '\n', end - text));
+      if(!lineEnd)
+         lineEnd = end;
+      size_t length = lineEnd - text;
+      if(length && text[length - 1] == '\r')
+         --length;
+      if(length == 6 + nameLength && !strncasecmp(text, "LEVEL=", 6) &&
+         !strncasecmp(text + 6, levelName, nameLength))
+      {
+         return true;
+      }
+      text = lineEnd + 1;
+   }
+   return false;
+}
+
+//
+// Finds the glBSP lumps of a level. They come after a GL_ marker named after
+// it, or for long names after a GL_LEVEL marker naming it. The last marker
+// found wins, as with other lumps. Fails if they can't be read.
+//
+static bool NodeReader_findGLLumps(const Wad &wad, const char *levelName,
+                                   const Lump *glLumps[4], MessageLog &log)
+{
+   static const char *const glLumpNames[4] = { "GL_VERT", "GL_SEGS", "GL_SSECT",
+      "GL_NODES" };
+   std::vector<int> markers;
+   if(strlen(levelName) <= 5)
+   {
+      char markerName[9];
+      snprintf(markerName, sizeof(markerName), "GL_%s", levelName);
+      const std::vector<int> *found = wad.FindLumps(markerName);
+      if(found)
+         markers = *found;
+   }
+   const std::vector<int> *found = wad.FindLumps("GL_LEVEL");
+   if(found)
+      for(int index : *found)
+         if(NodeReader_markerNamesLevel(wad.Lumps()[index], levelName))
+            markers.push_back(index);
+   std::sort(markers.begin(), markers.end());
+
+   const std::vector<Lump> &lumps = wad.Lumps();
+   for(auto it = markers.rbegin(); it != markers.rend(); ++it)
+   {
+      bool complete = static_cast<size_t>(*it) + 4 < lumps.size();
+      for(int i = 0; i < 4 && complete; ++i)
+      {
+         glLumps[i] = &lumps[*it + 1 + i];
+         complete = !strcasecmp(glLumps[i]->Name(), glLumpNames[i]);
+      }
+      if(!complete)
+         continue;
+      for(int i = 0; i < 4; ++i)
+      {
+         if(glLumps[i]->Failed())
+         {
+            log.Warning("Failed reading lump %s of %s\n", glLumps[i]->Name(), levelName);
+            return false;
+         }
+      }
+      return true;
+   }
+   return false;
+}
+
+//
+// Reads glBSP nodes. Version 1 has integer vertices and 16-bit indices,
+// version 2 adds 16.16 vertices, version 3 has 32-bit seg and subsector
+// indices, and version 5 (or Vavoom's 4) 32-bit node children too. Segs
+// referencing GL vertices have the top (or for version 3 second from top)
+// bit of their indices set.
+//
+static bool NodeReader_readGLLumps(const DoomLevel &level, const Lump *const glLumps[4],
+                                   GLNodes &nodes, std::string &format)
+{
+   const Lump &vertLump = *glLumps[0], &segLump = *glLumps[1], &ssectLump = *glLumps[2];
+   const Lump &nodeLump = *glLumps[3];
+   auto hasMagic = [](const Lump &lump, const char *magic) {
+      return lump.Size() >= 4 && !memcmp(lump.Data(), magic, 4);
+   };
+   int version = 1;
+   if(hasMagic(vertLump, "gNd5") || hasMagic(vertLump, "gNd4"))
+      version = 5;
+   else if(hasMagic(vertLump, "gNd2") || hasMagic(vertLump, "gNd3"))
+      version = hasMagic(segLump, "gNd3") ? 3 : 2;
+   const bool wide = version >= 3;
+
+   const size_t lumpVertices = NodeReader_startVertices(level, nodes);
+   DataStreamer vertStream(vertLump.Data(), vertLump.Size());
+   if(version > 1)
+   {
+      vertStream.ReadInt();   // magic
+      while(vertStream.Remaining() >= 8)
+      {
+         Vertex vertex;
+         vertex.x = vertStream.ReadInt();
+         vertex.y = vertStream.ReadInt();
+         nodes.newVertices.push_back(vertex);
+      }
+   }
+   else
+   {
+      while(vertStream.Remaining() >= 4)
+      {
+         Vertex vertex;
+         vertex.x = vertStream.ReadShort() << 16;
+         vertex.y = vertStream.ReadShort() << 16;
+         nodes.newVertices.push_back(vertex);
+      }
+   }
+   const size_t numVertices = nodes.numOriginalVertices + nodes.newVertices.size();
+   const uint32_t glBit = version == 5 ? 0x80000000 : version == 3 ? 0x40000000 : 0x8000;
+   auto mapVertex = [glBit, lumpVertices, numVertices](uint32_t index) {
+      size_t mapped = index & glBit ? lumpVertices + (index & ~glBit) : index;
+      if(!(index & glBit) && mapped >= lumpVertices)
+         return -1;
+      return mapped < numVertices ? static_cast<int>(mapped) : -1;
+   };
+
+   DataStreamer segStream(segLump.Data(), segLump.Size());
+   if(version == 3)
+      segStream.ReadInt();
+   std::vector<GLSeg> segs;
+   const size_t segSize = wide ? 16 : 10;
+   while(segStream.Remaining() >= segSize)
+   {
+      GLSeg seg;
+      uint32_t v1, linedef, partner;
+      if(wide)
+      {
+         v1 = segStream.ReadInt();
+         segStream.ReadInt();   // end, which is the next seg's start
+         linedef = static_cast<uint16_t>(segStream.ReadShort());
+         seg.side = static_cast<uint16_t>(segStream.ReadShort());
+         partner = segStream.ReadInt();
+      }
+      else
+      {
+         v1 = static_cast<uint16_t>(segStream.ReadShort());
+         segStream.ReadShort();
+         linedef = static_cast<uint16_t>(segStream.ReadShort());
+         seg.side = static_cast<uint16_t>(segStream.ReadShort());
+         partner = static_cast<uint16_t>(segStream.ReadShort());
+         if(partner == 0xffff)
+            partner = gNoIndex;
+      }
+      seg.v1 = mapVertex(v1);
+      seg.linedef = linedef == 0xffff ? -1 : static_cast<int>(linedef);
+      seg.partner = partner == gNoIndex ? -1 : static_cast<int>(partner);
+      segs.push_back(seg);
+   }
+
+   // Subsectors may list their segs in any order, but XGL3 needs them in
+   // subsector order.
+   DataStreamer ssectStream(ssectLump.Data(), ssectLump.Size());
+   if(version == 3)
+      ssectStream.ReadInt();
+   std::vector<int> newIndices(segs.size(), -1);
+   while(ssectStream.Remaining() >= (wide ? 8u : 4u))
+   {
+      uint32_t count, first;
+      if(wide)
+      {
+         count = ssectStream.ReadInt();
+         first = ssectStream.ReadInt();
+      }
+      else
+      {
+         count = static_cast<uint16_t>(ssectStream.ReadShort());
+         first = static_cast<uint16_t>(ssectStream.ReadShort());
+      }
+      if(first >= segs.size() || count > segs.size() - first)
+         return false;
+      Subsector subsector;
+      subsector.startseg = static_cast<int>(nodes.segs.size());
+      subsector.segcount = static_cast<int>(count);
+      for(uint32_t i = first; i < first + count; ++i)
+      {
+         if(newIndices[i] >= 0)
+            return false;
+         newIndices[i] = static_cast<int>(nodes.segs.size());
+         nodes.segs.push_back(segs[i]);
+      }
+      nodes.subsectors.push_back(subsector);
+   }
+   for(GLSeg &seg : nodes.segs)
+      if(seg.partner >= 0)
+      {
+         seg.partner = static_cast<size_t>(seg.partner) < newIndices.size() ?
+         newIndices[seg.partner] : -1;
+      }
+
+   DataStreamer nodeStream(nodeLump.Data(), nodeLump.Size());
+   const size_t nodeSize = version == 5 ? 32 : 28;
+   while(nodeStream.Remaining() >= nodeSize)
+      nodes.nodes.push_back(NodeReader_readNode(nodeStream, false, version == 5));
+
+   char name[16];
+   snprintf(name, sizeof(name), "GL v%d", version);
+   format = name;
+   return true;
+}
+
+//
+// Checks that the nodes only reference existing items, and that node children
+// come before their parents, so the tree has no loops
+//
+static bool NodeReader_check(const DoomLevel &level, const GLNodes &nodes)
+{
+   if(nodes.segs.empty() || nodes.subsectors.empty() ||
+      (nodes.nodes.empty() && nodes.subsectors.size() > 1))
+   {
+      return false;
+   }
+   const size_t numVertices = nodes.numOriginalVertices + nodes.newVertices.size();
+   const size_t numLines = level.GetLinedefs().size();
+   for(const GLSeg &seg : nodes.segs)
+   {
+      if(seg.v1 < 0 || static_cast<size_t>(seg.v1) >= numVertices ||
+         (seg.linedef >= 0 && static_cast<size_t>(seg.linedef) >= numLines) ||
+         (seg.partner >= 0 && static_cast<size_t>(seg.partner) >= nodes.segs.size()) ||
+         (seg.linedef >= 0 && seg.side != 0 && seg.side != 1))
+      {
+         return false;
+      }
+   }
+   size_t next = 0;
+   for(const Subsector &subsector : nodes.subsectors)
+   {
+      if(subsector.segcount <= 0 || static_cast<size_t>(subsector.startseg) != next)
+         return false;
+      next += subsector.segcount;
+   }
+   if(next != nodes.segs.size())
+      return false;
+   for(size_t i = 0; i < nodes.nodes.size(); ++i)
+   {
+      const Node &node = nodes.nodes[i];
+      for(int child : { node.rightchild, node.leftchild })
+      {
+         uint32_t index = static_cast<uint32_t>(child);
+         if(index & NF_SUBSECTOR ? (index & ~NF_SUBSECTOR) >= nodes.subsectors.size() :
+            index >= i)
+         {
+            return false;
+         }
+      }
+   }
+   return true;
+}
+
+//
+// Reads the level's own GL nodes, if it ships any that can be used: ZDoom
+// extended nodes in NODES or, for GL ones, SSECTORS, or glBSP nodes after a
+// GL marker. Vertices keep their precision, and minisegs are kept. The format
+// gets named for reporting.
+//
+bool ReadGLNodes(const Wad &wad, const LumpInfo &info, const DoomLevel &level,
+                 GLNodes &nodes, std::string &format, MessageLog &log)
+{
+   const std::vector<Lump> &lumps = wad.Lumps();
+   for(int offset : { 7, 6 })
+   {
+      if(NodeReader_readZDoom(level, lumps[info.index + offset], nodes, format) &&
+         NodeReader_check(level, nodes))
+      {
+         return true;
+      }
+   }
+   const Lump *glLumps[4];
+   if(NodeReader_findGLLumps(wad, info.lump->Name(), glLumps, log) &&
+      NodeReader_readGLLumps(level, glLumps, nodes, format) &&
+      NodeReader_check(level, nodes))
+   {
+      return true;
+   }
+   nodes = GLNodes();
+   return false;
+}
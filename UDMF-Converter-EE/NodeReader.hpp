@@ -0,0 +1,39 @@
+//
+// UDMF Converter EE
+// Copyright (C) 2019 Ioan Chera
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/
+//
+// Additional terms and conditions compatible with the GPLv3 apply. See the
+// file COPYING-EE for details.
+//
+// Purpose: Readers of GL and extended nodes shipped with levels
+// Authors: Ioan Chera
+//
+
+#ifndef NodeReader_hpp
+#define NodeReader_hpp
+
+#include <string>
+
+class DoomLevel;
+class Wad;
+struct GLNodes;
+struct LumpInfo;
+struct MessageLog;
+
+bool ReadGLNodes(const Wad &wad, const LumpInfo &info, const DoomLevel &level,
+                 GLNodes &nodes, std::string &format, MessageLog &log);
+
+#endif /* NodeReader_hpp */
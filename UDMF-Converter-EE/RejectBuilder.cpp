@@ -0,0 +1,475 @@
+//
+// UDMF Converter EE
+// Copyright (C) 2019 Ioan Chera
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/
+//
+// Additional terms and conditions compatible with the GPLv3 apply. See the
+// file COPYING-EE for details.
+//
+// Purpose: REJECT builder
+// Authors: Ioan Chera
+//
+
+#include <math.h>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include "DoomLevel.hpp"
+#include "RejectBuilder.hpp"
+#include "ThreadPool.hpp"
+
+enum
+{
+   SectorsPerTask = 64,          // fewest sectors worth handing to another thread
+   MaxStepsPerSector = 1 << 20,  // portals tried from a sector before giving up on it
+};
+
+static const double gOnLineEpsilon = 1.0 / 256;
+
+//
+// Point on the map
+//
+struct RejectPoint
+{
+   double x, y;
+};
+
+//
+// Part of a two-sided line, with its ends named as seen when going through it
+//
+struct RejectWinding
+{
+   RejectPoint left, right;
+};
+
+//
+// Two-sided line seen from one of its sectors, as a way into the other one
+//
+struct RejectPortal
+{
+   RejectWinding winding;
+   int line;
+   int to;
+   size_t index;  // among all portals of all sectors
+};
+
+//
+// Part of a portal, as fractions from its left end to its right one
+//
+struct RejectSpan
+{
+   double low, high;
+
+   bool Contains(const RejectSpan &other, double slack) const
+   {
+      return other.low >= low - slack && other.high <= high + slack;
+   }
+};
+
+//
+// How far the sight from a sector got into a portal: the parts of the first
+// portal it went through (the source) and of this one (the pass) which a
+// straight line may still join. Stamp tells which trace it's from.
+//
+struct RejectReach
+{
+   RejectSpan source;
+   RejectSpan pass;
+   unsigned stamp;
+   bool queued;
+};
+
+//
+// Level prepared for sight checks
+//
+struct RejectMap
+{
+   size_t numSectors;
+   size_t rowWords;                          // 64-bit words in a visibility row
+   std::vector<std::vector<RejectPortal>> exits;   // portals by sector
+   std::vector<const RejectPortal *> portals;
+   std::vector<int> components;              // sectors joined by two-sided lines
+   std::vector<size_t> componentSizes;
+   std::vector<uint64_t> visible;            // row per sector
+};
+
+//
+// What one thread needs for tracing
+//
+struct RejectScratch
+{
+   std::vector<RejectReach> reaches;   // by portal
+   std::vector<const RejectPortal *> queue;
+   unsigned stamp = 0;
+};
+
+//
+// Finds the group of sectors, for joining groups
+//
+static int Reject_findComponent(std::vector<int> &components, int sector)
+{
+   while(components[sector] != sector)
+      sector = components[sector] = components[components[sector]];
+   return sector;
+}
+
+//
+// Sets up the portals, and which sectors are joined by them at all
+//
+static void Reject_prepare(const DoomLevel &level, RejectMap &map)
+{
+   map.numSectors = level.GetSectors().size();
+   map.rowWords = (map.numSectors + 63) / 64;
+   map.exits.assign(map.numSectors, std::vector<RejectPortal>());
+   map.components.resize(map.numSectors);
+   for(size_t i = 0; i < map.numSectors; ++i)
+      map.components[i] = static_cast<int>(i);
+   map.componentSizes.assign(map.numSectors, 0);
+   map.visible.assign(map.numSectors * map.rowWords, 0);
+
+   const std::vector<Linedef> &linedefs = level.GetLinedefs();
+   const std::vector<Sidedef> &sidedefs = level.GetSidedefs();
+   for(size_t i = 0; i < linedefs.size(); ++i)
+   {
+      const Linedef &linedef = linedefs[i];
+      const Vertex *v1 = level.GetVertex(linedef.v1);
+      const Vertex *v2 = level.GetVertex(linedef.v2);
+      if(!v1 || !v2 || (v1->x == v2->x && v1->y == v2->y))
+         continue;
+      int sectors[2];
+      bool valid = true;
+      for(int side = 0; side < 2 && valid; ++side)
+      {
+         int sidenum = linedef.sidenum[side];
+         valid = sidenum >= 0 && static_cast<size_t>(sidenum) < sidedefs.size() &&
+         sidedefs[sidenum].sector >= 0 &&
+         static_cast<size_t>(sidedefs[sidenum].sector) < map.numSectors;
+         if(valid)
+            sectors[side] = sidedefs[sidenum].sector;
+      }
+      if(!valid)
+         continue;
+      // Going from front to back, the start vertex is on the left
+      RejectPoint start = { static_cast<double>(v1->x), static_cast<double>(v1->y) };
+      RejectPoint end = { static_cast<double>(v2->x), static_cast<double>(v2->y) };
+      int line = static_cast<int>(i);
+      map.exits[sectors[0]].push_back({ { start, end }, line, sectors[1], 0 });
+      map.exits[sectors[1]].push_back({ { end, start }, line, sectors[0], 0 });
+      int first = Reject_findComponent(map.components, sectors[0]);
+      int second = Reject_findComponent(map.components, sectors[1]);
+      if(first != second)
+         map.components[std::max(first, second)] = std::min(first, second);
+   }
+   for(size_t i = 0; i < map.numSectors; ++i)
+   {
+      ++map.componentSizes[Reject_findComponent(map.components, static_cast<int>(i))];
+      for(RejectPortal &portal : map.exits[i])
+      {
+         portal.index = map.portals.size();
+         map.portals.push_back(&portal);
+      }
+   }
+}
+
+//
+// Distance of a point from the line going through a and b, positive on the
+// left. Returns false if a and b are the same point.
+//
+static bool Reject_side(const RejectPoint &a, const RejectPoint &b, const RejectPoint &point,
+                        double &distance)
+{
+   double dx = b.x - a.x, dy = b.y - a.y;
+   double length = sqrt(dx * dx + dy * dy);
+   if(length < gOnLineEpsilon)
+      return false;
+   distance = (dx * (point.y - a.y) - dy * (point.x - a.x)) / length;
+   return true;
+}
+
+//
+// Cuts off the part of a winding on the given side of the line through a and
+// b: the right side if sign is positive, the left one otherwise. Points close
+// to the line are kept. Returns false if nothing is left.
+//
+static bool Reject_clip(RejectWinding &winding, const RejectPoint &a, const RejectPoint &b,
+                        double sign)
+{
+   double left, right;
+   if(!Reject_side(a, b, winding.left, left) || !Reject_side(a, b, winding.right, right))
+      return true;
+   left = left * sign + gOnLineEpsilon;
+   right = right * sign + gOnLineEpsilon;
+   if(left < 0 && right < 0)
+      return false;
+   if(left < 0 || right < 0)
+   {
+      double frac = left / (left - right);
+      RejectPoint cut = { winding.left.x + (winding.right.x - winding.left.x) * frac,
+                          winding.left.y + (winding.right.y - winding.left.y) * frac };
+      (left < 0 ? winding.left : winding.right) = cut;
+   }
+   return true;
+}
+
+//
+// Keeps the part of the target which can be reached by a straight line going
+// from the source through the pass. Lines through an end of each, with the
+// other ends on opposite sides, separate the source from the pass; whatever
+// is behind them can't be seen.
+//
+static bool Reject_clipToSeparators(const RejectWinding &source, const RejectWinding &pass,
+                                    RejectWinding &target)
+{
+   const RejectPoint sourceEnds[2] = { source.left, source.right };
+   const RejectPoint passEnds[2] = { pass.left, pass.right };
+   for(int i = 0; i < 2; ++i)
+      for(int j = 0; j < 2; ++j)
+      {
+         const RejectPoint &a = sourceEnds[i], &b = passEnds[j];
+         double sourceSide, passSide;
+         if(!Reject_side(a, b, sourceEnds[!i], sourceSide) ||
+            !Reject_side(a, b, passEnds[!j], passSide))
+         {
+            continue;
+         }
+         if(sourceSide < -gOnLineEpsilon && passSide > gOnLineEpsilon)
+         {
+            if(!Reject_clip(target, a, b, 1))
+               return false;
+         }
+         else if(sourceSide > gOnLineEpsilon && passSide < -gOnLineEpsilon)
+         {
+            if(!Reject_clip(target, a, b, -1))
+               return false;
+         }
+      }
+   return true;
+}
+
+//
+// Converts between a span of a portal and the part of the map it stands for
+//
+static RejectWinding Reject_spanWinding(const RejectPortal &portal, const RejectSpan &span)
+{
+   const RejectPoint &left = portal.winding.left, &right = portal.winding.right;
+   double dx = right.x - left.x, dy = right.y - left.y;
+   return { { left.x + dx * span.low, left.y + dy * span.low },
+            { left.x + dx * span.high, left.y + dy * span.high } };
+}
+static RejectSpan Reject_windingSpan(const RejectPortal &portal, const RejectWinding &winding)
+{
+   const RejectPoint &left = portal.winding.left, &right = portal.winding.right;
+   double dx = right.x - left.x, dy = right.y - left.y;
+   double lengthSquared = dx * dx + dy * dy;
+   double low = ((winding.left.x - left.x) * dx + (winding.left.y - left.y) * dy) /
+   lengthSquared;
+   double high = ((winding.right.x - left.x) * dx + (winding.right.y - left.y) * dy) /
+   lengthSquared;
+   return { std::min(low, high), std::max(low, high) };
+}
+
+//
+// Marks the sectors which a line of sight from the given one may reach. Such a
+// line leaves through one of the sector's portals, then goes through a chain
+// of them, each one leading out of the sector entered through the previous
+// one. For each portal reached, only the parts of it and of the first portal
+// which a straight line may still join are kept, and going on from there
+// narrows them further. When a portal is reached again, what was kept for it
+// grows to cover both ways in, and it's gone through again unless nothing
+// was added. That can only see more than a line would, never less, but it
+// doesn't have to follow every chain. Heights are ignored, so anything seen
+// through an opening door counts. Returns false if there were too many
+// portals to go through, leaving it to the caller to assume the worst.
+//
+static bool Reject_trace(const RejectMap &map, int source, uint64_t *row,
+                         RejectScratch &scratch)
+{
+   size_t seen = 0;
+   auto see = [row, &seen](int sector) {
+      uint64_t bit = uint64_t(1) << (sector % 64);
+      if(!(row[sector / 64] & bit))
+      {
+         row[sector / 64] |= bit;
+         ++seen;
+      }
+   };
+   const size_t reachable = map.componentSizes[map.components[source]];
+   see(source);
+   size_t steps = 0;
+   std::vector<RejectReach> &reaches = scratch.reaches;
+   std::vector<const RejectPortal *> &queue = scratch.queue;
+   for(const RejectPortal &start : map.exits[source])
+   {
+      see(start.to);
+      if(!++scratch.stamp)
+      {
+         // Stamps wrapped around, so old ones could look current
+         for(RejectReach &reach : reaches)
+            reach.stamp = 0;
+         scratch.stamp = 1;
+      }
+      const unsigned stamp = scratch.stamp;
+      reaches[start.index] = { { 0, 1 }, { 0, 1 }, stamp, true };
+      queue.assign(1, &start);
+      for(size_t head = 0; head < queue.size() && seen < reachable; ++head)
+      {
+         const RejectPortal &portal = *queue[head];
+         RejectReach &reach = reaches[portal.index];
+         reach.queued = false;
+         const RejectWinding source = Reject_spanWinding(start, reach.source);
+         const RejectWinding pass = Reject_spanWinding(portal, reach.pass);
+         for(const RejectPortal &exit : map.exits[portal.to])
+         {
+            if(exit.line == portal.line || exit.line == start.line)
+               continue;
+            if(++steps > MaxStepsPerSector)
+               return false;
+            // The next portal must be past both the source and the pass, and
+            // the source behind it.
+            RejectWinding target = exit.winding;
+            RejectWinding sourcePart = source;
+            if(!Reject_clip(target, pass.right, pass.left, -1) ||
+               !Reject_clip(target, source.right, source.left, -1) ||
+               !Reject_clip(sourcePart, target.right, target.left, 1) ||
+               !Reject_clipToSeparators(sourcePart, pass, target) ||
+               !Reject_clipToSeparators(target, pass, sourcePart))
+            {
+               continue;
+            }
+            see(exit.to);
+            RejectSpan sourceSpan = Reject_windingSpan(start, sourcePart);
+            RejectSpan passSpan = Reject_windingSpan(exit, target);
+            RejectReach &next = reaches[exit.index];
+            if(next.stamp != stamp)
+               next = { sourceSpan, passSpan, stamp, false };
+            else if(next.source.Contains(sourceSpan, gOnLineEpsilon) &&
+                    next.pass.Contains(passSpan, gOnLineEpsilon))
+            {
+               continue;
+            }
+            else
+            {
+               next.source = { std::min(next.source.low, sourceSpan.low),
+                  std::max(next.source.high, sourceSpan.high) };
+               next.pass = { std::min(next.pass.low, passSpan.low),
+                  std::max(next.pass.high, passSpan.high) };
+            }
+            if(!next.queued)
+            {
+               next.queued = true;
+               queue.push_back(&exit);
+            }
+         }
+      }
+      if(seen == reachable)
+         break;
+   }
+   return true;
+}
+
+//
+// Traces the sight of every numTasks-th sector starting from the given one
+//
+static size_t Reject_traceRows(RejectMap &map, size_t first, size_t numTasks)
+{
+   RejectScratch scratch;
+   scratch.reaches.resize(map.portals.size());
+   size_t givenUp = 0;
+   for(size_t sector = first; sector < map.numSectors; sector += numTasks)
+   {
+      uint64_t *row = &map.visible[sector * map.rowWords];
+      if(Reject_trace(map, static_cast<int>(sector), row, scratch))
+         continue;
+      // Too many ways to look: assume everything joined to it can be seen
+      ++givenUp;
+      for(size_t other = 0; other < map.numSectors; ++other)
+         if(map.components[other] == map.components[sector])
+            row[other / 64] |= uint64_t(1) << (other % 64);
+   }
+   return givenUp;
+}
+
+//
+// Runs the work for each task number, all but the last one on the pool
+//
+static void Reject_runTasks(ThreadPool *pool, size_t numTasks,
+                            const std::function<void(size_t)> &work)
+{
+   std::vector<std::shared_ptr<PoolTask>> tasks;
+   for(size_t i = 0; i < numTasks; ++i)
+   {
+      if(i + 1 < numTasks)
+         tasks.push_back(PoolTask::Start(*pool, [&work, i]() { work(i); }));
+      else
+         work(i);
+   }
+   for(const std::shared_ptr<PoolTask> &task : tasks)
+      task->Join();
+}
+
+//
+// Builds REJECT from line of sight between sectors. Sight only goes through
+// two-sided lines, so a sector pair is only marked hidden if no straight line
+// can pass from one to the other through them. The sectors are divided among
+// the pool's threads if given, each tracing the sight from its own rows of the
+// matrix. Pairs are then only hidden if neither side sees the other. If no
+// pair is hidden, the lump is left empty, which ports read as rejecting
+// nothing. Fails if the map has no sectors.
+//
+bool BuildReject(const DoomLevel &level, ThreadPool *pool, std::vector<uint8_t> &reject,
+                 RejectInfo &info)
+{
+   info = RejectInfo();
+   reject.clear();
+   RejectMap map;
+   Reject_prepare(level, map);
+   const size_t numSectors = map.numSectors;
+   if(!numSectors)
+      return false;
+   info.sectors = numSectors;
+
+   size_t numTasks = 1;
+   if(pool)
+   {
+      numTasks = std::min(static_cast<size_t>(pool->NumThreads()),
+                          numSectors / SectorsPerTask + 1);
+   }
+   std::vector<size_t> givenUp(numTasks);
+   Reject_runTasks(pool, numTasks, [&map, numTasks, &givenUp](size_t task) {
+      givenUp[task] = Reject_traceRows(map, task, numTasks);
+   });
+   for(size_t count : givenUp)
+      info.givenUp += count;
+
+   // Sector a not seeing b is bit a * sectors + b
+   std::vector<uint8_t> bits((numSectors * numSectors + 7) / 8);
+   for(size_t a = 0; a < numSectors; ++a)
+   {
+      const uint64_t *row = &map.visible[a * map.rowWords];
+      for(size_t b = 0; b < numSectors; ++b)
+      {
+         const uint64_t *other = &map.visible[b * map.rowWords];
+         if(row[b / 64] >> (b % 64) & 1 || other[a / 64] >> (a % 64) & 1)
+            continue;
+         size_t bit = a * numSectors + b;
+         bits[bit / 8] |= 1 << (bit % 8);
+         ++info.hiddenPairs;
+      }
+   }
+   if(info.hiddenPairs)
+      reject.swap(bits);
+   info.size = reject.size();
+   return true;
+}
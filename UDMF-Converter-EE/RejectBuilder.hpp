@@ -0,0 +1,49 @@
+//
+// UDMF Converter EE
+// Copyright (C) 2019 Ioan Chera
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/
+//
+// Additional terms and conditions compatible with the GPLv3 apply. See the
+// file COPYING-EE for details.
+//
+// Purpose: REJECT builder
+// Authors: Ioan Chera
+//
+
+#ifndef RejectBuilder_hpp
+#define RejectBuilder_hpp
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+class DoomLevel;
+class ThreadPool;
+
+//
+// What got built
+//
+struct RejectInfo
+{
+   size_t sectors = 0;
+   size_t hiddenPairs = 0;    // ordered pairs of sectors which can't see each other
+   size_t givenUp = 0;        // sectors with too many sight paths to follow
+   size_t size = 0;           // bytes
+};
+
+bool BuildReject(const DoomLevel &level, ThreadPool *pool, std::vector<uint8_t> &reject,
+                 RejectInfo &info);
+
+#endif /* RejectBuilder_hpp */
@@ -39,6 +39,8 @@ const char *ResultMessage(Result result)
          return "File has invalid data.";
       case Result::CannotOpen:
          return "Cannot open or file not found.";
+      case Result::CannotWrite:
+         return "Cannot write file.";
       case Result::LevelNotFound:
          return "WAD file doesn't have the requested level.";
       default:
@@ -34,6 +34,7 @@ enum class Result
    BadFile,          // Bad file format
    BadData,          // bad data format
    CannotOpen,       // cannot open file
+   CannotWrite,      // cannot write file
    LevelNotFound,    // wad hasn't got the level
 };
 
@@ -0,0 +1,301 @@
+//
+// UDMF Converter EE
+// Copyright (C) 2019 Ioan Chera
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/
+//
+// Additional terms and conditions compatible with the GPLv3 apply. See the
+// file COPYING-EE for details.
+//
+// Purpose: Conversion timing and counters
+// Authors: Ioan Chera
+//
+
+#include "Helpers.hpp"
+#include "Stats.hpp"
+#include "hal/i_platform.h"
+
+#if EE_CURRENT_PLATFORM == EE_PLATFORM_WINDOWS
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+// Names used in both reports
+static const char *const gStageNames[] =
+{
+   "wad_load",
+   "find_levels",
+   "emapinfo",
+   "extradata",
+   "level_load",
+   "udmf_build",
+   "textmap",
+   "node_read",
+   "node_build",
+   "znodes",
+   "blockmap",
+   "reject",
+   "wad_write"
+};
+static_assert(lengthof(gStageNames) == static_cast<int>(Stage::count),
+              "Stage names don't match the stages");
+
+#if EE_CURRENT_PLATFORM == EE_PLATFORM_WINDOWS
+static double Stats_fileTimeSeconds(const FILETIME &kernel, const FILETIME &user)
+{
+   ULARGE_INTEGER k, u;
+   k.LowPart = kernel.dwLowDateTime;
+   k.HighPart = kernel.dwHighDateTime;
+   u.LowPart = user.dwLowDateTime;
+   u.HighPart = user.dwHighDateTime;
+   return (k.QuadPart + u.QuadPart) * 1e-7;   // 100 ns units
+}
+#endif
+
+//
+// CPU time used by the calling thread, in seconds
+//
+static double Stats_threadCPUTime()
+{
+#if EE_CURRENT_PLATFORM == EE_PLATFORM_WINDOWS
+   FILETIME creation, exit, kernel, user;
+   if(!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user))
+      return 0;
+   return Stats_fileTimeSeconds(kernel, user);
+#else
+   timespec ts;
+   if(clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts))
+      return 0;
+   return ts.tv_sec + ts.tv_nsec * 1e-9;
+#endif
+}
+
+//
+// CPU time used by all the threads of the process, in seconds
+//
+static double Stats_processCPUTime()
+{
+#if EE_CURRENT_PLATFORM == EE_PLATFORM_WINDOWS
+   FILETIME creation, exit, kernel, user;
+   if(!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+      return 0;
+   return Stats_fileTimeSeconds(kernel, user);
+#else
+   timespec ts;
+   if(clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts))
+      return 0;
+   return ts.tv_sec + ts.tv_nsec * 1e-9;
+#endif
+}
+
+static double Stats_secondsSince(std::chrono::steady_clock::time_point start)
+{
+   return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                        start).count();
+}
+
+void StageStats::Add(const StageStats &other)
+{
+   wall += other.wall;
+   cpu += other.cpu;
+   bytes += other.bytes;
+   items += other.items;
+   runs += other.runs;
+}
+
+//
+// Sum of all stages. Bytes and items aren't added up, being of different kinds.
+//
+StageStats RunStats::Total() const
+{
+   StageStats total;
+   for(const StageStats &stage : stages)
+   {
+      total.wall += stage.wall;
+      total.cpu += stage.cpu;
+      total.runs += stage.runs;
+   }
+   return total;
+}
+
+StageTimer::StageTimer(RunStats *run, Stage stage) :
+mStats(run ? &(*run)[stage] : nullptr)
+{
+   if(!mStats)
+      return;
+   mWallStart = std::chrono::steady_clock::now();
+   mCPUStart = Stats_threadCPUTime();
+}
+
+StageTimer::~StageTimer()
+{
+   if(!mStats)
+      return;
+   mStats->wall += Stats_secondsSince(mWallStart);
+   mStats->cpu += Stats_threadCPUTime() - mCPUStart;
+   ++mStats->runs;
+}
+
+//
+// Adds to the amount of data handled by the stage
+//
+void StageTimer::Count(uint64_t bytes, uint64_t items)
+{
+   if(!mStats)
+      return;
+   mStats->bytes += bytes;
+   mStats->items += items;
+}
+
+//
+// Starts the clocks of the whole conversion
+//
+StatsReport::StatsReport() :
+mWallStart(std::chrono::steady_clock::now()),
+mCPUStart(Stats_processCPUTime())
+{
+   mGlobal.name = "(global)";
+}
+
+//
+// Adds the stats of a new map. Not thread-safe: add all maps from one thread.
+//
+RunStats &StatsReport::AddMap(const char *name)
+{
+   mMaps.emplace_back();
+   mMaps.back().name = name;
+   return mMaps.back();
+}
+
+//
+// Stops the clocks of the whole conversion
+//
+void StatsReport::Finish()
+{
+   mWall = Stats_secondsSince(mWallStart);
+   mCPU = Stats_processCPUTime() - mCPUStart;
+}
+
+//
+// Stage total over all maps and the global work
+//
+StageStats StatsReport::Total(Stage stage) const
+{
+   StageStats total = mGlobal[stage];
+   for(const RunStats &map : mMaps)
+      total.Add(map[stage]);
+   return total;
+}
+
+static void Stats_printTextRow(FILE *f, const char *name, const char *stage,
+                               const StageStats &stats, bool counts)
+{
+   fprintf(f, "%-10s %-12s %10.3f %10.3f", name, stage, stats.wall * 1000,
+           stats.cpu * 1000);
+   if(counts)
+   {
+      fprintf(f, " %12llu %10llu", static_cast<unsigned long long>(stats.bytes),
+              static_cast<unsigned long long>(stats.items));
+   }
+   fputc('\n', f);
+}
+
+static void Stats_printTextRun(FILE *f, const RunStats &run)
+{
+   for(int i = 0; i < static_cast<int>(Stage::count); ++i)
+      if(run.stages[i].runs)
+         Stats_printTextRow(f, run.name.c_str(), gStageNames[i], run.stages[i], true);
+}
+
+//
+// Prints a table for people
+//
+void StatsReport::PrintText(FILE *f) const
+{
+   fprintf(f, "%-10s %-12s %10s %10s %12s %10s\n", "Map", "Stage", "Wall ms",
+           "CPU ms", "Bytes", "Items");
+   Stats_printTextRun(f, mGlobal);
+   for(const RunStats &map : mMaps)
+   {
+      Stats_printTextRun(f, map);
+      Stats_printTextRow(f, map.name.c_str(), "all", map.Total(), false);
+   }
+   for(int i = 0; i < static_cast<int>(Stage::count); ++i)
+   {
+      StageStats total = Total(static_cast<Stage>(i));
+      if(total.runs)
+         Stats_printTextRow(f, "(total)", gStageNames[i], total, true);
+   }
+   fprintf(f, "Converted %d maps in %.3f ms (%.3f ms CPU)\n",
+           static_cast<int>(mMaps.size()), mWall * 1000, mCPU * 1000);
+   fputs("Stage CPU ms counts only the thread running the stage, so it leaves out "
+         "node_build, reject and blockmap work done by other pool threads.\nThe "
+         "CPU time of the whole conversion counts all threads.\n", f);
+}
+
+static void Stats_printJSONStage(FILE *f, const StageStats &stats)
+{
+   fprintf(f, "{\"wall_ms\": %.3f, \"cpu_ms\": %.3f, \"bytes\": %llu, "
+           "\"items\": %llu, \"runs\": %d}", stats.wall * 1000, stats.cpu * 1000,
+           static_cast<unsigned long long>(stats.bytes),
+           static_cast<unsigned long long>(stats.items), stats.runs);
+}
+
+static void Stats_printJSONStages(FILE *f, const StageStats *stages,
+                                  const char *indent)
+{
+   fputs("{", f);
+   bool first = true;
+   for(int i = 0; i < static_cast<int>(Stage::count); ++i)
+   {
+      if(!stages[i].runs)
+         continue;
+      fprintf(f, "%s\n%s  \"%s\": ", first ? "" : ",", indent, gStageNames[i]);
+      Stats_printJSONStage(f, stages[i]);
+      first = false;
+   }
+   fprintf(f, "\n%s}", indent);
+}
+
+//
+// Prints the stats as JSON, for tools
+//
+void StatsReport::PrintJSON(FILE *f) const
+{
+   StageStats totals[static_cast<int>(Stage::count)];
+   for(int i = 0; i < static_cast<int>(Stage::count); ++i)
+      totals[i] = Total(static_cast<Stage>(i));
+
+   // Stage CPU times are of the thread running the stage, unlike the total
+   fprintf(f, "{\n  \"wall_ms\": %.3f,\n  \"cpu_ms\": %.3f,\n"
+           "  \"stage_cpu_clock\": \"thread\",\n  \"stages\": ", mWall * 1000,
+           mCPU * 1000);
+   Stats_printJSONStages(f, totals, "  ");
+   fputs(",\n  \"global\": ", f);
+   Stats_printJSONStages(f, mGlobal.stages, "  ");
+   fputs(",\n  \"maps\": [", f);
+   for(size_t i = 0; i < mMaps.size(); ++i)
+   {
+      const RunStats &map = mMaps[i];
+      StageStats total = map.Total();
+      fprintf(f, "%s\n    {\n      \"name\": \"%s\",\n      \"wall_ms\": %.3f,\n"
+              "      \"cpu_ms\": %.3f,\n      \"stages\": ", i ? "," : "",
+              Escape(map.name).c_str(), total.wall * 1000, total.cpu * 1000);
+      Stats_printJSONStages(f, map.stages, "      ");
+      fputs("\n    }", f);
+   }
+   fputs(mMaps.empty() ? "]\n}\n" : "\n  ]\n}\n", f);
+}
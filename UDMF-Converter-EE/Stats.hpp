@@ -0,0 +1,140 @@
+//
+// UDMF Converter EE
+// Copyright (C) 2019 Ioan Chera
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/
+//
+// Additional terms and conditions compatible with the GPLv3 apply. See the
+// file COPYING-EE for details.
+//
+// Purpose: Conversion timing and counters
+// Authors: Ioan Chera
+//
+
+#ifndef Stats_hpp
+#define Stats_hpp
+
+#include <stdint.h>
+#include <stdio.h>
+#include <chrono>
+#include <deque>
+#include <string>
+
+//
+// Measured conversion stages
+//
+enum class Stage : int
+{
+   wadLoad,
+   findLevels,
+   emapinfo,
+   extraData,
+   levelLoad,
+   udmfBuild,
+   textmap,
+   nodeRead,
+   nodeBuild,
+   znodes,
+   blockmap,
+   reject,
+   wadWrite,
+   count
+};
+
+//
+// What a stage took, summed over all its runs
+//
+struct StageStats
+{
+   double wall = 0;     // seconds
+   double cpu = 0;      // seconds of CPU time of the running thread only
+   uint64_t bytes = 0;
+   uint64_t items = 0;
+   int runs = 0;
+
+   void Add(const StageStats &other);
+};
+
+//
+// Stage stats of one map, or of the work not tied to a map
+//
+struct RunStats
+{
+   std::string name;
+   StageStats stages[static_cast<int>(Stage::count)];
+
+   StageStats &operator[](Stage stage)
+   {
+      return stages[static_cast<int>(stage)];
+   }
+   const StageStats &operator[](Stage stage) const
+   {
+      return stages[static_cast<int>(stage)];
+   }
+   StageStats Total() const;
+};
+
+//
+// Times a stage from construction to destruction, adding to the given stats.
+// Does nothing without them, so it's free when stats are off. CPU time is
+// that of the calling thread: work it hands to the pool isn't counted, and
+// the process clock can't be used instead since levels convert concurrently.
+//
+class StageTimer
+{
+public:
+   StageTimer(RunStats *run, Stage stage);
+   ~StageTimer();
+   StageTimer(const StageTimer &other) = delete;
+   StageTimer &operator = (const StageTimer &other) = delete;
+
+   void Count(uint64_t bytes, uint64_t items);
+
+private:
+   StageStats *mStats;
+   std::chrono::steady_clock::time_point mWallStart;
+   double mCPUStart = 0;
+};
+
+//
+// Stats of a whole conversion, printable as text or JSON. Each map's stats
+// may be filled from a different thread.
+//
+class StatsReport
+{
+public:
+   StatsReport();
+
+   RunStats &Global()
+   {
+      return mGlobal;
+   }
+   RunStats &AddMap(const char *name);
+   void Finish();
+
+   void PrintText(FILE *f) const;
+   void PrintJSON(FILE *f) const;
+
+private:
+   StageStats Total(Stage stage) const;
+
+   RunStats mGlobal;
+   std::deque<RunStats> mMaps;   // deque, so references stay valid
+   std::chrono::steady_clock::time_point mWallStart;
+   double mCPUStart;
+   double mWall = 0;
+   double mCPU = 0;
+};
+
+#endif /* Stats_hpp */
@@ -0,0 +1,79 @@
+//
+// UDMF Converter EE
+// Copyright (C) 2019 Ioan Chera
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/
+//
+// Additional terms and conditions compatible with the GPLv3 apply. See the
+// file COPYING-EE for details.
+//
+// Purpose: Checks of TEXTMAP text output
+// Authors: Ioan Chera
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include "../TextmapWriter.hpp"
+
+//
+// Formats a double the way it goes into TEXTMAP
+//
+static std::string Test_format(double value)
+{
+   TextmapWriter writer;
+   writer << value;
+   std::vector<uint8_t> text = writer.Release();
+   return std::string(text.begin(), text.end());
+}
+
+//
+// Checks the formatted double against what's expected. Returns false and
+// tells which value failed if it doesn't match.
+//
+static bool Test_double(double value, const char *expected)
+{
+   std::string text = Test_format(value);
+   if(text == expected)
+      return true;
+   fprintf(stderr, "FAILED: %.17g written as '%s' instead of '%s'\n", value, text.c_str(),
+           expected);
+   return false;
+}
+
+//
+// Entry point
+//
+int main()
+{
+   bool ok = true;
+   // UDMF has no exponent notation, so these must stay in fixed form
+   ok = Test_double(100000, "100000") && ok;
+   ok = Test_double(1000000, "1000000") && ok;
+   ok = Test_double(0.0001, "0.0001") && ok;
+   ok = Test_double(0.00001, "0.00001") && ok;
+   ok = Test_double(-32768, "-32768") && ok;
+   // The shortest text that reads back the same
+   ok = Test_double(0, "0") && ok;
+   ok = Test_double(0.5, "0.5") && ok;
+   ok = Test_double(-1.25, "-1.25") && ok;
+   ok = Test_double(0.1, "0.1") && ok;
+   ok = Test_double(1.0 / 65536, "0.0000152587890625") && ok;
+   ok = Test_double(32767.99998474121, "32767.99998474121") && ok;
+
+   if(!ok)
+      return EXIT_FAILURE;
+   puts("All TextmapWriter checks passed");
+   return EXIT_SUCCESS;
+}
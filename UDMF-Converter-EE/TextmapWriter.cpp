@@ -0,0 +1,51 @@
+//
+// UDMF Converter EE
+// Copyright (C) 2019 Ioan Chera
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/
+//
+// Additional terms and conditions compatible with the GPLv3 apply. See the
+// file COPYING-EE for details.
+//
+// Purpose: Fast TEXTMAP text output
+// Authors: Ioan Chera
+//
+
+#include "TextmapWriter.hpp"
+
+//
+// Writes the shortest text which reads back as the same double. UDMF has no
+// exponent notation, so it's always in fixed form.
+//
+TextmapWriter &TextmapWriter::operator << (double value)
+{
+   char text[512];   // enough for the longest fixed form of any double
+   Append(text, std::to_chars(text, text + sizeof(text), value,
+                              std::chars_format::fixed).ptr - text);
+   return *this;
+}
+
+//
+// Writes a string with quotes and backslashes escaped
+//
+void TextmapWriter::WriteEscaped(const std::string &text)
+{
+   mBuffer.reserve(mBuffer.size() + text.size());
+   for(char c : text)
+   {
+      if(c == '"' || c == '\\')
+         mBuffer.push_back('\\');
+      mBuffer.push_back(static_cast<uint8_t>(c));
+   }
+}
@@ -0,0 +1,81 @@
+//
+// UDMF Converter EE
+// Copyright (C) 2019 Ioan Chera
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/
+//
+// Additional terms and conditions compatible with the GPLv3 apply. See the
+// file COPYING-EE for details.
+//
+// Purpose: Fast TEXTMAP text output
+// Authors: Ioan Chera
+//
+
+#ifndef TextmapWriter_hpp
+#define TextmapWriter_hpp
+
+#include <stdint.h>
+#include <string.h>
+#include <charconv>
+#include <string>
+#include <vector>
+
+//
+// Builds TEXTMAP text straight into a byte buffer, which can then be moved
+// into a lump. Numbers are formatted with std::to_chars, so there's no locale
+// or stream state overhead. Doubles get the shortest fixed-point text that
+// reads back exactly.
+//
+class TextmapWriter
+{
+public:
+   TextmapWriter &operator << (const char *text)
+   {
+      Append(text, strlen(text));
+      return *this;
+   }
+   TextmapWriter &operator << (const std::string &text)
+   {
+      Append(text.data(), text.size());
+      return *this;
+   }
+   TextmapWriter &operator << (char c)
+   {
+      mBuffer.push_back(static_cast<uint8_t>(c));
+      return *this;
+   }
+   TextmapWriter &operator << (int value)
+   {
+      char text[16];
+      Append(text, std::to_chars(text, text + sizeof(text), value).ptr - text);
+      return *this;
+   }
+   TextmapWriter &operator << (double value);
+
+   void WriteEscaped(const std::string &text);
+
+   std::vector<uint8_t> Release()
+   {
+      return std::move(mBuffer);
+   }
+private:
+   void Append(const char *text, size_t length)
+   {
+      mBuffer.insert(mBuffer.end(), text, text + length);
+   }
+
+   std::vector<uint8_t> mBuffer;
+};
+
+#endif /* TextmapWriter_hpp */
@@ -0,0 +1,189 @@
+//
+// UDMF Converter EE
+// Copyright (C) 2019 Ioan Chera
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/
+//
+// Additional terms and conditions compatible with the GPLv3 apply. See the
+// file COPYING-EE for details.
+//
+// Purpose: Work-stealing thread pool
+// Authors: Ioan Chera
+//
+
+#include "ThreadPool.hpp"
+
+//
+// Starts the workers
+//
+ThreadPool::ThreadPool(int numThreads)
+{
+   if(numThreads < 1)
+      numThreads = 1;
+   for(int i = 0; i < numThreads; ++i)
+      mQueues.push_back(std::unique_ptr<Queue>(new Queue));
+   for(int i = 0; i < numThreads; ++i)
+      mThreads.emplace_back(&ThreadPool::Run, this, static_cast<size_t>(i));
+}
+
+//
+// Finishes all tasks and stops the workers
+//
+ThreadPool::~ThreadPool()
+{
+   Wait();
+   {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mQuit = true;
+   }
+   mWake.notify_all();
+   for(std::thread &thread : mThreads)
+      thread.join();
+}
+
+//
+// Queues a task. Tasks are dealt to the workers in turn.
+//
+void ThreadPool::Submit(std::function<void()> &&task)
+{
+   size_t index;
+   {
+      std::lock_guard<std::mutex> lock(mMutex);
+      index = mNextQueue;
+      mNextQueue = (mNextQueue + 1) % mQueues.size();
+   }
+   {
+      std::lock_guard<std::mutex> lock(mQueues[index]->mutex);
+      mQueues[index]->tasks.push_back(std::move(task));
+   }
+   {
+      std::lock_guard<std::mutex> lock(mMutex);
+      ++mQueued;
+      ++mUnfinished;
+   }
+   mWake.notify_one();
+}
+
+//
+// Blocks until every submitted task has finished
+//
+void ThreadPool::Wait()
+{
+   std::unique_lock<std::mutex> lock(mMutex);
+   mIdle.wait(lock, [this] { return !mUnfinished; });
+}
+
+//
+// Number of threads to use by default
+//
+int ThreadPool::HardwareThreads()
+{
+   unsigned count = std::thread::hardware_concurrency();
+   return count ? static_cast<int>(count) : 1;
+}
+
+//
+// Pops a task from this worker's own queue, or steals one from another's
+//
+bool ThreadPool::TakeTask(size_t index, std::function<void()> &task)
+{
+   {
+      Queue &own = *mQueues[index];
+      std::lock_guard<std::mutex> lock(own.mutex);
+      if(!own.tasks.empty())
+      {
+         task = std::move(own.tasks.front());
+         own.tasks.pop_front();
+         return true;
+      }
+   }
+   for(size_t i = 1; i < mQueues.size(); ++i)
+   {
+      Queue &other = *mQueues[(index + i) % mQueues.size()];
+      std::lock_guard<std::mutex> lock(other.mutex);
+      if(!other.tasks.empty())
+      {
+         task = std::move(other.tasks.front());
+         other.tasks.pop_front();
+         return true;
+      }
+   }
+   return false;
+}
+
+//
+// Worker loop
+//
+void ThreadPool::Run(size_t index)
+{
+   std::function<void()> task;
+   for(;;)
+   {
+      {
+         std::unique_lock<std::mutex> lock(mMutex);
+         mWake.wait(lock, [this] { return mQueued || mQuit; });
+         if(!mQueued && mQuit)
+            return;
+         --mQueued;  // claim one of the queued tasks; it's in some queue
+      }
+      // Each claim matches a task already pushed, so one is there to take
+      while(!TakeTask(index, task))
+         std::this_thread::yield();
+
+      task();
+      task = nullptr;
+
+      std::lock_guard<std::mutex> lock(mMutex);
+      if(!--mUnfinished)
+         mIdle.notify_all();
+   }
+}
+
+//
+// Queues the work on the pool
+//
+std::shared_ptr<PoolTask> PoolTask::Start(ThreadPool &pool, std::function<void()> &&work)
+{
+   std::shared_ptr<PoolTask> task(new PoolTask(std::move(work)));
+   pool.Submit([task]() { task->TryRun(); });
+   return task;
+}
+
+//
+// Runs the work unless someone else already claimed it
+//
+bool PoolTask::TryRun()
+{
+   if(mClaimed.exchange(true))
+      return false;
+   mWork();
+   mWork = nullptr;
+   {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mDone = true;
+   }
+   mDoneSignal.notify_all();
+   return true;
+}
+
+//
+// Gets the work done, running it here if it hasn't started yet
+//
+void PoolTask::Join()
+{
+   if(TryRun())
+      return;
+   std::unique_lock<std::mutex> lock(mMutex);
+   mDoneSignal.wait(lock, [this] { return mDone; });
+}
@@ -0,0 +1,107 @@
+//
+// UDMF Converter EE
+// Copyright (C) 2019 Ioan Chera
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/
+//
+// Additional terms and conditions compatible with the GPLv3 apply. See the
+// file COPYING-EE for details.
+//
+// Purpose: Work-stealing thread pool
+// Authors: Ioan Chera
+//
+
+#ifndef ThreadPool_hpp
+#define ThreadPool_hpp
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//
+// Fixed set of worker threads, each with its own task queue. A worker takes
+// the tasks from its own queue in the order they came and, once that runs
+// dry, steals the oldest one from the others, so uneven tasks still keep every
+// thread busy. Tasks submitted first thus tend to finish first.
+//
+class ThreadPool
+{
+public:
+   explicit ThreadPool(int numThreads);
+   ~ThreadPool();
+   ThreadPool(const ThreadPool &other) = delete;
+   ThreadPool &operator = (const ThreadPool &other) = delete;
+
+   void Submit(std::function<void()> &&task);
+   void Wait();
+
+   int NumThreads() const
+   {
+      return static_cast<int>(mThreads.size());
+   }
+
+   static int HardwareThreads();
+private:
+   struct Queue
+   {
+      std::mutex mutex;
+      std::deque<std::function<void()>> tasks;
+   };
+
+   void Run(size_t index);
+   bool TakeTask(size_t index, std::function<void()> &task);
+
+   std::vector<std::unique_ptr<Queue>> mQueues;
+   std::vector<std::thread> mThreads;
+
+   std::mutex mMutex;               // guards the counters below
+   std::condition_variable mWake;   // signalled when tasks are queued or on quit
+   std::condition_variable mIdle;   // signalled when the last task finishes
+   size_t mQueued = 0;              // tasks waiting in queues
+   size_t mUnfinished = 0;          // tasks queued or running
+   size_t mNextQueue = 0;           // where the next submitted task goes
+   bool mQuit = false;
+};
+
+//
+// Task started on a pool, which a thread can wait for with Join. Whoever gets
+// to it first runs it: a worker, or the joining thread if no worker started it
+// yet. Joins only wait for tasks already running, so pool tasks can split
+// their work into more tasks without deadlocking when all workers are busy.
+//
+class PoolTask
+{
+public:
+   static std::shared_ptr<PoolTask> Start(ThreadPool &pool, std::function<void()> &&work);
+   void Join();
+
+private:
+   explicit PoolTask(std::function<void()> &&work) : mWork(std::move(work))
+   {
+   }
+   bool TryRun();
+
+   std::function<void()> mWork;
+   std::atomic<bool> mClaimed{false};
+   std::mutex mMutex;
+   std::condition_variable mDoneSignal;
+   bool mDone = false;
+};
+
+#endif /* ThreadPool_hpp */
@@ -29,28 +29,32 @@
 #include "LineSpecialMapping.hpp"
 #include "Wad.hpp"
 
-static void Print(std::ostream &os, const char *name, int value, int def = 0)
+static void Print(TextmapWriter &os, const char *name, int value, int def = 0)
 {
    if(value != def)
       os << name << '=' << value << ";\n";
 }
-static void Print(std::ostream &os, const char *name, double value, double def = 0)
+static void Print(TextmapWriter &os, const char *name, double value, double def = 0)
 {
    if(value != def)
       os << name << '=' << value << ";\n";
 }
-static void Print(std::ostream &os, const char *name, const std::string &value, const char *def = "")
+static void Print(TextmapWriter &os, const char *name, const std::string &value, const char *def = "")
 {
    if(value != def)
-      os << name << "=\"" << Escape(value) << "\";\n";
+   {
+      os << name << "=\"";
+      os.WriteEscaped(value);
+      os << "\";\n";
+   }
 }
-static void PrintFlag(std::ostream &os, const char *name, unsigned flags, unsigned flag)
+static void PrintFlag(TextmapWriter &os, const char *name, unsigned flags, unsigned flag)
 {
    if(flags & flag)
       os << name << "=true;\n";
 }
 
-void UDMFVertex::WriteToStream(std::ostream &os, int index) const
+void UDMFVertex::Write(TextmapWriter &os, int index) const
 {
    os << "vertex // " << index << "\n{\n";
    Print(os, "x", x, NAN);
@@ -61,7 +65,7 @@ void UDMFVertex::WriteToStream(std::ostream &os, int index) const
 //
 // Gets a UDMF thing from a basic thing
 //
-UDMFThing::UDMFThing(const Thing &thing, const ExtraData &extraData) :
+UDMFThing::UDMFThing(const Thing &thing, const ExtraData &extraData, MessageLog &log) :
 id(),
 x(thing.x),
 y(thing.y),
@@ -80,8 +84,8 @@ health()
       const EDThing *edThing = extraData.GetThing(thing.flags);
       if(!edThing)
       {
-         fprintf(stderr, "Warning: missing ExtraData mapthing record %u, skipping thing at position %d %d\n",
-                 thing.flags, thing.x, thing.y);
+         log.Warning("Warning: missing ExtraData mapthing record %u, skipping thing at position %d %d\n",
+                     thing.flags, thing.x, thing.y);
          return;
       }
 
@@ -122,7 +126,7 @@ void UDMFThing::SetUDMFFlagsFromDoomFlags(unsigned thflags)
       flags |= UTF_DORMANT;
 }
 
-void UDMFThing::WriteToStream(std::ostream &os, int index) const
+void UDMFThing::Write(TextmapWriter &os, int index) const
 {
    os << "thing // " << index << "\n{\n";
 
@@ -165,7 +169,8 @@ void UDMFThing::WriteToStream(std::ostream &os, int index) const
 //
 // LINEDEF SETUP
 //
-UDMFLine::UDMFLine(const Linedef &linedef, LinedefConversion &conversion) :
+UDMFLine::UDMFLine(const Linedef &linedef, LinedefConversion &conversion,
+                   MessageLog &log) :
 id(linedef.tag),
 v{ linedef.v1, linedef.v2 },
 flags(),
@@ -202,18 +207,19 @@ alpha(1.0)
    if(ldflags & LF_3DMIDTEX)
       flags |= ULF_MIDTEX3D;
    if(linedef.special)
-      HandleDoomSpecial(linedef.special, linedef.tag, conversion);
+      HandleDoomSpecial(linedef.special, linedef.tag, conversion, log);
 }
 
 //
 // Handles a Doom special, applying conversion
 //
-void UDMFLine::HandleDoomSpecial(int lnspecial, int tag, LinedefConversion &conversion)
+void UDMFLine::HandleDoomSpecial(int lnspecial, int tag, LinedefConversion &conversion,
+                                 MessageLog &log)
 {
    const UdmfSpecialTarget *target = GetUDMFSpecial(lnspecial);
    if(!target)
-      fprintf(stderr, "Invalid linedef special %d (see vertices %d and %d)\n", lnspecial,
-              v[0], v[1]);
+      log.Warning("Invalid linedef special %d (see vertices %d and %d)\n", lnspecial,
+                  v[0], v[1]);
    else
    {
       special = target->special;
@@ -253,7 +259,7 @@ void UDMFLine::HandleDoomSpecial(int lnspecial, int tag, LinedefConversion &conv
 //
 // Writes a line to stream
 //
-void UDMFLine::WriteToStream(std::ostream &os, int index) const
+void UDMFLine::Write(TextmapWriter &os, int index) const
 {
    os << "linedef // " << index << "\n{\n";
    Print(os, "id", id);  // NOTE: use default of 0
@@ -307,7 +313,7 @@ void UDMFLine::WriteToStream(std::ostream &os, int index) const
    os << "}\n";
 }
 
-void UDMFSide::WriteToStream(std::ostream &os, int index) const
+void UDMFSide::Write(TextmapWriter &os, int index) const
 {
    os << "sidedef // " << index << "\n{\n";
    Print(os, "offsetx", offsetx);
@@ -334,6 +340,7 @@ id(sector.tag),
 xpanningfloor(),
 ypanningfloor(),
 xpanningceiling(),
+ypanningceiling(),
 xscalefloor(1),
 yscalefloor(1),
 xscaleceiling(1),
@@ -461,7 +468,7 @@ alphaceiling(1)
    }
 }
 
-void UDMFSector::WriteToStream(std::ostream &os, int index) const
+void UDMFSector::Write(TextmapWriter &os, int index) const
 {
    os << "sector // " << index << "\n{\n";
    Print(os, "heightfloor", heightfloor);
@@ -549,21 +556,29 @@ void UDMFSector::WriteToStream(std::ostream &os, int index) const
 //
 // UDMF level maker, resulted from input Doom level and extra Data
 //
-UDMFLevel::UDMFLevel(const DoomLevel &level, const ExtraData &extraData) :
+UDMFLevel::UDMFLevel(const DoomLevel &level, const ExtraData &extraData,
+                     MessageLog &log) :
 mExtraData(extraData),
+mLog(log),
 mDoomLevel(level)
 {
    mThings.reserve(level.GetThings().size());
    for(const Thing &thing : level.GetThings())
-      mThings.emplace_back(thing, extraData);
+      mThings.emplace_back(thing, extraData, log);
 
    mVertices.reserve(level.GetVertices().size());
    for(const Vertex &vertex : level.GetVertices())
       mVertices.emplace_back(vertex);
 
-   mSectors.reserve(level.GetVertices().size());
+   mSectors.reserve(level.GetSectors().size());
    for(const Sector &sector : level.GetSectors())
+   {
+      mSectorsByTag[sector.tag].push_back(static_cast<int>(mSectors.size()));
       mSectors.emplace_back(sector);
+   }
+
+   for(const Linedef &linedef : level.GetLinedefs())
+      mLinedefsByTag[linedef.tag].push_back(level.IndexOf(linedef));
 
    mSides.reserve(level.GetSidedefs().size());
    for(const Sidedef &sidedef : level.GetSidedefs())
@@ -571,7 +586,7 @@ mDoomLevel(level)
 
    mLines.reserve(level.GetLinedefs().size());
    for(const Linedef &linedef : level.GetLinedefs())
-      mLines.emplace_back(linedef, *this);
+      mLines.emplace_back(linedef, *this, log);
 
    for (const DeferredLineSetup &setup : mDeferredLines)
    {
@@ -580,9 +595,9 @@ mDoomLevel(level)
       memcpy(mLines[setup.index].arg, setup.arg, sizeof(setup.arg));
       mLines[setup.index].portal = setup.portal;
 
-      printf("Set line %d tag %d special %d args %d %d %d %d %d portal %d\n",
-             setup.index, setup.tag, setup.special, setup.arg[0], setup.arg[1], setup.arg[2],
-             setup.arg[3], setup.arg[4], setup.portal);
+      mLog.Progress("Set line %d tag %d special %d args %d %d %d %d %d portal %d\n",
+                    setup.index, setup.tag, setup.special, setup.arg[0], setup.arg[1], setup.arg[2],
+                    setup.arg[3], setup.arg[4], setup.portal);
    }
 }
 
@@ -618,11 +633,11 @@ void UDMFLevel::SetSurfaceControl(int special, int tag, UDMFLine &line)
    {
       case EV_STATIC_ATTACH_SET_CEILING_CONTROL:
          sector->ceilingid = tag;
-         printf("Sector %d gets ceilingid %d\n", secnum, tag);
+         mLog.Progress("Sector %d gets ceilingid %d\n", secnum, tag);
          break;
       case EV_STATIC_ATTACH_SET_FLOOR_CONTROL:
          sector->floorid = tag;
-         printf("Sector %d gets floorid %d\n", secnum, tag);
+         mLog.Progress("Sector %d gets floorid %d\n", secnum, tag);
          break;
       default:
          break;
@@ -640,19 +655,19 @@ void UDMFLevel::AttachToControl(int special, int tag, UDMFLine &line)
    {
       case EV_STATIC_ATTACH_CEILING_TO_CONTROL:
          sector->attachceiling = tag;
-         printf("Sector %d gets attachceiling %d\n", secnum, tag);
+         mLog.Progress("Sector %d gets attachceiling %d\n", secnum, tag);
          break;
       case EV_STATIC_ATTACH_FLOOR_TO_CONTROL:
          sector->attachfloor = tag;
-         printf("Sector %d gets attachfloor %d\n", secnum, tag);
+         mLog.Progress("Sector %d gets attachfloor %d\n", secnum, tag);
          break;
       case EV_STATIC_ATTACH_MIRROR_CEILING:
          sector->attachceiling = -tag;
-         printf("Sector %d gets attachceiling %d\n", secnum, -tag);
+         mLog.Progress("Sector %d gets attachceiling %d\n", secnum, -tag);
          break;
       case EV_STATIC_ATTACH_MIRROR_FLOOR:
          sector->attachfloor = -tag;
-         printf("Sector %d gets attachfloor %d\n", secnum, -tag);
+         mLog.Progress("Sector %d gets attachfloor %d\n", secnum, -tag);
          break;
       default:
          break;
@@ -663,8 +678,8 @@ void UDMFLevel::ResolveLineExtraData(int special, int tag, UDMFLine &line)
    const EDLine *edLine = mExtraData.GetLine(tag);
    if(!edLine)
    {
-      fprintf(stderr, "Unknown linedef recordnum %d (from vertices %d-%d)\n", tag, line.v[0],
-              line.v[1]);
+      mLog.Warning("Unknown linedef recordnum %d (from vertices %d-%d)\n", tag, line.v[0],
+                   line.v[1]);
       return;
    }
    line.id = edLine->tag;
@@ -674,11 +689,11 @@ void UDMFLevel::ResolveLineExtraData(int special, int tag, UDMFLine &line)
       int ldspecial = edLine->special & ~FLAG_DOOM_SPECIAL;
       if(ldspecial == special)
       {
-         fprintf(stderr, "Illegal recursive ExtraData line special at recordnum %d (vertices %d-%d)\n",
-                 tag, line.v[0], line.v[1]);
+         mLog.Warning("Illegal recursive ExtraData line special at recordnum %d (vertices %d-%d)\n",
+                      tag, line.v[0], line.v[1]);
       }
       else
-         line.HandleDoomSpecial(ldspecial, edLine->tag, *this);
+         line.HandleDoomSpecial(ldspecial, edLine->tag, *this, mLog);
    }
    else if(edLine->special == Line_SetIdentification)
       line.id = edLine->args[0];
@@ -742,8 +757,8 @@ void UDMFLevel::ResolveSectorExtraData(int special, int tag, UDMFLine &line)
    const EDSector *edSector = mExtraData.GetSector(tag);
    if(!edSector)
    {
-      fprintf(stderr, "Missing ExtraData sector %d (from map sector %d)\n", tag,
-              (int)(sector - &mSectors[0]));
+      mLog.Warning("Missing ExtraData sector %d (from map sector %d)\n", tag,
+                   (int)(sector - &mSectors[0]));
       return;
    }
 
@@ -997,7 +1012,7 @@ void UDMFLevel::PortalDefine(int special, int tag, UDMFLine &line)
    const PortalInfo info(special);
    int curindex = IndexOf(line);
 
-   printf("Found portal line %d\n", curindex);
+   mLog.Progress("Found portal line %d\n", curindex);
 
    int portalid = 0;
    if (info.IsAnchored())
@@ -1007,17 +1022,17 @@ void UDMFLevel::PortalDefine(int special, int tag, UDMFLine &line)
       const UDMFVertex *myv[2] = { GetVertex(line.v[0]), GetVertex(line.v[1]) };
       if(!myv[0] || !myv[1])
       {
-         fprintf(stderr, "Line %d is invalid\n", curindex);
+         mLog.Warning("Line %d is invalid\n", curindex);
          return;
       }
 
       double myx = (myv[0]->x + myv[1]->x) / 2;
       double myy = (myv[0]->y + myv[1]->y) / 2;
 
-      for (const Linedef &otherline : mDoomLevel.GetLinedefs())
+      for (int otherindex : FindTagged(mLinedefsByTag, tag))
       {
-         int otherindex = mDoomLevel.IndexOf(otherline);
-         if(curindex == otherindex || otherline.tag != tag || otherline.special != info.anchorspec)
+         const Linedef &otherline = mDoomLevel.GetLinedefs()[otherindex];
+         if(curindex == otherindex || otherline.special != info.anchorspec)
             continue;
 
          const Vertex *ov[2] = {
@@ -1031,33 +1046,29 @@ void UDMFLevel::PortalDefine(int special, int tag, UDMFLine &line)
          double dx = myx - (ov[0]->x + ov[1]->x) / 2.0;
          double dy = myy - (ov[0]->y + ov[1]->y) / 2.0;
 
-         printf("Anchor offset is %g %g\n", dx, dy);
+         mLog.Progress("Anchor offset is %g %g\n", dx, dy);
 
          AnchoredPortal portal = {};
          portal.kind = info.kind;
          portal.dx = dx;
          portal.dy = dy;
 
-         for(const AnchoredPortal &oportal : mPortals)
+         auto found = mPortals.find(portal);
+         if(found != mPortals.end())
+         {
+            portalid = found->id;
+            mLog.Progress("Line %d reuses portal %d\n", curindex, portalid);
+         }
+         else if((found = mPortals.find(portal.Opposite())) != mPortals.end())
          {
-            if(oportal == portal)
-            {
-               portalid = oportal.id;
-               printf("Line %d reuses portal %d\n", curindex, portalid);
-            }
-            else if(oportal.IsOpposite(portal))
-            {
-               portalid = -oportal.id;
-               printf("Line %d mirrors portal %d\n", curindex, -portalid);
-            }
-            if(portalid)
-               break;
+            portalid = -found->id;
+            mLog.Progress("Line %d mirrors portal %d\n", curindex, -portalid);
          }
          // portalid none, so add this
          if(!portalid)
          {
             portalid = portal.id = MakeNextPortalID();
-            mPortals.push_back(portal);
+            mPortals.insert(portal);
 
             DeferredLineSetup setup = {};
             setup.index = otherindex;
@@ -1068,7 +1079,7 @@ void UDMFLevel::PortalDefine(int special, int tag, UDMFLine &line)
             mDeferredLines.push_back(setup);
 
             line.id = tag;
-            printf("Line %d makes new portal %d\n", curindex, portalid);
+            mLog.Progress("Line %d makes new portal %d\n", curindex, portalid);
          }
 
          break;
@@ -1083,27 +1094,24 @@ void UDMFLevel::PortalDefine(int special, int tag, UDMFLine &line)
 
    if(!portalid)
       return;
-   for(UDMFSector &sector : mSectors)
+   for(int secnum : FindTagged(mSectorsByTag, tag))
    {
-      if(sector.id == tag)
-      {
-         if(info.ceiling)
-            sector.portalceiling = portalid;
-         if(info.floor)
-            sector.portalfloor = portalid;
-         printf("Sector %d gets floor(%d) or ceiling(%d) portal %d\n", IndexOf(sector), info.floor,
-                info.ceiling, portalid);
-      }
+      UDMFSector &sector = mSectors[secnum];
+      if(info.ceiling)
+         sector.portalceiling = portalid;
+      if(info.floor)
+         sector.portalfloor = portalid;
+      mLog.Progress("Sector %d gets floor(%d) or ceiling(%d) portal %d\n", secnum, info.floor,
+                    info.ceiling, portalid);
    }
 
-   for (const Linedef &cline : mDoomLevel.GetLinedefs())
+   for (int clinenum : FindTagged(mLinedefsByTag, tag))
    {
-      if(cline.tag != tag)
-         continue;
+      const Linedef &cline = mDoomLevel.GetLinedefs()[clinenum];
       if(cline.special == EV_STATIC_PORTAL_LINE)
       {
          DeferredLineSetup setup = {};
-         setup.index = mDoomLevel.IndexOf(cline);
+         setup.index = clinenum;
          setup.portal = portalid;
          mDeferredLines.push_back(setup);
       }
@@ -1117,8 +1125,8 @@ void UDMFLevel::PortalDefine(int special, int tag, UDMFLine &line)
                sector.portalceiling = portalid;
             if(info.floor)
                sector.portalfloor = portalid;
-            printf("Sector %d copies floor(%d) or ceiling(%d) portal %d\n", IndexOf(sector),
-                   info.floor, info.ceiling, portalid);
+            mLog.Progress("Sector %d copies floor(%d) or ceiling(%d) portal %d\n", IndexOf(sector),
+                          info.floor, info.ceiling, portalid);
          }
       }
    }
@@ -1144,16 +1152,27 @@ void UDMFLevel::TranslucentLine(int special, int tag, UDMFLine &line)
    {
       // check lump
       const Lump *lump = mDoomLevel.GetWad()->FindLump(midtex);
-      if(lump && lump->Data().size() == 65536)
+      if(lump && lump->Size() == 65536)
       {
          line.tranmap = midtex;
-         printf("Line %d gets tranmap '%s'\n", IndexOf(line), midtex);
+         mLog.Progress("Line %d gets tranmap '%s'\n", IndexOf(line), midtex);
       }
       else
-         fprintf(stderr, "Line %d FAILS tranmap '%s'\n", IndexOf(line), midtex);
+         mLog.Warning("Line %d FAILS tranmap '%s'\n", IndexOf(line), midtex);
    }
 }
 
+//
+// Gets the indices of the items with a tag, from one of the tag indices
+//
+const std::vector<int> &UDMFLevel::FindTagged(const std::unordered_map<int, std::vector<int>> &index,
+                                              int tag)
+{
+   static const std::vector<int> none;
+   auto it = index.find(tag);
+   return it != index.end() ? it->second : none;
+}
+
 //
 // Gets a linedef's front sector, if available
 //
@@ -1180,23 +1199,23 @@ const UDMFVertex *UDMFLevel::GetVertex(int index) const
 //
 // Write to stream
 //
-std::ostream &operator << (std::ostream &os, const UDMFLevel &level)
+TextmapWriter &operator << (TextmapWriter &os, const UDMFLevel &level)
 {
    os << "namespace=\"eternity\";\n";
    int i = 0;
    for (const UDMFThing &thing : level.mThings)
-      thing.WriteToStream(os, i++);
+      thing.Write(os, i++);
    i = 0;
    for (const UDMFVertex &vertex : level.mVertices)
-      vertex.WriteToStream(os, i++);
+      vertex.Write(os, i++);
    i = 0;
    for (const UDMFLine &line : level.mLines)
-      line.WriteToStream(os, i++);
+      line.Write(os, i++);
    i = 0;
    for (const UDMFSide &side : level.mSides)
-      side.WriteToStream(os, i++);
+      side.Write(os, i++);
    i = 0;
    for (const UDMFSector &sector : level.mSectors)
-      sector.WriteToStream(os, i++);
+      sector.Write(os, i++);
    return os;
 }
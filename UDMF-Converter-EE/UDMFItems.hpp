@@ -25,15 +25,18 @@
 #ifndef UDMFItems_hpp
 #define UDMFItems_hpp
 
-#include <ostream>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include "MapItems.h"
+#include "TextmapWriter.hpp"
 
 class DoomLevel;
 class ExtraData;
 class LinedefConversion;
 class Wad;
+struct MessageLog;
 
 enum UDMFThingFlags
 {
@@ -132,7 +135,7 @@ struct UDMFVertex
    {
    }
 
-   void WriteToStream(std::ostream &os, int index) const;
+   void Write(TextmapWriter &os, int index) const;
 };
 
 //
@@ -152,9 +155,9 @@ struct UDMFThing
    // EE extra
    double health;
 
-   UDMFThing(const Thing &thing, const ExtraData &extraData);
+   UDMFThing(const Thing &thing, const ExtraData &extraData, MessageLog &log);
 
-   void WriteToStream(std::ostream &os, int index) const;
+   void Write(TextmapWriter &os, int index) const;
 
 private:
    void SetUDMFFlagsFromDoomFlags(unsigned thflags);
@@ -165,11 +168,12 @@ private:
 //
 struct UDMFLine
 {
-   UDMFLine(const Linedef &linedef, LinedefConversion &conversion);
+   UDMFLine(const Linedef &linedef, LinedefConversion &conversion, MessageLog &log);
 
-   void HandleDoomSpecial(int special, int tag, LinedefConversion &conversion);
+   void HandleDoomSpecial(int special, int tag, LinedefConversion &conversion,
+                          MessageLog &log);
 
-   void WriteToStream(std::ostream &os, int index) const;
+   void Write(TextmapWriter &os, int index) const;
 
    int id;
    int v[2];
@@ -208,7 +212,7 @@ struct UDMFSide
    {
    }
 
-   void WriteToStream(std::ostream &os, int index) const;
+   void Write(TextmapWriter &os, int index) const;
 };
 
 //
@@ -218,7 +222,7 @@ struct UDMFSector
 {
    UDMFSector(const Sector &sector);
 
-   void WriteToStream(std::ostream &os, int index) const;
+   void Write(TextmapWriter &os, int index) const;
 
    double heightfloor;
    double heightceiling;
@@ -304,7 +308,7 @@ enum class PortalKind : int
 class UDMFLevel : public LinedefConversion
 {
 public:
-   UDMFLevel(const DoomLevel &level, const ExtraData &extraData);
+   UDMFLevel(const DoomLevel &level, const ExtraData &extraData, MessageLog &log);
 
    virtual void SetLightTag(int special, int tag, UDMFLine &line) override;
    virtual void SetSurfaceControl(int special, int tag, UDMFLine &line) override;
@@ -316,7 +320,12 @@ public:
    virtual void QuickLinePortal(int special, int tag, UDMFLine &line) override;
    virtual void TranslucentLine(int special, int tag, UDMFLine &line) override;
 
-   friend std::ostream &operator << (std::ostream &os, const UDMFLevel &level);
+   bool HasPortals() const
+   {
+      return mNextPortalID > 1;
+   }
+
+   friend TextmapWriter &operator << (TextmapWriter &os, const UDMFLevel &level);
 
 private:
 
@@ -331,9 +340,22 @@ private:
       {
          return kind == other.kind && dx == other.dx && dy == other.dy;
       }
-      bool IsOpposite(const AnchoredPortal &other) const
+      AnchoredPortal Opposite() const
+      {
+         AnchoredPortal opposite = *this;
+         opposite.dx = -dx;
+         opposite.dy = -dy;
+         return opposite;
+      }
+   };
+
+   struct AnchoredPortalHash
+   {
+      size_t operator () (const AnchoredPortal &portal) const
       {
-         return kind == other.kind && dx == -other.dx && dy == -other.dy;
+         // add 0.0 so -0.0 hashes the same as 0.0, which it equals
+         std::hash<double> hash;
+         return hash(portal.dx + 0.0) * 31 + hash(portal.dy + 0.0) * 7 + int(portal.kind);
       }
    };
 
@@ -355,6 +377,9 @@ private:
       return int(&sector - &mSectors[0]);
    }
 
+   static const std::vector<int> &FindTagged(const std::unordered_map<int, std::vector<int>> &index,
+                                             int tag);
+
    UDMFSector *GetFrontSector(const UDMFLine &line);
    const UDMFVertex *GetVertex(int index) const;
    int MakeNextPortalID()
@@ -363,6 +388,7 @@ private:
    }
 
    const ExtraData &mExtraData;
+   MessageLog &mLog;   // messages about the conversion go here, not to the console
 
    std::vector<UDMFThing> mThings;
    std::vector<UDMFVertex> mVertices;
@@ -373,10 +399,14 @@ private:
    const DoomLevel &mDoomLevel;
    int mNextPortalID = 1;
 
-   std::vector<AnchoredPortal> mPortals;
+   std::unordered_set<AnchoredPortal, AnchoredPortalHash> mPortals;
+
+   // items by tag, so tagged specials don't need to scan the whole level
+   std::unordered_map<int, std::vector<int>> mSectorsByTag;
+   std::unordered_map<int, std::vector<int>> mLinedefsByTag;
    std::vector<DeferredLineSetup> mDeferredLines;
 };
 
-std::ostream &operator << (std::ostream &os, const UDMFLevel &level);
+TextmapWriter &operator << (TextmapWriter &os, const UDMFLevel &level);
 
 #endif /* UDMFItems_hpp */
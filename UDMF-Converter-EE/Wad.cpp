@@ -22,21 +22,93 @@
 // Authors: Ioan Chera
 //
 
+#include <ctype.h>
+#include <algorithm>
 #include <fstream>
 #include "IOHelpers.hpp"
 #include "Wad.hpp"
+#include "WadWriter.hpp"
 
 //
-// Tries to read a file
+// Checks the wad header tag
+//
+static bool ReadWadType(const char headtag[4], WadType &type)
+{
+   if(!memcmp(headtag, "PWAD", 4))
+      type = WadType::Pwad;
+   else if(!memcmp(headtag, "IWAD", 4))
+      type = WadType::Iwad;
+   else
+      return false;
+   return true;
+}
+
+//
+// Tries to read a file. Maps it into memory if possible, so the lumps can point
+// straight into it. Otherwise reads it through a stream.
 //
 Result Wad::AddFile(const char *path)
+{
+   auto file = std::make_shared<MappedFile>();
+   if(file->Open(path) == Result::OK)
+      return AddMappedFile(path, file);
+   return AddStreamedFile(path);
+}
+
+//
+// Loads the directory of a mapped file. No lump content is copied.
+//
+Result Wad::AddMappedFile(const char *path, const std::shared_ptr<MappedFile> &file)
+{
+   const uint8_t *data = file->Data();
+   size_t size = file->Size();
+   WadType type;
+   if(size < 12 || !ReadWadType(reinterpret_cast<const char *>(data), type))
+      return Result::BadFile;
+
+   int numlumps = ReadInt(data + 4);
+   int infotableofs = ReadInt(data + 8);
+   if(numlumps < 0 || infotableofs < 0 || static_cast<size_t>(infotableofs) > size ||
+      static_cast<size_t>(numlumps) > (size - infotableofs) / 16)
+   {
+      return Result::BadFile;
+   }
+
+   // Unlike when streaming, numlumps is now known to fit in the file
+   std::vector<Lump> lumps;
+   lumps.reserve(numlumps);
+   const uint8_t *entry = data + infotableofs;
+   for(int i = 0; i < numlumps; ++i, entry += 16)
+   {
+      int filepos = ReadInt(entry);
+      int lumpsize = ReadInt(entry + 4);
+      if(filepos < 0 || lumpsize < 0 || static_cast<size_t>(filepos) > size ||
+         static_cast<size_t>(lumpsize) > size - filepos)
+      {
+         return Result::BadFile;
+      }
+
+      char name[LumpNameLength + 1] = {};
+      memcpy(name, entry + 8, LumpNameLength);
+      lumps.emplace_back(name, data + filepos, lumpsize, filepos);
+   }
+
+   AppendLumps(path, lumps);
+   mMappedFiles.push_back(file);
+   return Result::OK;
+}
+
+//
+// Reads the directory of a file through a stream. Lump content is only read
+// when first needed, so data the converter never looks at costs nothing.
+//
+Result Wad::AddStreamedFile(const char *path)
 {
    std::ifstream is(path, std::ios::in | std::ios::binary);
    if(!is.is_open())
       return Result::CannotOpen;
 
-   Result result = Result::OK;
-   char headtag[5] = {};
+   char headtag[4];
    WadType type;
    int numlumps;
    int infotableofs;
@@ -48,19 +120,13 @@ Result Wad::AddFile(const char *path)
    std::vector<LumpDirEntry> directory;
    std::vector<Lump> lumps;
 
-   RangePath rangePath;
-   if(!is.read(headtag, 4))
+   if(!is.read(headtag, 4) || !ReadWadType(headtag, type))
       return Result::BadFile;
 
-   headtag[4] = 0;
-   if(!strcmp(headtag, "PWAD"))
-      type = WadType::Pwad;
-   else if(!strcmp(headtag, "IWAD"))
-      type = WadType::Iwad;
-   else
+   if(!ReadInt(is, numlumps) || !ReadInt(is, infotableofs) || !is.seekg(0, std::ios::end))
       return Result::BadFile;
-
-   if(!ReadInt(is, numlumps) || !ReadInt(is, infotableofs) || !is.seekg(infotableofs))
+   std::streamoff filesize = is.tellg();
+   if(filesize < 0 || !is.seekg(infotableofs))
       return Result::BadFile;
 
    // Don't reserve numlumps: it may be purposefully set huge to lock-up the app
@@ -73,71 +139,135 @@ Result Wad::AddFile(const char *path)
       if(!ReadInt(is, lde.filepos) || !ReadInt(is, lde.size) || !is.read(lde.name, LumpNameLength))
          return Result::BadFile;
 
+      // Content isn't read now, so check it's really there
+      if(lde.filepos < 0 || lde.size < 0 || lde.filepos > filesize ||
+         lde.size > filesize - lde.filepos)
+      {
+         return Result::BadFile;
+      }
+
       lde.name[LumpNameLength] = 0;
       directory.push_back(lde);
    }
+
+   auto source = std::make_shared<LumpSource>(path);
+   if(!source->IsOpen())
+      return Result::CannotOpen;
    lumps.reserve(directory.size());
    for(const LumpDirEntry &lde : directory)
-   {
-      Lump lump(lde.name);
-      if(!is.seekg(lde.filepos))
-         return Result::BadFile;
+      lumps.emplace_back(lde.name, source, lde.filepos, lde.size);
 
-      result = lump.Load(is, lde.size);
-      if(result != Result::OK)
-         return result;
-      lumps.push_back(std::move(lump));
-   }
+   AppendLumps(path, lumps);
+   return Result::OK;
+}
 
-   rangePath = {
+//
+// Adds the lumps of a newly loaded file
+//
+void Wad::AppendLumps(const char *path, std::vector<Lump> &lumps)
+{
+   RangePath rangePath = {
       .range = { static_cast<int>(mLumps.size()), static_cast<int>(lumps.size()) },
       .path = path
    };
 
-   mLumps.insert(mLumps.end(), lumps.begin(), lumps.end());
+   mLumps.reserve(mLumps.size() + lumps.size());
+   for(Lump &lump : lumps)
+      AddLump(std::move(lump));
    mRangePaths.push_back(rangePath);
-
-   return result;
 }
 
+//
+// Writes all lumps to a new PWAD
+//
 Result Wad::WriteFile(const char *path) const
 {
-   std::ofstream os(path, std::ios::out | std::ios::binary | std::ios::trunc);
-   if(!os.is_open())
-      return Result::CannotOpen;
-
-   os.write("PWAD", 4);
-   WriteInt(mLumps.size(), os);
-   WriteInt(12, os);
-   off_t filepos = 12 + mLumps.size() * 16;
+   WadWriter writer;
+   Result result = writer.Open(path);
+   if(result != Result::OK)
+      return result;
    for(const Lump &lump : mLumps)
    {
-      WriteInt(filepos, os);
-      WriteInt(lump.Data().size(), os);
-      filepos += lump.Data().size();
-      os.write(lump.Name(), 8);
+      result = writer.AddLump(lump);
+      if(result != Result::OK)
+         return result;
    }
+   return writer.Close();
+}
 
-   for(const Lump &lump : mLumps)
-      WriteData(lump.Data(), os);
-
-   return Result::OK;
+//
+// Reads ahead the content of a range of lumps, in file order. Returns false if
+// any of them couldn't be read.
+//
+bool Wad::Prefetch(size_t first, size_t count) const
+{
+   std::vector<const Lump *> lumps;
+   for(size_t i = first; i < first + count && i < mLumps.size(); ++i)
+      lumps.push_back(&mLumps[i]);
+   std::sort(lumps.begin(), lumps.end(), [](const Lump *lump1, const Lump *lump2) {
+      return lump1->Offset() < lump2->Offset();
+   });
+   bool result = true;
+   for(const Lump *lump : lumps)
+      result = lump->Fetch() && result;
+   return result;
 }
 
 //
-// Finds a lump from the wad, searching backwards.
+// Packs a lump name into a case-insensitive key. Returns false if the name
+// can't belong to a lump.
 //
-const Lump *Wad::FindLump(const char *name, int *index) const
+static bool LumpNameKey(const char *name, uint64_t &key)
 {
-   int lumpIndex = static_cast<int>(mLumps.size() - 1);
-   for(auto it = mLumps.rbegin(); it != mLumps.rend(); ++it, --lumpIndex)
+   key = 0;
+   for(int i = 0; i < LumpNameLength && name[i]; ++i)
    {
-      if(!strcasecmp(it->Name(), name))
-      {
-         if(index)
-            *index = lumpIndex;
-         return &*it;
-      }
+      key |= static_cast<uint64_t>(static_cast<uint8_t>(toupper(static_cast<uint8_t>(name[i]))))
+            << (i * 8);
    }
-   return nullptr;
+   return strnlen(name, LumpNameLength + 1) <= LumpNameLength;
+}
+
+//
+// Finds a lump from the wad, the last one if there are more with this name.
+//
+const Lump *Wad::FindLump(const char *name, int *index) const
+{
+   const std::vector<int> *indices = FindLumps(name);
+   if(!indices)
+      return nullptr;
+   if(index)
+      *index = indices->back();
+   return &mLumps[indices->back()];
+}
+
+//
+// Gets the indices of all lumps with this name, in wad order. Null if none.
+//
+const std::vector<int> *Wad::FindLumps(const char *name) const
+{
+   uint64_t key;
+   if(!LumpNameKey(name, key))
+      return nullptr;
+   auto it = mNameIndex.find(key);
+   return it != mNameIndex.end() ? &it->second : nullptr;
+}
+
+//
+// Adds a new lump and indexes its name
+//
+void Wad::AddLump(Lump &&lump)
+{
+   IndexLump(lump, static_cast<int>(mLumps.size()));
+   mLumps.push_back(std::move(lump));
+}
+
+//
+// Updates the name index with a lump, which must be the last one so far
+//
+void Wad::IndexLump(const Lump &lump, int index)
+{
+   uint64_t key;
+   LumpNameKey(lump.Name(), key);
+   mNameIndex[key].push_back(index);
 }
@@ -25,8 +25,11 @@
 #ifndef Wad_hpp
 #define Wad_hpp
 
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include "Lump.hpp"
+#include "MappedFile.hpp"
 #include "Range.h"
 #include "Result.hpp"
 
@@ -67,17 +70,27 @@ public:
    }
 
    const Lump *FindLump(const char *name, int *index = nullptr) const;
+   const std::vector<int> *FindLumps(const char *name) const;
+   bool Prefetch(size_t first, size_t count) const;
 
-   void AddLump(Lump &&lump)
-   {
-      mLumps.push_back(std::move(lump));
-   }
+   void AddLump(Lump &&lump);
    
 private:
+   Result AddMappedFile(const char *path, const std::shared_ptr<MappedFile> &file);
+   Result AddStreamedFile(const char *path);
+   void AppendLumps(const char *path, std::vector<Lump> &lumps);
+   void IndexLump(const Lump &lump, int index);
+
    std::vector<Lump> mLumps;
 
+   // lump indices by case-insensitive name packed into 8 bytes
+   std::unordered_map<uint64_t, std::vector<int>> mNameIndex;
+
    // used to keep track to which disk files the lumps belong for a loaded wad
    std::vector<RangePath> mRangePaths;
+
+   // mapped input files, which the lumps may be viewing
+   std::vector<std::shared_ptr<MappedFile>> mMappedFiles;
 };
 
 #endif /* Wad_hpp */
@@ -0,0 +1,95 @@
+//
+// UDMF Converter EE
+// Copyright (C) 2019 Ioan Chera
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/
+//
+// Additional terms and conditions compatible with the GPLv3 apply. See the
+// file COPYING-EE for details.
+//
+// Purpose: Wad file writer that streams lumps to disk
+// Authors: Ioan Chera
+//
+
+#include "IOHelpers.hpp"
+#include "WadWriter.hpp"
+
+enum
+{
+   HeaderSize = 12,
+};
+
+//
+// Creates the file and reserves room for the header
+//
+Result WadWriter::Open(const char *path)
+{
+   Close();
+   mStream.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+   if(!mStream.is_open())
+      return Result::CannotOpen;
+
+   mDirectory.clear();
+   mStream.write("PWAD", 4);
+   WriteInt(0, mStream);   // lump count and directory offset get patched on close
+   WriteInt(0, mStream);
+   mFilePos = HeaderSize;
+   return mStream ? Result::OK : Result::CannotWrite;
+}
+
+//
+// Appends a lump to the file. Fails if it or anything before couldn't be
+// written, so callers can stop early instead of finding out at Close.
+//
+Result WadWriter::AddLump(const Lump &lump)
+{
+   return AddLump(lump.Name(), lump.Data(), lump.Size());
+}
+
+Result WadWriter::AddLump(const char *name, const uint8_t *data, size_t size)
+{
+   DirEntry entry = {};
+   entry.filepos = mFilePos;
+   entry.size = static_cast<int>(size);
+   memcpy(entry.name, name, strnlen(name, LumpNameLength));
+   mDirectory.push_back(entry);
+
+   mStream.write(reinterpret_cast<const char *>(data), size);
+   mFilePos += static_cast<int>(size);
+   return mStream ? Result::OK : Result::CannotWrite;
+}
+
+//
+// Writes the directory and finishes the header. Does nothing if not open.
+//
+Result WadWriter::Close()
+{
+   if(!mStream.is_open())
+      return Result::OK;
+
+   for(const DirEntry &entry : mDirectory)
+   {
+      WriteInt(entry.filepos, mStream);
+      WriteInt(entry.size, mStream);
+      mStream.write(entry.name, LumpNameLength);
+   }
+   mStream.seekp(4);
+   WriteInt(mDirectory.size(), mStream);
+   WriteInt(mFilePos, mStream);
+
+   bool ok = !!mStream;
+   mStream.close();
+   mDirectory.clear();
+   return ok && !mStream.fail() ? Result::OK : Result::CannotWrite;
+}
@@ -0,0 +1,67 @@
+//
+// UDMF Converter EE
+// Copyright (C) 2019 Ioan Chera
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/
+//
+// Additional terms and conditions compatible with the GPLv3 apply. See the
+// file COPYING-EE for details.
+//
+// Purpose: Wad file writer that streams lumps to disk
+// Authors: Ioan Chera
+//
+
+#ifndef WadWriter_hpp
+#define WadWriter_hpp
+
+#include <fstream>
+#include <vector>
+#include "Lump.hpp"
+#include "Result.hpp"
+
+//
+// Writes a PWAD one lump at a time. Lump content goes to disk as soon as it's
+// added; only the directory is kept until Close, which writes it at the end of
+// the file and patches the header to point to it.
+//
+class WadWriter
+{
+public:
+   WadWriter()
+   {
+   }
+   ~WadWriter()
+   {
+      Close();
+   }
+   WadWriter(const WadWriter &other) = delete;
+   WadWriter &operator = (const WadWriter &other) = delete;
+
+   Result Open(const char *path);
+   Result AddLump(const Lump &lump);
+   Result AddLump(const char *name, const uint8_t *data, size_t size);
+   Result Close();
+private:
+   struct DirEntry
+   {
+      int filepos, size;
+      char name[LumpNameLength];
+   };
+
+   std::ofstream mStream;
+   std::vector<DirEntry> mDirectory;
+   int mFilePos = 0;    // where the next lump goes
+};
+
+#endif /* WadWriter_hpp */
@@ -46,7 +46,7 @@ bool XLEMapInfoParser::DoStateExpectHeader(XLTokenizer &tokenizer)
    if(!mLocalLevel.empty())
    {
       // if not in global mode, the only recognized header is "level info"
-      if(!strcasecmp(tokenizer.Token(), "level info"))
+      if(EqualNoCase(tokenizer.Token(), "level info"))
       {
          // in level header mode, all [level info] blocks accumulate into a
          // single definition
@@ -68,7 +68,9 @@ bool XLEMapInfoParser::DoStateExpectHeader(XLTokenizer &tokenizer)
       // MetaTable object, and the newest definition for a given map is the
       // one which entirely wins (any data from a previous section with the
       // same name will be obliterated by a later definition).
-      (mCurInfo = &mAllInfo[UpperCase(tokenizer.Token())])->clear();   // also clear
+      std::string levelName(tokenizer.Token());
+      MakeUpperCase(levelName);
+      (mCurInfo = &mAllInfo[levelName])->clear();   // also clear
       mNextState = STATE_EXPECTKEYWORD;
       mState = STATE_EXPECTEOL;
    }
@@ -111,7 +113,7 @@ bool XLEMapInfoParser::DoStateExpectKeyword(XLTokenizer &tokenizer)
 // Expecting optional = sign, or the start of the value
 bool XLEMapInfoParser::DoStateExpectEqual(XLTokenizer &tokenizer)
 {
-   if(!strcmp(tokenizer.Token(), "="))
+   if(tokenizer.Token() == "=")
    {
       // found an optional =, expect value.
       mState = STATE_EXPECTVALUE;
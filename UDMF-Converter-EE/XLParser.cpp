@@ -22,272 +22,299 @@
 // Authors: James Haley (from Eternity), Ioan Chera
 //
 
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
 #include "Lump.hpp"
 #include "Wad.hpp"
 #include "XLParser.hpp"
 
+//
+// Character classes, looked up per byte by the tokenizer
+//
+enum
+{
+   XLC_SPACE      = 0x01,  // blanks between tokens
+   XLC_NEWLINE    = 0x02,  // line break
+   XLC_SEMICOLON  = 0x04,  // always starts a comment
+   XLC_HASH       = 0x08,  // starts a comment with TF_HASHCOMMENTS
+   XLC_SLASH      = 0x10,  // starts a comment with TF_SLASHCOMMENTS, if doubled
+   XLC_QUOTE      = 0x20,  // starts a quoted string
+   XLC_BRACKET    = 0x40,  // starts a bracketed string with TF_BRACKETS
+   XLC_IDENTIFIER = 0x80,  // alphanumeric or _
+};
+
+//
+// The 256-entry class table, built at compile time
+//
+struct XLCharTable
+{
+   uint8_t classes[256] = {};
+
+   constexpr XLCharTable()
+   {
+      classes[' '] = classes['\t'] = classes['\r'] = XLC_SPACE;
+      classes['\n'] = XLC_NEWLINE;
+      classes[';'] = XLC_SEMICOLON;
+      classes['#'] = XLC_HASH;
+      classes['/'] = XLC_SLASH;
+      classes['"'] = XLC_QUOTE;
+      classes['['] = XLC_BRACKET;
+      classes['_'] = XLC_IDENTIFIER;
+      for(int c = '0'; c <= '9'; ++c)
+         classes[c] = XLC_IDENTIFIER;
+      for(int c = 'A'; c <= 'Z'; ++c)
+         classes[c] = classes[c - 'A' + 'a'] = XLC_IDENTIFIER;
+   }
+
+   uint8_t operator[](char c) const
+   {
+      return classes[static_cast<unsigned char>(c)];
+   }
+};
+
+static constexpr XLCharTable xl_charTable;
+
 //
 // Tokenizer constructor
 //
 XLTokenizer::XLTokenizer(const Lump &lump) :
-mInput(reinterpret_cast<const char *>(lump.Data().data()), lump.Data().size())
+XLTokenizer(std::string_view(reinterpret_cast<const char *>(lump.Data()),
+                             lump.Size()))
 {
-   mToken.reserve(32);
 }
 
-// State table for the tokenizer - static array of method pointers :)
-void (XLTokenizer::* XLTokenizer::States[])() =
+//
+// Tokenizer over any text. A null character ends the input.
+//
+XLTokenizer::XLTokenizer(std::string_view input) : mInput(input)
 {
-   &XLTokenizer::DoStateScan,
-   &XLTokenizer::DoStateInToken,
-   &XLTokenizer::DoStateInBrackets,
-   &XLTokenizer::DoStateQuoted,
-   &XLTokenizer::DoStateComment
-};
+   const void *nul = mInput.empty() ? nullptr :
+   memchr(mInput.data(), '\0', mInput.size());
+   if(nul)
+      mInput = mInput.substr(0, static_cast<const char *>(nul) - mInput.data());
+}
 
 //
 // Call this to retrieve the next token from the input string. The token
 // type is returned for convenience. Get the text of the token using the
-// GetToken() method.
+// Token() method; it stays valid until the next call.
 //
 enum XLTokenizer::TokenType XLTokenizer::GetNextToken()
 {
-   mToken.clear();
-   mState = STATE_SCAN; // always start out scanning for a new token
-   mTokenType = TOKEN_NONE;   // nothing has been determined yet
+   mToken = std::string_view();
+   const char *data = mInput.data();
+   const size_t size = mInput.size();
 
-   // already at end of input?
-   if(mInput[mIndex])
+   while(mIndex < size)
    {
-      while(mState != STATE_DONE)
+      uint8_t cls = xl_charTable[data[mIndex]];
+      if(cls & XLC_SPACE)
+      {
+         ++mIndex;
+         continue;
+      }
+      if(cls & XLC_NEWLINE)
+      {
+         ++mIndex;
+         // if linebreak tokens are enabled, return one now
+         if(mFlags & TF_LINEBREAKS)
+            return mTokenType = TOKEN_LINEBREAK;
+         continue;
+      }
+      if(AtComment())
+      {
+         // eat the rest of the line, leaving the line break to be scanned
+         const void *eol = memchr(data + mIndex, '\n', size - mIndex);
+         if(!eol)
+            break;
+         mIndex = static_cast<const char *>(eol) - data;
+         continue;
+      }
+      if(cls & XLC_QUOTE)
+      {
+         ++mIndex;
+         ReadQuoted();
+         return mTokenType = TOKEN_STRING;
+      }
+      if(cls & XLC_BRACKET && mFlags & TF_BRACKETS)
       {
-         (this->*States[mState])();
          ++mIndex;
+         ReadBrackets();
+         return mTokenType = TOKEN_BRACKETSTR;
       }
+      // anything else is the start of a new token. Detect $ keywords.
+      mTokenType = data[mIndex] == '$' ? TOKEN_KEYWORD : TOKEN_STRING;
+      ReadToken();
+      return mTokenType;
    }
-   else
-      mTokenType = TOKEN_EOF;
 
-   return mTokenType;
+   mIndex = size;
+   return mTokenType = TOKEN_EOF;
 }
 
 //
-// Tokenizer States
+// Checks whether a comment starts at the current position
 //
+bool XLTokenizer::AtComment() const
+{
+   uint8_t cls = xl_charTable[mInput[mIndex]];
+   if(cls & XLC_SEMICOLON)
+      return true;
+   if(cls & XLC_HASH)
+      return (mFlags & TF_HASHCOMMENTS) != 0;
+   if(cls & XLC_SLASH)
+   {
+      return mFlags & TF_SLASHCOMMENTS && mIndex + 1 < mInput.size() &&
+      mInput[mIndex + 1] == '/';
+   }
+   return false;
+}
 
-// Looking for the start of a new token
-void XLTokenizer::DoStateScan()
+//
+// Reads a plain token, stopping before whitespace, line breaks, comments or,
+// with TF_OPERATORS, a switch between identifier and operator characters.
+//
+void XLTokenizer::ReadToken()
 {
-   char c = mInput[mIndex];
+   uint8_t stop = XLC_SPACE | XLC_NEWLINE | XLC_SEMICOLON;
+   if(mFlags & TF_HASHCOMMENTS)
+      stop |= XLC_HASH;
+   if(mFlags & TF_SLASHCOMMENTS)
+      stop |= XLC_SLASH;
+   const bool operators = (mFlags & TF_OPERATORS) != 0;
 
-   switch(c)
+   const size_t start = mIndex;
+   const uint8_t identifier = xl_charTable[mInput[start]] & XLC_IDENTIFIER;
+   for(++mIndex; mIndex < mInput.size(); ++mIndex)
    {
-      case ' ':
-      case '\t':
-      case '\r':
-         // remain in this state
+      uint8_t cls = xl_charTable[mInput[mIndex]];
+      if(cls & stop && (!(cls & XLC_SLASH) || AtComment()))
          break;
-      case '\n':
-         // if linebreak tokens are enabled, return one now
-         if(mFlags & TF_LINEBREAKS)
-         {
-            mTokenType = TOKEN_LINEBREAK;
-            mState = STATE_DONE;
-         }
-         // otherwise, remain in STATE_SCAN
-         break;
-      case '\0': // end of input
-         mTokenType = TOKEN_EOF;
-         mState = STATE_DONE;
-         break;
-      case ';': // start of a comment
-         mState = STATE_COMMENT;
-         break;
-      case '"': // start of quoted string
-         mTokenType = TOKEN_STRING;
-         mState = STATE_QUOTED;
-         break;
-      default:
-         // anything else is the start of a new token
-         if(c == '#' && (mFlags & TF_HASHCOMMENTS)) // possible start of hash comment
-         {
-            mState = STATE_COMMENT;
-            break;
-         }
-         else if(c == '/' && mInput[mIndex + 1] == '/' &&
-                 (mFlags & TF_SLASHCOMMENTS))
-         {
-            mState = STATE_COMMENT;
-            break;
-         }
-         else if(c == '[' && (mFlags & TF_BRACKETS))
-         {
-            mTokenType = TOKEN_BRACKETSTR;
-            mState = STATE_INBRACKETS;
-            break;
-         }
-         else if(c == '$') // detect $ keywords
-            mTokenType = TOKEN_KEYWORD;
-         else
-            mTokenType = TOKEN_STRING;
-         mState = STATE_INTOKEN;
-         mToken += c;
+      if(operators && (cls & XLC_IDENTIFIER) != identifier)
          break;
    }
+   mToken = mInput.substr(start, mIndex - start);
 }
 
 //
-// True if it's alphanumeric or _
+// Reads out a bracketed string token, past the opening bracket
 //
-inline static bool XL_isIdentifierChar(char c)
+void XLTokenizer::ReadBrackets()
 {
-   return isalnum(c) || c == '_';
-}
-
-// Scanning inside a token
-void XLTokenizer::DoStateInToken()
-{
-   char c = mInput[mIndex];
-
-   switch(c)
+   size_t end = mInput.find(']', mIndex);
+   if(end == std::string_view::npos)   // technically malformed
    {
-      case '\n':
-         if(mFlags & TF_LINEBREAKS) // if linebreaks are tokens, we need to back up
-            --mIndex;
-         // fall through
-      case ' ':  // whitespace
-      case '\t':
-      case '\r':
-         // end of token
-         mState = STATE_DONE;
-         break;
-      case '\0':  // end of input -OR- start of a comment
-      case ';':
-         --mIndex;   // backup, next call will handle it in STATE_SCAN.
-         mState = STATE_DONE;
-         break;
-      default:
-         if(c == '#' && (mFlags & TF_HASHCOMMENTS))
-         {
-            // hashes may conditionally be supported as comments
-            --mIndex;
-            mState = STATE_DONE;
-            break;
-         }
-         else if(c == '/' && mInput[mIndex + 1] == '/' &&
-                 (mFlags & TF_SLASHCOMMENTS))
-         {
-            // double slashes may conditionally be supported as comments
-            --mIndex;
-            mState = STATE_DONE;
-            break;
-         }
-         else if(mFlags & TF_OPERATORS && !mToken.empty() &&
-                 XL_isIdentifierChar(c) != XL_isIdentifierChar(mToken[0]))
-         {
-            // operators and identifiers are separate
-            --mIndex;
-            mState = STATE_DONE;
-            break;
-         }
-         mToken += c;
-         break;
+      mToken = mInput.substr(mIndex);
+      mIndex = mInput.size();
+      return;
    }
+   mToken = mInput.substr(mIndex, end - mIndex);
+   mIndex = end + 1;
 }
 
-// Reading out a bracketed string token
-void XLTokenizer::DoStateInBrackets()
+//
+// Reads out a quoted string token, past the opening quote. Stays a view unless
+// it has escape sequences to decode.
+//
+void XLTokenizer::ReadQuoted()
 {
-   switch(mInput[mIndex])
+   const size_t start = mIndex;
+   size_t end = mInput.find_first_of(mFlags & TF_ESCAPESTRINGS ? "\"\\" : "\"",
+                                      mIndex);
+   if(end == std::string_view::npos)   // technically malformed
    {
-      case ']':  // end of bracketed token
-         mState = STATE_DONE;
-         break;
-      case '\0': // end of input (technically, malformed)
-         --mIndex;
-         mState = STATE_DONE;
-         break;
-      default:   // anything else is part of the token
-         mToken += mInput[mIndex];
-         break;
+      mToken = mInput.substr(start);
+      mIndex = mInput.size();
+      return;
    }
+   if(mInput[end] == '\\')
+   {
+      mIndex = end;
+      ReadEscapedQuoted(start);
+      return;
+   }
+   mToken = mInput.substr(start, end - start);
+   mIndex = end + 1;
 }
 
-// Reading out a quoted string token
-void XLTokenizer::DoStateQuoted()
+//
+// Value of a digit in the given base, or -1 if not one
+//
+inline static int XL_digitValue(char c, int base)
 {
-   char c;
-   int i;
+   int value;
+   if(c >= '0' && c <= '9')
+      value = c - '0';
+   else if(c >= 'a' && c <= 'f')
+      value = 10 + c - 'a';
+   else if(c >= 'A' && c <= 'F')
+      value = 10 + c - 'A';
+   else
+      return -1;
+   return value < base ? value : -1;
+}
 
-   switch(mInput[mIndex])
+//
+// Decodes the rest of a quoted string with escapes into the token buffer. The
+// current position is at the first backslash.
+//
+void XLTokenizer::ReadEscapedQuoted(size_t start)
+{
+   mBuffer.assign(mInput.data() + start, mIndex - start);
+   const size_t size = mInput.size();
+   while(mIndex < size)
    {
-      case '"':  // end of quoted string
-         mState = STATE_DONE;
+      char c = mInput[mIndex++];
+      if(c == '"')   // end of quoted string
          break;
-      case '\0': // end of input (technically, this is malformed)
-         --mIndex;
-         mState = STATE_DONE;
+      if(c != '\\')
+      {
+         mBuffer += c;
+         continue;
+      }
+      if(mIndex == size)
          break;
-      case '\\':
-         if(!(mFlags & TF_ESCAPESTRINGS))
-         {
-            mToken += mInput[mIndex];
-            break;
-         }
-         // Increase IDX, check against '\0' for guarding.
-         if(mInput[++mIndex] == '\0')
-         {
-            --mIndex;
-            mState = STATE_DONE;
-            break;
-         }
-         switch(mInput[mIndex])   // these correspond to the C escape sequences
+      c = mInput[mIndex++];
+      int value, digit, i;
+      switch(c)   // these correspond to the C escape sequences
       {
          case 'a':
-            mToken += '\a';
+            mBuffer += '\a';
             break;
          case 'b':
-            mToken += '\b';
+            mBuffer += '\b';
             break;
          case 'f':
-            mToken += '\f';
+            mBuffer += '\f';
             break;
          case 'n':
-            mToken += '\n';
+            mBuffer += '\n';
             break;
          case 't':
-            mToken += '\t';
+            mBuffer += '\t';
             break;
          case 'r':
-            mToken += '\r';
+            mBuffer += '\r';
             break;
          case 'v':
-            mToken += '\v';
+            mBuffer += '\v';
             break;
          case '?':
-            mToken += '\?';
+            mBuffer += '\?';
             break;
          case '\n':  // for escaping newlines
             break;
          case 'x':
          case 'X':
-            c = 0;
-            for(i = 0; i < 2; ++i)
+            value = 0;
+            for(i = 0; i < 2 && mIndex < size; ++i, ++mIndex)
             {
-               mIndex++;
-               if(mInput[mIndex] >= '0' && mInput[mIndex] <= '9')
-                  c = (c << 4) + mInput[mIndex] - '0';
-               else if(mInput[mIndex] >= 'a' && mInput[mIndex] <= 'f')
-                  c = (c << 4) + 10 + mInput[mIndex] - 'a';
-               else if(mInput[mIndex] >= 'A' && mInput[mIndex] <= 'F')
-                  c = (c << 4) + 10 + mInput[mIndex] - 'A';
-               else
-               {
-                  mIndex--;
+               if((digit = XL_digitValue(mInput[mIndex], 16)) < 0)
                   break;
-               }
+               value = (value << 4) + digit;
             }
-            mToken += c;
+            mBuffer += static_cast<char>(value);
             break;
          case '0':
          case '1':
@@ -297,51 +324,21 @@ void XLTokenizer::DoStateQuoted()
          case '5':
          case '6':
          case '7':
-            c = mInput[mIndex] - '0';
-            for(i = 0; i < 2; ++i)
+            value = c - '0';
+            for(i = 0; i < 2 && mIndex < size; ++i, ++mIndex)
             {
-               mIndex++;
-               if(mInput[mIndex] >= '0' && mInput[mIndex] <= '7')
-                  c = (c << 3) + mInput[mIndex] - '0';
-               else
-               {
-                  mIndex--;
+               if((digit = XL_digitValue(mInput[mIndex], 8)) < 0)
                   break;
-               }
+               value = (value << 3) + digit;
             }
-            mToken += c;
+            mBuffer += static_cast<char>(value);
             break;
          default:
-            mToken += mInput[mIndex];
+            mBuffer += c;
             break;
       }
-         break;
-      default:
-         mToken += mInput[mIndex];
-         break;
-   }
-}
-
-// Reading out a single-line comment
-void XLTokenizer::DoStateComment()
-{
-   // consume all input to the end of the line
-   if(mInput[mIndex] == '\n')
-   {
-      // if linebreak tokens are enabled, send one now
-      if(mFlags & TF_LINEBREAKS)
-      {
-         mTokenType = TOKEN_LINEBREAK;
-         mState = STATE_DONE;
-      }
-      else
-         mState = STATE_SCAN;
-   }
-   else if(mInput[mIndex] == '\0') // end of input
-   {
-      mTokenType = TOKEN_EOF;
-      mState     = STATE_DONE;
    }
+   mToken = mBuffer;
 }
 
 //
@@ -349,8 +346,13 @@ void XLTokenizer::DoStateComment()
 //
 void XLParser::ParseLump(const Lump &lump)
 {
-   if(lump.Data().empty())
+   if(!lump.Size())
       return;
+   if(lump.Failed())
+   {
+      fprintf(stderr, "Failed reading lump %s\n", lump.Name());
+      return;
+   }
    mCurLump = &lump;
    StartLump();
    XLTokenizer tokenizer(lump);
@@ -373,10 +375,9 @@ void XLParser::ParseAll(const Wad &wad)
    mWad = &wad;
    if(mLumpName.empty())
       return;
-   for(const Lump &lump : wad.Lumps())
-   {
-      if(strcasecmp(lump.Name(), mLumpName.c_str()))
-         continue;
-      ParseLump(lump);
-   }
+   const std::vector<int> *indices = wad.FindLumps(mLumpName.c_str());
+   if(!indices)
+      return;
+   for(int index : *indices)
+      ParseLump(wad.Lumps()[index]);
 }
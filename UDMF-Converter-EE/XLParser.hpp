@@ -26,27 +26,18 @@
 #define XLParser_hpp
 
 #include <string>
+#include <string_view>
 
 class Lump;
 class Wad;
 
 //
-// Tokenizer. Also from Eternity
+// Tokenizer. Also from Eternity. Runs directly over the lump data; tokens are
+// views into it, except for quoted strings which needed escape decoding.
 //
 class XLTokenizer
 {
 public:
-   // Tokenizer states
-   enum State
-   {
-      STATE_SCAN,       // scanning for a string token
-      STATE_INTOKEN,    // in a string token
-      STATE_INBRACKETS, // in a bracketed token
-      STATE_QUOTED,     // in a quoted string
-      STATE_COMMENT,    // reading out a comment (eat rest of line)
-      STATE_DONE        // finished the current token
-   };
-
    // Token types
    enum TokenType
    {
@@ -72,30 +63,28 @@ public:
    };
 
    explicit XLTokenizer(const Lump &lump);
+   explicit XLTokenizer(std::string_view input);
    TokenType GetNextToken();
 
    // Accessors
    TokenType TokenType() const { return mTokenType; }
-   const char *Token() const { return mToken.c_str(); }
+   std::string_view Token() const { return mToken; }
 
    void SetTokenFlags(unsigned pFlags) { mFlags = pFlags; }
 
 private:
-   State mState = STATE_SCAN;  // state of the scanner
-   std::string mInput;
-   int mIndex = 0; // input string index
+   std::string_view mInput;   // the text, up to the first null character
+   size_t mIndex = 0; // input string index
    enum TokenType mTokenType = TOKEN_NONE;   // type of current token
-   std::string mToken;
+   std::string_view mToken;   // the current token text
+   std::string mBuffer;       // storage for tokens which can't be views
    unsigned mFlags = TF_DEFAULT;
 
-   void DoStateScan();
-   void DoStateInToken();
-   void DoStateInBrackets();
-   void DoStateQuoted();
-   void DoStateComment();
-
-   // State table declaration
-   static void (XLTokenizer::*States[])();
+   bool AtComment() const;
+   void ReadToken();
+   void ReadBrackets();
+   void ReadQuoted();
+   void ReadEscapedQuoted(size_t start);
 };
 
 //
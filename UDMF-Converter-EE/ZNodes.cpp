@@ -22,14 +22,28 @@
 // Authors: Ioan Chera
 //
 
+#include "DeflateStream.hpp"
 #include "DoomLevel.hpp"
 #include "IOHelpers.hpp"
+#include "NodeBuilder.hpp"
 #include "ZNodes.hpp"
 
-void WriteZNodes(const DoomLevel &level, std::ostream &os)
+//
+// Moves the subsector flag of a vanilla node child to where XGL3 has it. The
+// children are read signed, so the flag comes with the higher bits set too.
+//
+static uint32_t ZNodes_vanillaChild(int child)
 {
-   os << "XGL3";
+   child &= 0xffff;
+   return child & 0x8000 ? NF_SUBSECTOR | (child & 0x7fff) : child;
+}
 
+//
+// Writes the level's own nodes, as GL nodes with no minisegs. Each seg needs a
+// virtual seg after it, to set its end vertex.
+//
+static void ZNodes_writeData(const DoomLevel &level, std::ostream &os)
+{
    WriteInt(level.GetVertices().size(), os);
    WriteInt(level.GetNodeVertices().size(), os);
 
@@ -70,6 +84,48 @@ void WriteZNodes(const DoomLevel &level, std::ostream &os)
       WriteInt(node.party << 16, os);
       WriteInt(node.dx << 16, os);
       WriteInt(node.dy << 16, os);
+      for(int i = 0; i < 4; ++i)
+         WriteShort(node.rightbox[i], os);
+      for(int i = 0; i < 4; ++i)
+         WriteShort(node.leftbox[i], os);
+      WriteInt(ZNodes_vanillaChild(node.rightchild), os);
+      WriteInt(ZNodes_vanillaChild(node.leftchild), os);
+   }
+}
+
+//
+// Writes built GL nodes
+//
+static void ZNodes_writeData(const GLNodes &nodes, std::ostream &os)
+{
+   WriteInt(nodes.numOriginalVertices, os);
+   WriteInt(nodes.newVertices.size(), os);
+   for(const Vertex &vertex : nodes.newVertices)
+   {
+      WriteInt(vertex.x, os);
+      WriteInt(vertex.y, os);
+   }
+
+   WriteInt(nodes.subsectors.size(), os);
+   for(const Subsector &ss : nodes.subsectors)
+      WriteInt(ss.segcount, os);
+
+   WriteInt(nodes.segs.size(), os);
+   for(const GLSeg &seg : nodes.segs)
+   {
+      WriteInt(seg.v1, os);
+      WriteInt(seg.partner, os);
+      WriteInt(seg.linedef, os);
+      os.put(static_cast<char>(seg.side));
+   }
+
+   WriteInt(nodes.nodes.size(), os);
+   for(const Node &node : nodes.nodes)
+   {
+      WriteInt(node.partx, os);
+      WriteInt(node.party, os);
+      WriteInt(node.dx, os);
+      WriteInt(node.dy, os);
       for(int i = 0; i < 4; ++i)
          WriteShort(node.rightbox[i], os);
       for(int i = 0; i < 4; ++i)
@@ -78,3 +134,33 @@ void WriteZNodes(const DoomLevel &level, std::ostream &os)
       WriteInt(node.leftchild, os);
    }
 }
+
+//
+// Writes the signature and the node data, deflating the data as it's made if
+// a compression level is given
+//
+template <typename T>
+static void ZNodes_write(const T &source, std::ostream &os, int compression)
+{
+   if(compression == ZNodesUncompressed)
+   {
+      os << "XGL3";
+      ZNodes_writeData(source, os);
+      return;
+   }
+   os << "ZGL3";
+   DeflateStream stream(os, compression);
+   ZNodes_writeData(source, stream);
+   if(!stream.Finish())
+      os.setstate(std::ios::failbit);
+}
+
+void WriteZNodes(const DoomLevel &level, std::ostream &os, int compression)
+{
+   ZNodes_write(level, os, compression);
+}
+
+void WriteZNodes(const GLNodes &nodes, std::ostream &os, int compression)
+{
+   ZNodes_write(nodes, os, compression);
+}
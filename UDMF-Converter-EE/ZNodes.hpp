@@ -28,7 +28,20 @@
 #include <ostream>
 
 class DoomLevel;
+struct GLNodes;
 
-void WriteZNodes(const DoomLevel &level, std::ostream &os);
+enum
+{
+   ZNodesUncompressed = -1,   // compression for plain XGL3, else a zlib level
+};
+
+//
+// Writes the nodes as XGL3, or as zlib-compressed ZGL3 if given a compression
+// level from 0 to 9
+//
+void WriteZNodes(const DoomLevel &level, std::ostream &os,
+                 int compression = ZNodesUncompressed);
+void WriteZNodes(const GLNodes &nodes, std::ostream &os,
+                 int compression = ZNodesUncompressed);
 
 #endif /* ZNodes_hpp */
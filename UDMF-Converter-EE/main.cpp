@@ -22,17 +22,50 @@
 // Authors: Ioan Chera
 //
 
-#include <sstream>
+#include <deque>
+#include <future>
+#include <memory>
+#include <unordered_set>
 #include "Arguments.hpp"
 #include "DoomLevel.hpp"
 #include "ExtraData.hpp"
 #include "Helpers.hpp"
-#include "LineSpecialMapping.hpp"
+#include "LevelConverter.hpp"
+#include "Stats.hpp"
 #include "ThingMapping.hpp"
-#include "UDMFItems.hpp"
+#include "ThreadPool.hpp"
 #include "Wad.hpp"
+#include "WadWriter.hpp"
 #include "XLEMapInfoParser.hpp"
-#include "ZNodes.hpp"
+
+//
+// Prints the messages of a converted level and adds it to the output. Its
+// warnings get headed by its name, since they're printed apart from progress.
+// Returns false, having said why, if it couldn't be written.
+//
+static bool WriteLevel(WadWriter &outWad, const char *outPath, const char *name,
+                       const ConvertedLevel &level, RunStats *stats)
+{
+   fputs(level.messages.progress.c_str(), stdout);
+   if(!level.messages.warnings.empty())
+   {
+      fprintf(stderr, "Warnings for %s:\n", name);
+      fputs(level.messages.warnings.c_str(), stderr);
+   }
+   StageTimer timer(stats, Stage::wadWrite);
+   for(const Lump &lump : level.lumps)
+   {
+      Result result = outWad.AddLump(lump);
+      if(result != Result::OK)
+      {
+         fprintf(stderr, "Failed writing lump %s of %s to file '%s'. %s\n", lump.Name(),
+                 name, outPath, ResultMessage(result));
+         return false;
+      }
+      timer.Count(lump.Size(), 1);
+   }
+   return true;
+}
 
 //
 // Entry point
@@ -54,16 +87,40 @@ int main(int argc, const char * argv[])
       return EXIT_FAILURE;
    }
 
+   // -stats prints timings and counters, -statsjson writes them as JSON
+   std::unique_ptr<StatsReport> stats;
+   const char *statsJSONPath = args.GetSingle("statsjson");
+   if(args.Get("stats") || statsJSONPath)
+      stats.reset(new StatsReport);
+   RunStats *globalStats = stats ? &stats->Global() : nullptr;
+
    Wad wad;
    Result result;
-   for(const char *path : *paths)
    {
-      result = wad.AddFile(path);
-      if(result != Result::OK)
+      StageTimer timer(globalStats, Stage::wadLoad);
+      for(const char *path : *paths)
       {
-         fprintf(stderr, "Failed loading file '%s'. %s\n", path, ResultMessage(result));
-         return EXIT_FAILURE;
+         result = wad.AddFile(path);
+         if(result != Result::OK)
+         {
+            fprintf(stderr, "Failed loading file '%s'. %s\n", path, ResultMessage(result));
+            return EXIT_FAILURE;
+         }
       }
+      uint64_t bytes = 0;
+      for(const Lump &lump : wad.Lumps())
+         bytes += lump.Size();
+      timer.Count(bytes, wad.Lumps().size());
+   }
+
+   // Number of levels to convert at once. 0 means one per hardware thread.
+   int jobs = 1;
+   const char *jobsArg = args.GetSingle("jobs");
+   if(jobsArg)
+   {
+      jobs = atoi(jobsArg);
+      if(jobs <= 0)
+         jobs = ThreadPool::HardwareThreads();
    }
 
    const std::vector<const char *> *thinglists = args.Get("things");
@@ -72,76 +129,168 @@ int main(int argc, const char * argv[])
       for (const char *list : *thinglists)
          thingnames.AddFromFile(list);
 
-   // Initialize line mapping
-   InitLineMapping();
-   InitExtraDataMappings();
+   std::vector<LumpInfo> levelLumps;
+   {
+      StageTimer timer(globalStats, Stage::findLevels);
+      levelLumps = DoomLevel::FindLevelLumps(wad);
+      timer.Count(0, levelLumps.size());
+   }
 
    // Look for EMAPINFO.
    XLEMapInfoParser emapinfo;
-   emapinfo.ParseAll(wad);
+   {
+      StageTimer timer(globalStats, Stage::emapinfo);
+      emapinfo.ParseAll(wad);
+      const std::vector<int> *emapinfoLumps = wad.FindLumps("EMAPINFO");
+      if(emapinfoLumps)
+         for(int index : *emapinfoLumps)
+            timer.Count(wad.Lumps()[index].Size(), 1);
 
-   // Also look in individual levels
-   std::vector<LumpInfo> levelLumps = DoomLevel::FindLevelLumps(wad);
-   for(const LumpInfo &info : levelLumps)
+      // Also look in individual levels
+      for(const LumpInfo &info : levelLumps)
+      {
+         emapinfo.SetLocalLevel(info.lump->Name());
+         emapinfo.ParseLump(*info.lump);
+         timer.Count(info.lump->Size(), 1);
+      }
+   }
+
+   // Convert the maps, writing each one as soon as it's ready
+   WadWriter outWad;
+   result = outWad.Open(outPath);
+   if(result != Result::OK)
    {
-      emapinfo.SetLocalLevel(info.lump->Name());
-      emapinfo.ParseLump(*info.lump);
+      fprintf(stderr, "Failed writing file '%s'. %s\n", outPath, ResultMessage(result));
+      return EXIT_FAILURE;
    }
+   // Levels sharing an ExtraData lump only parse it once
+   ExtraDataCache extraDataCache(wad, thingnames);
 
-   // Convert the maps
-   Wad outWad;
+   // -buildnodes replaces the levels' nodes with built GL nodes, -buildblockmap
+   // their blockmaps. -compressblockmap also builds them, sharing block lists.
+   // -buildreject replaces REJECT with one built from line of sight. -zgl3
+   // writes compressed nodes. -zlevel does too, at the given zlib level.
+   ConvertOptions options;
+   options.buildNodes = !!args.Get("buildnodes");
+   options.buildBlockmap = !!args.Get("buildblockmap");
+   options.compressBlockmap = !!args.Get("compressblockmap");
+   options.buildReject = !!args.Get("buildreject");
+   const char *zlevelArg = args.GetSingle("zlevel");
+   if(zlevelArg)
+   {
+      char *end;
+      long zlevel = strtol(zlevelArg, &end, 10);
+      if(*end || end == zlevelArg || zlevel < 0 || zlevel > 9)
+      {
+         fprintf(stderr, "Invalid -zlevel '%s'. It must be from 0 to 9.\n", zlevelArg);
+         return EXIT_FAILURE;
+      }
+      options.nodeCompression = static_cast<int>(zlevel);
+   }
+   else if(args.Get("zgl3"))
+      options.nodeCompression = 6;  // zlib's usual tradeoff
+   // Made after everything its tasks use, so that leaving early waits for
+   // them while it's all still around
+   std::unique_ptr<ThreadPool> pool;
+   if(jobs > 1)
+      pool.reset(new ThreadPool(jobs));
+   options.pool = pool.get();
+
+   // Levels being converted on the pool, oldest first. Only a few are let
+   // ahead of the one to be written next, so finished ones don't pile up in
+   // memory while waiting for it.
+   struct PendingLevel
+   {
+      const char *name;
+      std::future<ConvertedLevel> result;
+      RunStats *stats;
+   };
+   std::deque<PendingLevel> pending;
+   const size_t maxPending = pool ? 2 * pool->NumThreads() : 0;
+   // ExtraData lumps already used, by index. Messages from parsing one are
+   // reported with the first level using it, whichever thread parses it.
+   std::unordered_set<int> usedExtraData;
    for(const LumpInfo &info : levelLumps)
    {
       const char *name = info.lump->Name();
+      RunStats *levelStats = stats ? &stats->AddMap(name) : nullptr;
       const LevelInfo *levelInfo = emapinfo.Get(name);
-      ExtraData extraData(thingnames);
+      std::string extraDataName;
       if(levelInfo)
       {
          auto it = levelInfo->find("extradata");
          if(it != levelInfo->end())
          {
-            if(!extraData.LoadLump(wad, it->second.c_str()))
-            {
-               fprintf(stderr, "Warning: failed loading ExtraData %s for %s\n", it->second.c_str(),
-                       name);
-            }
+            extraDataName = it->second;
             // Delete the ExtraData reference: it will be undesired in UDMF
             emapinfo.Erase(name, "extradata");
          }
       }
+      int extraDataIndex = -1;
+      bool reportExtraDataLoad = !extraDataName.empty() &&
+      wad.FindLump(extraDataName.c_str(), &extraDataIndex) &&
+      usedExtraData.insert(extraDataIndex).second;
 
-      DoomLevel level;
-      if(!level.LoadWad(wad, info.index))
+      if(!pool)
       {
-         fprintf(stderr, "Failed loading level %s\n", name);
+         if(!WriteLevel(outWad, outPath, name,
+                        ConvertLevel(wad, info, thingnames, extraDataCache,
+                                     extraDataName, reportExtraDataLoad, options,
+                                     levelStats), levelStats))
+         {
+            return EXIT_FAILURE;
+         }
          continue;
       }
-      printf("Loaded level %s\n", name);
-
-      // Now we have both the level and its ExtraData loaded. Let's see how we convert it now
-      UDMFLevel udmfLevel(level, extraData);
-
-      // Create a wad with the new level lumps
-      outWad.AddLump(Lump(name));   // marker
-      std::ostringstream oss;
-      oss << udmfLevel;
-      outWad.AddLump(Lump("TEXTMAP", oss.str()));
-      oss.clear();
-      oss.seekp(0);
-      WriteZNodes(level, oss);
-      outWad.AddLump(Lump("ZNODES", oss.str()));
-      // Also add reject and blockmap
-      outWad.AddLump(Lump("REJECT", level.GetReject()));
-      outWad.AddLump(Lump("BLOCKMAP", level.GetBlockmap()));
-      outWad.AddLump(Lump("ENDMAP"));
+      // Levels may finish in any order, but they get written in the original
+      // one, so the output is the same as when converting serially.
+      auto task = std::make_shared<std::packaged_task<ConvertedLevel()>>(
+         [&wad, info, &thingnames, &extraDataCache, extraDataName,
+          reportExtraDataLoad, &options, levelStats]() {
+            return ConvertLevel(wad, info, thingnames, extraDataCache, extraDataName,
+                                reportExtraDataLoad, options, levelStats);
+         });
+      if(pending.size() >= maxPending)
+      {
+         PendingLevel &level = pending.front();
+         if(!WriteLevel(outWad, outPath, level.name, level.result.get(), level.stats))
+            return EXIT_FAILURE;
+         pending.pop_front();
+      }
+      pending.push_back({ name, task->get_future(), levelStats });
+      pool->Submit([task]() { (*task)(); });
    }
+   for(PendingLevel &level : pending)
+      if(!WriteLevel(outWad, outPath, level.name, level.result.get(), level.stats))
+         return EXIT_FAILURE;
 
-   result = wad.WriteFile(outPath);
+   {
+      StageTimer timer(globalStats, Stage::wadWrite);
+      result = outWad.Close();
+   }
    if(result != Result::OK)
    {
       fprintf(stderr, "Failed writing file '%s'. %s\n", outPath, ResultMessage(result));
       return EXIT_FAILURE;
    }
 
+   if(stats)
+   {
+      stats->Finish();
+      if(args.Get("stats"))
+         stats->PrintText(stdout);
+      if(statsJSONPath)
+      {
+         FILE *f = fopen(statsJSONPath, "wt");
+         if(!f)
+         {
+            fprintf(stderr, "Failed writing file '%s'\n", statsJSONPath);
+            return EXIT_FAILURE;
+         }
+         stats->PrintJSON(f);
+         fclose(f);
+      }
+   }
+
    return 0;
 }